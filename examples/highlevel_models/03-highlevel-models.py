@@ -0,0 +1,49 @@
+import os
+import sys
+import tempfile
+import time
+
+import stormpy
+
+import stormpy.examples
+import stormpy.examples.files
+
+
+def _measure(name, function, repetitions):
+    start = time.perf_counter()
+    for _ in range(repetitions):
+        result = function()
+    print(f"{name}: {(time.perf_counter() - start) / repetitions:.4f}s")
+    return result
+
+
+def example_jani_io_benchmark(path=None, repetitions=5):
+    """
+    This method compares the default JANI parser and exporter with their streaming counterparts.
+    Without a path, the JANI file is obtained from a PRISM program with many commands.
+    """
+    with tempfile.TemporaryDirectory() as directory:
+        if path is None:
+            prism_program = stormpy.parse_prism_program(os.path.join(stormpy.examples.files.testfile_dir, "mdp", "wlan0-2-2.nm"))
+            jani_model, _ = prism_program.to_jani([])
+            path = os.path.join(directory, "model.jani")
+            with open(path, "w") as file:
+                file.write(str(jani_model))
+        print(f"Benchmarking {path} ({os.path.getsize(path) / 1e6:.2f} MB)")
+
+        jani_model, properties = _measure("parse_jani_model", lambda: stormpy.parse_jani_model(path), repetitions)
+        _measure("parse_jani_model_streaming", lambda: stormpy.parse_jani_model_streaming(path), repetitions)
+
+        export_file = os.path.join(directory, "export.jani")
+
+        def export_default():
+            with open(export_file, "w") as file:
+                file.write(str(jani_model))
+
+        _measure("export via str()", export_default, repetitions)
+        _measure("export_jani_model_streaming", lambda: stormpy.export_jani_model_streaming(jani_model, export_file, properties), repetitions)
+        print(f"Streamed export has {os.path.getsize(export_file) / 1e6:.2f} MB")
+
+
+if __name__ == '__main__':
+    example_jani_io_benchmark(sys.argv[1] if len(sys.argv) > 1 else None)
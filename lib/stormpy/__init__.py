@@ -154,17 +154,30 @@ def build_sparse_parametric_model(symbolic_description, properties=None):
     return _convert_sparse_model(intermediate, parametric=True)
 
 
-def build_symbolic_model(symbolic_description, properties=None):
+def build_symbolic_model(symbolic_description, properties=None, variable_order=None):
     """
     Build a model in symbolic representation from a symbolic description.
 
     :param symbolic_description: Symbolic model description to translate into a model.
     :param List[Property] properties: List of properties that should be preserved during the translation. If None, then all properties are preserved.
+    :param variable_order: Order of the DD variables for PRISM programs. Either a list of variable names, e.g. as obtained by compute_variable_order,
+        or "static" to compute an order from the interactions between variables. If None, the declaration order is used.
     :return: Model in symbolic representation.
     """
     if not symbolic_description.undefined_constants_are_graph_preserving:
         raise StormError("Program still contains undefined constants")
 
+    if variable_order is not None:
+        if isinstance(symbolic_description, SymbolicModelDescription):
+            if not symbolic_description.is_prism_program:
+                raise StormError("Variable orders are only supported for PRISM programs")
+            symbolic_description = symbolic_description.as_prism_program()
+        if not isinstance(symbolic_description, storage.PrismProgram):
+            raise StormError("Variable orders are only supported for PRISM programs")
+        if variable_order == "static":
+            variable_order = core.compute_variable_order(symbolic_description)
+        symbolic_description = core.apply_variable_order(symbolic_description, variable_order)
+
     if properties:
         formulae = [(prop.raw_formula if isinstance(prop, Property) else prop) for prop in properties]
         intermediate = core._build_symbolic_model_from_symbolic_description(symbolic_description, formulae)
@@ -232,6 +245,18 @@ def build_interval_model_from_drn(file, options = DirectEncodingParserOptions())
         raise StormError("Not supported interval model constructed")
 
 
+def load_symbolic_model(file):
+    """
+    Load a model in symbolic representation from a binary file written by export_symbolic_model.
+    The model gets its own DD manager.
+
+    :param String file: File containing the symbolic model.
+    :return: Model in symbolic representation.
+    """
+    intermediate = core._load_symbolic_model(file)
+    return _convert_symbolic_model(intermediate, parametric=False)
+
+
 def perform_bisimulation(model, properties, bisimulation_type):
     """
     Perform bisimulation on model.
@@ -243,14 +268,19 @@ def perform_bisimulation(model, properties, bisimulation_type):
     return perform_sparse_bisimulation(model, properties, bisimulation_type)
 
 
-def perform_sparse_bisimulation(model, properties, bisimulation_type):
+def perform_sparse_bisimulation(model, properties, bisimulation_type, nr_threads=None):
     """
     Perform bisimulation on model in sparse representation.
     :param model: Model.
     :param properties: Properties to preserve during bisimulation.
     :param bisimulation_type: Type of bisimulation (weak or strong).
+    :param nr_threads: If given, use the parallel signature-based refinement with this number of threads (0 for the number of cores).
     :return: Model after bisimulation.
     """
+    if nr_threads is not None:
+        if bisimulation_type != BisimulationType.STRONG:
+            raise StormError("Signature-based bisimulation only supports strong bisimulation")
+        return perform_signature_bisimulation(model, properties, nr_threads).quotient
     formulae = [(prop.raw_formula if isinstance(prop, Property) else prop) for prop in properties]
     if model.supports_parameters:
         return core._perform_parametric_bisimulation(model, formulae, bisimulation_type)
@@ -258,6 +288,26 @@ def perform_sparse_bisimulation(model, properties, bisimulation_type):
         return core._perform_bisimulation(model, formulae, bisimulation_type)
 
 
+def perform_signature_bisimulation(model, properties, nr_threads=0, initial_partition=None):
+    """
+    Perform strong bisimulation on a sparse DTMC, CTMC or MDP by parallel signature-based partition refinement.
+    When minimizing several instances of the same model, e.g. for different values of constants, the partition of a previous
+    instance can be passed as initial partition. The refinement then starts from this partition and typically terminates
+    after one or two rounds. The result is a bisimulation refining the initial partition, which may be finer than the
+    coarsest bisimulation of the new instance.
+    :param model: Model.
+    :param properties: Properties to preserve during bisimulation.
+    :param nr_threads: Number of threads, 0 for the number of cores.
+    :param initial_partition: Block of each state, e.g. state_to_block of a previous result for a structurally identical model.
+    :return: Result containing the quotient, the block of each state and statistics for each refinement round.
+    :rtype: SignatureBisimulationResult
+    """
+    if model.supports_parameters:
+        raise StormError("Signature-based bisimulation does not support parametric models")
+    formulae = [(prop.raw_formula if isinstance(prop, Property) else prop) for prop in properties]
+    return core._perform_signature_bisimulation(model, formulae, nr_threads, initial_partition)
+
+
 def perform_symbolic_bisimulation(model, properties, quotient_format=stormpy.QuotientFormat.DD):
     """
     Perform bisimulation on model in symbolic representation.
@@ -295,6 +345,96 @@ def model_checking(model, property, only_initial_states=False, extract_scheduler
                               environment=environment)
 
 
+def check_on_the_fly(symbolic_description, property, options=None):
+    """
+    Check a qualitative reachability property while exploring the state space of the symbolic description.
+    The exploration stops as soon as the property is decided, without building the full model.
+    Supported are bounds >0, <=0 (existence of a path) and >=1, <1 (almost-sure reachability, only deterministic models)
+    for eventually, until and globally formulas.
+
+    :param symbolic_description: PRISM program or JANI model.
+    :param property: Property or formula to check.
+    :param OnTheFlyOptions options: Options for the exploration, e.g., a bound on the number of states or hash compaction.
+    :return: Result of the on-the-fly check.
+    :rtype: OnTheFlyResult
+    """
+    if not symbolic_description.undefined_constants_are_graph_preserving:
+        raise StormError("Program still contains undefined constants")
+    if options is None:
+        options = OnTheFlyOptions()
+    formula = property.raw_formula if isinstance(property, Property) else property
+    return core._check_on_the_fly(symbolic_description, formula, options)
+
+
+def check_statistically(program, property, options=None):
+    """
+    Estimate the value of a property by sampling paths of a PRISM program, without building the model.
+    Supports (bounded) until, eventually and globally probabilities as well as reachability and cumulative rewards on discrete-time models.
+    Nondeterminism is resolved by the scheduler in the options or uniformly at random.
+
+    :param program: PRISM program.
+    :param property: Property or formula to check.
+    :param StatisticalModelCheckingOptions options: Options such as the stopping rule, the precision and the number of threads.
+    :return: Estimate with confidence interval.
+    :rtype: StatisticalModelCheckingResult
+    """
+    if program.has_undefined_constants:
+        raise StormError("Program still contains undefined constants")
+    if options is None:
+        options = StatisticalModelCheckingOptions()
+    formula = property.raw_formula if isinstance(property, Property) else property
+    return core._check_statistically(program, formula, options)
+
+
+def make_template_model_builder(symbolic_description, properties=None):
+    """
+    Explore a model with graph-preserving undefined constants once, such that it can be instantiated repeatedly without re-exploration.
+
+    :param symbolic_description: Symbolic model description whose undefined constants only influence transition and reward values.
+    :param List[Property] properties: List of properties that should be preserved. If None, then all properties are preserved.
+    :return: Builder whose instantiate method takes a dict from constant names to values.
+    :rtype: TemplateModelBuilder
+    """
+    if not symbolic_description.undefined_constants_are_graph_preserving:
+        raise StormError("Undefined constants are not graph-preserving")
+    if properties:
+        formulae = [(prop.raw_formula if isinstance(prop, Property) else prop) for prop in properties]
+        return core.TemplateModelBuilder(symbolic_description, formulae)
+    return core.TemplateModelBuilder(symbolic_description)
+
+
+def sweep_constants(symbolic_description, properties, constant_valuations, build=True, check=True, flatten=False, keep_models=False, nr_threads=0):
+    """
+    Instantiate a symbolic description for many constant valuations in parallel, and optionally build and check each model.
+    The description is only parsed once; each instance is instantiated, simplified and (optionally) flattened independently.
+    As all instances share the expression manager of the description, instantiating and building are serialized; the model checking runs in parallel.
+
+    :param symbolic_description: Symbolic description (PRISM program or JANI model) with undefined constants.
+    :param properties: Properties to instantiate and check, may be empty.
+    :param constant_valuations: List of constant valuations, each either a definition string such as 'N=16,p=0.5' or a dict from constant names to values.
+    :param build: If True, the sparse model of each instance is built.
+    :param check: If True, the properties are checked on each model.
+    :param flatten: If True, the modules of PRISM programs or the composition of JANI models are flattened.
+    :param keep_models: If True, the built models are part of the result.
+    :param nr_threads: Number of threads, 0 for the number of cores.
+    :return: List of instances with the instantiated descriptions, model sizes and the results for the initial state.
+    :rtype: List[ConstantSweepInstance]
+    """
+    definitions = []
+    for valuation in constant_valuations:
+        if isinstance(valuation, dict):
+            definitions.append(",".join("{}={}".format(name, str(value).lower() if isinstance(value, bool) else value) for name, value in valuation.items()))
+        else:
+            definitions.append(valuation)
+    options = core.ConstantSweepOptions()
+    options.build = build
+    options.check = check
+    options.flatten = flatten
+    options.keep_models = keep_models
+    options.nr_threads = nr_threads
+    return core._sweep_constants(symbolic_description, properties, definitions, options)
+
+
 def check_model_sparse(model, property, only_initial_states=False, extract_scheduler=False, force_fully_observable=False, hint=None, environment=Environment()):
     """
     Perform model checking on model for property.
@@ -361,6 +501,35 @@ def check_model_sparse(model, property, only_initial_states=False, extract_sched
             return core._model_checking_sparse_engine(model, task, environment=environment)
 
 
+def explore_pareto_curve(model, property, precision=1e-4, nr_threads=0, time_limit=None, max_queries=None, environment=Environment()):
+    """
+    Approximate the Pareto curve of a multi-objective property by weighted-sum queries.
+    In each round, the weight vectors with the largest distance between under- and over-approximation are checked in parallel,
+    one per thread. Each thread reuses its weight vector checker across rounds.
+    :param model: Sparse MDP or Markov automaton with a single initial state.
+    :param property: Multi-objective property in which all objectives are of the form '=?'.
+    :param precision: Stop once under- and over-approximation are at most this far apart, measured for weight vectors summing up to 1.
+    :param nr_threads: Number of threads, 0 for the number of cores.
+    :param time_limit: Do not start new rounds after this many seconds.
+    :param max_queries: Maximal number of weight vectors to check.
+    :return: Under- and over-approximation with the achievable points and the checked weight vectors.
+    :rtype: ParetoExplorationResult
+    """
+    formula = property.raw_formula if isinstance(property, Property) else property
+    if not formula.is_multi_objective_formula:
+        raise StormError("Pareto curves can only be explored for multi-objective formulas")
+    if model.supports_parameters or model.is_exact:
+        raise StormError("Pareto curves can only be explored for models with double values")
+    options = core.ParetoExplorationOptions()
+    options.precision = precision
+    options.nr_threads = nr_threads
+    if time_limit is not None:
+        options.time_limit = time_limit
+    if max_queries is not None:
+        options.max_queries = max_queries
+    return core._explore_pareto_curve_double(model, formula, options, environment=environment)
+
+
 def check_model_dd(model, property, only_initial_states=False, environment=Environment()):
     """
     Perform model checking using dd engine.
@@ -582,7 +751,7 @@ def construct_submodel(model, states, actions, keep_unreachable_states=True, opt
     return core._construct_subsystem_Double(model, states, actions, keep_unreachable_states, options)
 
 
-def eliminate_ECs(matrix, subsystem, possible_ecs, add_sink_row_states, add_self_loop_at_sink_states = False):
+def eliminate_ECs(matrix, subsystem, possible_ecs, add_sink_row_states, add_self_loop_at_sink_states = False, nr_threads = 1):
     """
     For each such EC (that is not contained in another EC), we add a new state and redirect all incoming and outgoing
              transitions of the EC to (and from) this state.
@@ -595,13 +764,14 @@ def eliminate_ECs(matrix, subsystem, possible_ecs, add_sink_row_states, add_self
              Furthermore, the rows that contain a transition leading outside of the subsystem are not considered for an EC.
     :param add_sink_row_states: BitVector with states many entries. If add_sink_row_states is true for at least one state of an eliminated EC, a row is added to the new state (representing the choice to stay at the EC forever).
     :param add_self_loop_at_sink_states: if true, such rows get a selfloop (with value 1). Otherwise, the row remains empty.
+    :param nr_threads: Number of threads used to identify the ECs (0 for the number of cores).
     :return: A container with various information.
     """
     assert matrix.nr_columns == subsystem.size(), "subsystem vector should have an entry for every state."
     assert matrix.nr_rows == possible_ecs.size(), "possible_ecs vector should have an entry for every row."
     assert matrix.nr_columns == add_sink_row_states.size(), "add_sink_row_states vector should have an entry for every state."
 
-    return core._eliminate_end_components_double(matrix, subsystem, possible_ecs, add_sink_row_states, add_self_loop_at_sink_states)
+    return core._eliminate_end_components_double(matrix, subsystem, possible_ecs, add_sink_row_states, add_self_loop_at_sink_states, nr_threads)
 
 
 def parse_properties(properties, context=None, filters=None):
@@ -642,3 +812,17 @@ def export_to_drn(model, file, options=DirectEncodingOptions()):
     if model.is_exact:
         return core._export_exact_to_drn(model, file, options)
     return core._export_to_drn(model, file, options)
+
+
+def export_symbolic_model(model, file):
+    """
+    Export a model in symbolic representation to a binary file.
+    The file contains the DDs of the transitions, states, labels and reward models together with the meta variables,
+    so the model can be loaded again with load_symbolic_model without building it from the description.
+
+    :param model: Symbolic DTMC, CTMC or MDP.
+    :param String file: Path of the file.
+    """
+    if model.supports_parameters:
+        raise StormError("Exporting parametric symbolic models is not supported")
+    core._export_symbolic_model(model, file)
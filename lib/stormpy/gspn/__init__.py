@@ -3,5 +3,27 @@ from . import _config
 if not _config.storm_with_gspn:
     raise ImportError("No support for GSPNs was built in Storm.")
 
+import stormpy
 from . import gspn
 from .gspn import *
+from .gspn import _build_sparse_model_from_gspn
+
+
+def build_model(gspn, properties=None, options=None):
+    """
+    Build a model in sparse representation directly from a GSPN, without the translation to JANI.
+    Vanishing markings are eliminated on the fly (yielding a CTMC) unless disabled in the options (possibly yielding a Markov automaton).
+
+    :param gspn: GSPN.
+    :param List[Property] properties: List of properties whose atomic expressions should be available as labels.
+    :param GSPNExplorationOptions options: Options for the exploration.
+    :return: Model in sparse representation.
+    """
+    if options is None:
+        options = GSPNExplorationOptions()
+    if properties:
+        formulae = [(prop.raw_formula if isinstance(prop, stormpy.Property) else prop) for prop in properties]
+        intermediate = _build_sparse_model_from_gspn(gspn, formulae, options)
+    else:
+        intermediate = _build_sparse_model_from_gspn(gspn, options=options)
+    return stormpy._convert_sparse_model(intermediate, parametric=False)
@@ -25,19 +25,42 @@ def make_simple(model, keep_state_valuations=False):
     else:
         return pomdp._make_simple_Double(model, keep_state_valuations)
 
-def unfold_memory(model, memory, add_memory_labels=False, keep_state_valuations=False):
+def unfold_memory(model, memory, add_memory_labels=False, keep_state_valuations=False, direct=False):
     """
     Unfold the memory for an FSC into the POMDP
 
     :param model: A pomdp
     :param memory: A memory structure
+    :param add_memory_labels: Whether a label memstate_i is added for the product states with memory node i.
+    :param keep_state_valuations: Whether the state valuations are kept. Not supported by the direct unfolding, which then falls back to the default unfolding.
+    :param direct: If true, only the reachable product states are built and the product matrix is written in one pass.
     :return: A pomdp that contains states from the product of the original POMDP and the FSC Memory
     """
+    if direct and not keep_state_valuations:
+        if model.supports_parameters:
+            return pomdp._unfold_memory_direct_Rf(model, memory, add_memory_labels)
+        elif model.is_exact:
+            return pomdp._unfold_memory_direct_Exact(model, memory, add_memory_labels)
+        else:
+            return pomdp._unfold_memory_direct_Double(model, memory, add_memory_labels)
     if model.supports_parameters:
         return pomdp._unfold_memory_Rf(model, memory, add_memory_labels, keep_state_valuations)
     else:
         return pomdp._unfold_memory_Double(model, memory, add_memory_labels, keep_state_valuations)
 
+
+def memory_product(model, memory):
+    """
+    Create the product of a POMDP and a memory structure without building it.
+    The product can be unfolded, and the Markov chains induced by finite-state controllers can be built from it directly.
+
+    :param model: A pomdp with double values
+    :param memory: A memory structure
+    :return: The product
+    """
+    assert not model.supports_parameters and not model.is_exact, "Memory products are only supported for double values."
+    return pomdp.PomdpMemoryProductDouble(model, memory)
+
 def apply_unknown_fsc(model, mode):
     if model.supports_parameters:
         return pomdp._apply_unknown_fsc_Rf(model, mode)
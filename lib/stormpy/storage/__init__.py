@@ -60,17 +60,42 @@ def _build_sparse_matrix(builder_class, array, row_group_indices=[]):
     return builder.build()
 
 
-def get_maximal_end_components(model):
+def get_maximal_end_components(model, nr_threads=None):
     """
     Get maximal end components from model.
     :param model: Model.
+    :param nr_threads: If given, the MECs are computed by this number of threads (0 for the number of cores).
     :return: Maximal end components.
     """
     if model.supports_parameters:
-        return stormpy.jMaximalEndComponentDecomposition_ratfunc(model)
+        suffix = "ratfunc"
     elif model.is_exact:
-        return stormpy.MaximalEndComponentDecomposition_exact(model)
+        suffix = "exact"
     elif model.supports_uncertainty:
-        return stormpy.MaximalEndComponentDecomposition_interval(model)
+        suffix = "interval"
     else:
-        return stormpy.MaximalEndComponentDecomposition_double(model)
+        suffix = "double"
+    if nr_threads is None:
+        return getattr(stormpy, "MaximalEndComponentDecomposition_" + suffix)(model)
+    return getattr(stormpy, "ParallelMaximalEndComponentDecomposition_" + suffix)(model, nr_threads)
+
+
+def get_strongly_connected_components(model, subsystem=None, only_bottom_sccs=False, drop_naive_sccs=False, topological_sort=False):
+    """
+    Get strongly connected components from model.
+    :param model: Model.
+    :param subsystem: If given, only SCCs of the states in this BitVector are computed.
+    :param only_bottom_sccs: If true, only bottom SCCs are computed.
+    :param drop_naive_sccs: If true, SCCs consisting of a single state without self-loop are dropped.
+    :param topological_sort: If true, the SCCs are sorted such that transitions only lead to the same SCC or to SCCs with a smaller index.
+    :return: Strongly connected components.
+    """
+    if model.supports_parameters:
+        decomposition = stormpy.StronglyConnectedComponentDecomposition_ratfunc
+    elif model.is_exact:
+        decomposition = stormpy.StronglyConnectedComponentDecomposition_exact
+    elif model.supports_uncertainty:
+        decomposition = stormpy.StronglyConnectedComponentDecomposition_interval
+    else:
+        decomposition = stormpy.StronglyConnectedComponentDecomposition_double
+    return decomposition(model, subsystem, only_bottom_sccs, drop_naive_sccs, topological_sort)
@@ -0,0 +1,115 @@
+#include "action_mask.h"
+#include "expression_compiler.h"
+
+#include "storm/generator/NextStateGenerator.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+
+#include <map>
+#include <mutex>
+#include <set>
+
+/*!
+ * Access to the state currently loaded into a next-state generator, which Storm does not expose publicly.
+ */
+struct LoadedStateAccess : storm::generator::NextStateGenerator<double, uint32_t> {
+    static storm::generator::CompressedState const& get(storm::generator::NextStateGenerator<double, uint32_t> const& generator) {
+        return *(generator.*(&LoadedStateAccess::state));
+    }
+};
+
+/*!
+ * Action mask given by a guard expression per action index.
+ * The guards are compiled once and evaluated in C++ directly on the compressed state of the generator, so the mask is thread-safe,
+ * does not require the GIL and does not allocate a valuation per query.
+ * The state layout is taken from the first generator querying the mask, hence a mask can only be used for one program.
+ */
+class ExpressionActionMask : public storm::generator::ActionMask<double> {
+   public:
+    ExpressionActionMask(std::map<uint64_t, storm::expressions::Expression> const& guards, bool allowUnspecified) : allowUnspecified(allowUnspecified) {
+        for (auto const& entry : guards) {
+            auto variables = entry.second.getVariables();
+            this->guards.emplace(entry.first, CompiledExpression(entry.second, std::vector<storm::expressions::Variable>(variables.begin(), variables.end())));
+        }
+    }
+
+    bool query(storm::generator::NextStateGenerator<double, uint32_t> const& generator, uint64_t actionIndex) override {
+        auto guard = guards.find(actionIndex);
+        if (guard == guards.end()) {
+            return allowUnspecified;
+        }
+        auto const& variableInformation = generator.getVariableInformation();
+        std::call_once(layoutFlag, [&]() {
+            for (auto& entry : guards) {
+                entry.second.setLayout(variableInformation);
+            }
+            layoutBits = variableInformation.getTotalBitOffset(true);
+        });
+        STORM_LOG_THROW(variableInformation.getTotalBitOffset(true) == layoutBits, storm::exceptions::InvalidArgumentException,
+                        "The action mask was used for generators with different state layouts.");
+        return guard->second.evaluate(LoadedStateAccess::get(generator)) != 0;
+    }
+
+   private:
+    std::map<uint64_t, CompiledExpression> guards;
+    bool allowUnspecified;
+    std::once_flag layoutFlag;
+    uint64_t layoutBits = 0;
+};
+
+/*!
+ * Action mask given by a table from the values of some Boolean and integer variables to the allowed action indices.
+ */
+class ValuationTableActionMask : public storm::generator::ActionMask<double> {
+   public:
+    ValuationTableActionMask(std::vector<storm::expressions::Variable> const& variables, std::map<std::vector<int64_t>, std::set<uint64_t>> const& table, bool allowUnspecified)
+        : variables(variables), table(table), allowUnspecified(allowUnspecified) {
+        for (auto const& variable : variables) {
+            STORM_LOG_THROW(variable.hasBooleanType() || variable.hasIntegerType(), storm::exceptions::InvalidArgumentException, "Variable '" << variable.getName() << "' must be Boolean or integer.");
+        }
+        for (auto const& entry : table) {
+            STORM_LOG_THROW(entry.first.size() == variables.size(), storm::exceptions::InvalidArgumentException, "Each key must contain one value per variable.");
+        }
+    }
+
+    bool query(storm::generator::NextStateGenerator<double, uint32_t> const& generator, uint64_t actionIndex) override {
+        auto valuation = generator.currentStateToSimpleValuation();
+        std::vector<int64_t> key;
+        key.reserve(variables.size());
+        for (auto const& variable : variables) {
+            key.push_back(variable.hasBooleanType() ? valuation.getBooleanValue(variable) : valuation.getIntegerValue(variable));
+        }
+        auto entry = table.find(key);
+        if (entry == table.end()) {
+            return allowUnspecified;
+        }
+        return entry->second.count(actionIndex) > 0;
+    }
+
+   private:
+    std::vector<storm::expressions::Variable> variables;
+    std::map<std::vector<int64_t>, std::set<uint64_t>> table;
+    bool allowUnspecified;
+};
+
+void define_action_masks(py::module& m) {
+    py::class_<ExpressionActionMask, std::shared_ptr<ExpressionActionMask>, storm::generator::ActionMask<double>>(m, "ExpressionActionMaskDouble", R"doc(
+        Action mask allowing an action in a state iff its guard expression holds in the state.
+        The guards are compiled and evaluated without calling into Python, so masked models can be built in parallel with the GIL released.
+        )doc")
+        .def(py::init<std::map<uint64_t, storm::expressions::Expression> const&, bool>(), R"doc(
+            :param guards: Map from action indices (see PrismProgram.get_action_index) to Boolean expressions over the program variables.
+            :param allow_unspecified: Whether actions without a guard are allowed.
+            )doc", py::arg("guards"), py::arg("allow_unspecified") = true)
+    ;
+
+    py::class_<ValuationTableActionMask, std::shared_ptr<ValuationTableActionMask>, storm::generator::ActionMask<double>>(m, "ValuationTableActionMaskDouble", R"doc(
+        Action mask given by a lookup table from valuations to the allowed actions.
+        The table is evaluated without calling into Python, so masked models can be built in parallel with the GIL released.
+        )doc")
+        .def(py::init<std::vector<storm::expressions::Variable> const&, std::map<std::vector<int64_t>, std::set<uint64_t>> const&, bool>(), R"doc(
+            :param variables: Boolean and integer variables forming the keys of the table.
+            :param table: Map from tuples of values of the variables to the set of allowed action indices.
+            :param allow_unspecified: Whether all actions are allowed in states whose valuation is not in the table.
+            )doc", py::arg("variables"), py::arg("table"), py::arg("allow_unspecified") = true)
+    ;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "common.h"
+
+void define_action_masks(py::module& m);
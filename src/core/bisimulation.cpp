@@ -1,6 +1,9 @@
 #include "bisimulation.h"
+#include "signature_bisimulation.h"
 #include "storm/models/symbolic/StandardRewardModel.h"
 
+#include <pybind11/numpy.h>
+
 
 template <storm::dd::DdType DdType, typename ValueType>
 std::shared_ptr<storm::models::Model<ValueType>> performBisimulationMinimization(std::shared_ptr<storm::models::symbolic::Model<DdType, ValueType>> const& model, std::vector<std::shared_ptr<storm::logic::Formula const>> const& formulas, storm::storage::BisimulationType const& bisimulationType, storm::dd::bisimulation::QuotientFormat const& quotientFormat) {
@@ -16,6 +19,36 @@ void define_bisimulation(py::module& m) {
     m.def("_perform_symbolic_bisimulation", &performBisimulationMinimization<storm::dd::DdType::Sylvan, double>, "Perform bisimulation", py::arg("model"), py::arg("formulas"), py::arg("bisimulation_type"), py::arg("quotient_format"));
     m.def("_perform_symbolic_parametric_bisimulation", &performBisimulationMinimization<storm::dd::DdType::Sylvan, storm::RationalFunction>, "Perform bisimulation on parametric model", py::arg("model"), py::arg("formulas"), py::arg("bisimulation_type"), py::arg("quotient_format"));
 
+    // Signature-based bisimulation
+    py::class_<SignatureBisimulationRound>(m, "BisimulationRoundStatistics", "Statistics of one refinement round of the signature-based bisimulation")
+        .def_readonly("blocks", &SignatureBisimulationRound::blocks, "Number of blocks after the round")
+        .def_readonly("seconds", &SignatureBisimulationRound::seconds, "Wall time of the round in seconds")
+    ;
+    py::class_<SignatureBisimulationResult>(m, "SignatureBisimulationResult", "Result of the signature-based bisimulation")
+        .def_readonly("quotient", &SignatureBisimulationResult::quotient, "Quotient model, its states are the blocks")
+        .def_property_readonly("state_to_block", [](SignatureBisimulationResult const& result) {
+            return py::array_t<uint64_t>(result.stateToBlock.size(), result.stateToBlock.data());
+        }, "Block of each state of the original model as NumPy array")
+        .def_readonly("rounds", &SignatureBisimulationResult::rounds, "Statistics of the refinement rounds")
+    ;
+    m.def("_perform_signature_bisimulation", [](std::shared_ptr<storm::models::sparse::Model<double>> const& model, std::vector<std::shared_ptr<storm::logic::Formula const>> const& formulas, uint64_t numberOfThreads, std::optional<py::array_t<uint64_t, py::array::c_style | py::array::forcecast>> const& initialPartition) {
+        boost::optional<std::vector<uint64_t>> partition;
+        if (initialPartition) {
+            STORM_LOG_THROW(initialPartition->ndim() == 1, storm::exceptions::InvalidArgumentException, "Initial partition must be one-dimensional.");
+            partition = std::vector<uint64_t>(initialPartition->data(), initialPartition->data() + initialPartition->size());
+        }
+        py::gil_scoped_release release;
+        return SignatureBisimulation(model, formulas, numberOfThreads, std::move(partition)).compute();
+    }, R"doc(
+        Perform strong bisimulation on a sparse DTMC, CTMC or MDP by parallel signature-based partition refinement.
+
+        :param model: Model.
+        :param formulas: Formulas whose labels and reward models are preserved. If empty, all labels and reward models are preserved.
+        :param nr_threads: Number of threads, 0 for the number of cores.
+        :param initial_partition: Block of each state from a previous run on a structurally identical model. Refinement starts from this partition.
+        :return: Quotient together with the block of each state and the statistics of the refinement rounds.
+        )doc", py::arg("model"), py::arg("formulas"), py::arg("nr_threads") = 0, py::arg("initial_partition") = py::none());
+
     // BisimulationType
     py::enum_<storm::storage::BisimulationType>(m, "BisimulationType", "Types of bisimulation")
         .value("STRONG", storm::storage::BisimulationType::Strong)
@@ -1,6 +1,8 @@
 #include <pybind11/functional.h>
 
 #include "core.h"
+#include "parallel_builder.h"
+#include "sylvan.h"
 #include "storm/utility/initialize.h"
 #include "storm/utility/SignalHandler.h"
 #include "storm/io/DirectEncodingExporter.h"
@@ -88,11 +90,37 @@ std::shared_ptr<storm::models::sparse::Model<ValueType>> buildSparseModel(storm:
     }
 }
 
+// The exploration of exact and parametric models remains sequential
 template<typename ValueType>
-std::shared_ptr<storm::models::ModelBase> buildSparseModelWithOptions(storm::storage::SymbolicModelDescription const& modelDescription, storm::builder::BuilderOptions const& options) {
+std::shared_ptr<storm::models::ModelBase> buildSparseModelWithOptions(storm::storage::SymbolicModelDescription const& modelDescription, ParallelBuilderOptions const& options) {
     return storm::api::buildSparseModel<ValueType>(modelDescription, options);
 }
 
+std::shared_ptr<storm::models::ModelBase> buildSparseModelWithParallelOptions(storm::storage::SymbolicModelDescription const& modelDescription, ParallelBuilderOptions const& options, std::shared_ptr<storm::generator::ActionMask<double>> const& actionMask) {
+    if (options.getExplorationThreads() != 1 && ParallelExplicitModelBuilder<double>::isSupported(modelDescription, options, actionMask != nullptr)) {
+        ParallelExplicitModelBuilder<double> builder(modelDescription, options, actionMask);
+        return builder.build();
+    }
+    if (actionMask) {
+        return storm::api::makeExplicitModelBuilder<double>(modelDescription, options, actionMask).build();
+    }
+    return storm::api::buildSparseModel<double>(modelDescription, options);
+}
+
+template<typename ValueType>
+storm::builder::ExplicitModelBuilder<ValueType> makeSparseModelBuilder(storm::storage::SymbolicModelDescription const& modelDescription, ParallelBuilderOptions const& options, std::shared_ptr<storm::generator::ActionMask<ValueType>> const& actionMask) {
+    return storm::api::makeExplicitModelBuilder<ValueType>(modelDescription, options, actionMask);
+}
+
+// Setters of the Storm options returning the bound options type, such that calls can be chained
+template<typename Setter>
+auto setBuilderOption(Setter setter) {
+    return [setter](ParallelBuilderOptions& options, bool newValue) -> ParallelBuilderOptions& {
+        (options.*setter)(newValue);
+        return options;
+    };
+}
+
 template<typename ValueType>
 storm::builder::ExplicitModelBuilder<double> makeExplicitModelBuilder(storm::storage::SymbolicModelDescription const& model, storm::builder::BuilderOptions const& options) {
     return storm::api::makeExplicitModelBuilder<double>(model, options, nullptr); // Do not set ActionMask
@@ -101,6 +129,7 @@ storm::builder::ExplicitModelBuilder<double> makeExplicitModelBuilder(storm::sto
 // Thin wrapper for model building using symbolic representation
 template<storm::dd::DdType DdType, typename ValueType>
 std::shared_ptr<storm::models::symbolic::Model<DdType, ValueType>> buildSymbolicModel(storm::storage::SymbolicModelDescription const& modelDescription, std::vector<std::shared_ptr<storm::logic::Formula const>> const& formulas) {
+    SylvanOperationRecorder recorder("build");
     if (formulas.empty()) {
         // Build full model
         return storm::api::buildSymbolicModel<DdType, ValueType>(modelDescription, formulas, true);
@@ -120,7 +149,13 @@ void define_build(py::module& m) {
     m.def("_build_sparse_model_from_symbolic_description", &buildSparseModel<double>, "Build the model in sparse representation", py::arg("model_description"), py::arg("formulas") = std::vector<std::shared_ptr<storm::logic::Formula const>>());
     m.def("_build_sparse_exact_model_from_symbolic_description", &buildSparseModel<storm::RationalNumber>, "Build the model in sparse representation with exact number representation", py::arg("model_description"), py::arg("formulas") = std::vector<std::shared_ptr<storm::logic::Formula const>>());
     m.def("_build_sparse_parametric_model_from_symbolic_description", &buildSparseModel<storm::RationalFunction>, "Build the parametric model in sparse representation", py::arg("model_description"), py::arg("formulas") = std::vector<std::shared_ptr<storm::logic::Formula const>>());
-    m.def("build_sparse_model_with_options", &buildSparseModelWithOptions<double>, "Build the model in sparse representation", py::arg("model_description"), py::arg("options"));
+    m.def("build_sparse_model_with_options", &buildSparseModelWithParallelOptions, R"doc(
+        Build the model in sparse representation.
+
+        :param model_description: Symbolic model description.
+        :param options: Builder options.
+        :param action_mask: Optional action mask restricting the enabled actions. Masks evaluated in C++, such as ExpressionActionMaskDouble, allow the parallel exploration without the GIL.
+        )doc", py::arg("model_description"), py::arg("options"), py::arg("action_mask") = nullptr, py::call_guard<py::gil_scoped_release>());
     m.def("build_sparse_exact_model_with_options", &buildSparseModelWithOptions<storm::RationalNumber>, "Build the model in sparse representation with exact number representation", py::arg("model_description"), py::arg("options"));
     m.def("build_sparse_parametric_model_with_options", &buildSparseModelWithOptions<storm::RationalFunction>, "Build the model in sparse representation", py::arg("model_description"), py::arg("options"));
     m.def("_build_symbolic_model_from_symbolic_description", &buildSymbolicModel<storm::dd::DdType::Sylvan, double>, "Build the model in symbolic representation", py::arg("model_description"), py::arg("formulas") = std::vector<std::shared_ptr<storm::logic::Formula const>>());
@@ -131,9 +166,9 @@ void define_build(py::module& m) {
     m.def("_build_sparse_interval_model_from_drn", &storm::api::buildExplicitDRNModel<storm::Interval>, "Build the interval model from DRN", py::arg("file"), py::arg("options") = storm::parser::DirectEncodingParserOptions());
     m.def("build_sparse_model_from_explicit", &storm::api::buildExplicitModel<double>, "Build the model model from explicit input", py::arg("transition_file"), py::arg("labeling_file"), py::arg("state_reward_file") = "", py::arg("transition_reward_file") = "", py::arg("choice_labeling_file") = "");
 
-    m.def("make_sparse_model_builder", &storm::api::makeExplicitModelBuilder<double>, "Construct a builder instance", py::arg("model_description"), py::arg("options"), py::arg("action_mask") = nullptr);
-    m.def("make_sparse_model_builder_exact", &storm::api::makeExplicitModelBuilder<storm::RationalNumber>, "Construct a builder instance", py::arg("model_description"), py::arg("options"), py::arg("action_mask") = nullptr);
-    m.def("make_sparse_model_builder_parametric", &storm::api::makeExplicitModelBuilder<storm::RationalFunction>, "Construct a builder instance", py::arg("model_description"), py::arg("options"), py::arg("action_mask") = nullptr);
+    m.def("make_sparse_model_builder", &makeSparseModelBuilder<double>, "Construct a builder instance", py::arg("model_description"), py::arg("options"), py::arg("action_mask") = nullptr);
+    m.def("make_sparse_model_builder_exact", &makeSparseModelBuilder<storm::RationalNumber>, "Construct a builder instance", py::arg("model_description"), py::arg("options"), py::arg("action_mask") = nullptr);
+    m.def("make_sparse_model_builder_parametric", &makeSparseModelBuilder<storm::RationalFunction>, "Construct a builder instance", py::arg("model_description"), py::arg("options"), py::arg("action_mask") = nullptr);
 
     py::class_<storm::builder::ExplicitModelBuilder<double>>(m, "ExplicitModelBuilder", "Model builder for sparse models")
         .def("build", &storm::builder::ExplicitModelBuilder<double>::build, "Build the model",  py::call_guard<py::gil_scoped_release>())
@@ -151,19 +186,28 @@ void define_build(py::module& m) {
 
     ;
 
-    py::class_<storm::builder::BuilderOptions>(m, "BuilderOptions", "Options for building process")
+    // Storm functions taking BuilderOptions are bound with ParallelBuilderOptions, such that there is a single options type in Python
+    py::class_<ParallelBuilderOptions>(m, "BuilderOptions", "Options for building process")
             .def(py::init<std::vector<std::shared_ptr<storm::logic::Formula const>> const&>(), "Initialise with formulae to preserve", py::arg("formulae"))
             .def(py::init<bool, bool>(), "Initialise without formulae", py::arg("build_all_reward_models")=true, py::arg("build_all_labels")=true)
-            .def_property_readonly("preserved_label_names", &storm::builder::BuilderOptions::getLabelNames, "Labels preserved")
-            .def("set_build_state_valuations", &storm::builder::BuilderOptions::setBuildStateValuations, "Build state valuations", py::arg("new_value")=true)
-            .def("set_build_observation_valuations", &storm::builder::BuilderOptions::setBuildObservationValuations, "Build observation valuations", py::arg("new_value")=true)
-            .def("set_build_with_choice_origins", &storm::builder::BuilderOptions::setBuildChoiceOrigins, "Build choice origins", py::arg("new_value")=true)
-            .def("set_add_out_of_bounds_state", &storm::builder::BuilderOptions::setAddOutOfBoundsState, "Build with out of bounds state", py::arg("new_value")=true)
-            .def("set_add_overlapping_guards_label", &storm::builder::BuilderOptions::setAddOverlappingGuardsLabel, "Build with overlapping guards state labeled", py::arg("new_value")=true)
-            .def("set_build_choice_labels", &storm::builder::BuilderOptions::setBuildChoiceLabels, "Build with choice labels", py::arg("new_value")=true)
-            .def("set_exploration_checks", &storm::builder::BuilderOptions::setExplorationChecks, "Perform extra checks during exploration", py::arg("new_value")=true)
-            .def("set_build_all_labels" , &storm::builder::BuilderOptions::setBuildAllLabels, "Build with all state labels", py::arg("new_value")=true)
-            .def("set_build_all_reward_models", &storm::builder::BuilderOptions::setBuildAllRewardModels, "Build with all reward models", py::arg("new_value")=true);
+            .def_property_readonly("preserved_label_names", &ParallelBuilderOptions::getLabelNames, "Labels preserved")
+            .def("set_build_state_valuations", setBuilderOption(&storm::builder::BuilderOptions::setBuildStateValuations), "Build state valuations", py::arg("new_value")=true, py::return_value_policy::reference_internal)
+            .def("set_build_observation_valuations", setBuilderOption(&storm::builder::BuilderOptions::setBuildObservationValuations), "Build observation valuations", py::arg("new_value")=true, py::return_value_policy::reference_internal)
+            .def("set_build_with_choice_origins", setBuilderOption(&storm::builder::BuilderOptions::setBuildChoiceOrigins), "Build choice origins", py::arg("new_value")=true, py::return_value_policy::reference_internal)
+            .def("set_add_out_of_bounds_state", setBuilderOption(&storm::builder::BuilderOptions::setAddOutOfBoundsState), "Build with out of bounds state", py::arg("new_value")=true, py::return_value_policy::reference_internal)
+            .def("set_add_overlapping_guards_label", setBuilderOption(&storm::builder::BuilderOptions::setAddOverlappingGuardsLabel), "Build with overlapping guards state labeled", py::arg("new_value")=true, py::return_value_policy::reference_internal)
+            .def("set_build_choice_labels", setBuilderOption(&storm::builder::BuilderOptions::setBuildChoiceLabels), "Build with choice labels", py::arg("new_value")=true, py::return_value_policy::reference_internal)
+            .def("set_exploration_checks", setBuilderOption(&storm::builder::BuilderOptions::setExplorationChecks), "Perform extra checks during exploration", py::arg("new_value")=true, py::return_value_policy::reference_internal)
+            .def("set_build_all_labels" , setBuilderOption(&storm::builder::BuilderOptions::setBuildAllLabels), "Build with all state labels", py::arg("new_value")=true, py::return_value_policy::reference_internal)
+            .def("set_build_all_reward_models", setBuilderOption(&storm::builder::BuilderOptions::setBuildAllRewardModels), "Build with all reward models", py::arg("new_value")=true, py::return_value_policy::reference_internal)
+            .def_property_readonly("exploration_threads", &ParallelBuilderOptions::getExplorationThreads, "Number of threads used for the explicit state exploration")
+            .def("set_exploration_threads", &ParallelBuilderOptions::setExplorationThreads, R"doc(
+                Set the number of threads used by build_sparse_model_with_options for the explicit state exploration.
+                The parallel exploration yields the same model (including the state ordering) as the sequential one.
+                Exact and parametric models, choice origins, observation valuations, terminal states and non-BFS exploration orders are always explored sequentially.
+
+                :param int nr_threads: Number of threads, 1 (default) for the sequential builder, 0 for all hardware threads.
+            )doc", py::arg("nr_threads"));
 
     py::class_<storm::generator::ActionMask<double>, std::shared_ptr<storm::generator::ActionMask<double>>> actionmask(m, "ActionMaskDouble");
     py::class_<storm::generator::StateValuationFunctionMask<double>, std::shared_ptr<storm::generator::StateValuationFunctionMask<double>>> actfuncmask(m, "StateValuationFunctionActionMaskDouble", actionmask);
@@ -0,0 +1,393 @@
+#include "expression_compiler.h"
+
+#include "src/parallel.h"
+
+#include "storm/storage/expressions/BaseExpression.h"
+#include "storm/storage/expressions/ExpressionManager.h"
+#include "storm/storage/expressions/OperatorType.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+#include "storm/exceptions/InvalidOperationException.h"
+#include "storm/exceptions/NotSupportedException.h"
+
+#include <pybind11/numpy.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Number of valuations processed together by the batch evaluation
+    uint64_t const BLOCK_SIZE = 256;
+}
+
+CompiledExpression::CompiledExpression(storm::expressions::Expression const& expression, std::vector<storm::expressions::Variable> const& inputs) : inputs(inputs) {
+    for (auto const& variable : inputs) {
+        STORM_LOG_THROW(!variable.hasBitVectorType(), storm::exceptions::NotSupportedException, "Bit vector variable '" << variable.getName() << "' is not supported.");
+        inputRegisters.push_back(addConstant(0));
+        constantRegisters.back() = false;
+    }
+    for (auto const& variable : expression.getVariables()) {
+        STORM_LOG_THROW(std::find(inputs.begin(), inputs.end(), variable) != inputs.end(), storm::exceptions::InvalidArgumentException,
+                        "Variable '" << variable.getName() << "' of expression '" << expression << "' is not an input.");
+    }
+    resultType = expression.hasBooleanType() ? ResultType::Boolean : (expression.hasIntegerType() ? ResultType::Integer : ResultType::Rational);
+    resultRegister = compile(expression);
+    compiledSubexpressions.clear();
+}
+
+std::vector<storm::expressions::Variable> const& CompiledExpression::getInputs() const {
+    return inputs;
+}
+
+CompiledExpression::ResultType CompiledExpression::getResultType() const {
+    return resultType;
+}
+
+uint64_t CompiledExpression::getNumberOfInstructions() const {
+    return instructions.size();
+}
+
+uint64_t CompiledExpression::getNumberOfRegisters() const {
+    return initialRegisters.size();
+}
+
+bool CompiledExpression::isConstant() const {
+    return constantRegisters[resultRegister];
+}
+
+uint32_t CompiledExpression::addConstant(double value) {
+    initialRegisters.push_back(value);
+    constantRegisters.push_back(true);
+    return initialRegisters.size() - 1;
+}
+
+uint32_t CompiledExpression::compile(storm::expressions::Expression const& expression) {
+    auto cached = compiledSubexpressions.find(&expression.getBaseExpression());
+    if (cached != compiledSubexpressions.end()) {
+        return cached->second;
+    }
+
+    uint32_t result;
+    if (expression.isVariable()) {
+        auto variable = expression.getManager().getVariable(expression.getIdentifier());
+        result = inputRegisters[std::find(inputs.begin(), inputs.end(), variable) - inputs.begin()];
+    } else if (expression.isLiteral()) {
+        result = addConstant(expression.hasBooleanType() ? (expression.evaluateAsBool() ? 1 : 0) : expression.evaluateAsDouble());
+    } else {
+        STORM_LOG_THROW(expression.isFunctionApplication(), storm::exceptions::NotSupportedException, "Expression '" << expression << "' cannot be compiled.");
+        OpCode opCode;
+        switch (expression.getOperator()) {
+            case storm::expressions::OperatorType::Not: opCode = OpCode::Not; break;
+            case storm::expressions::OperatorType::Floor: opCode = OpCode::Floor; break;
+            case storm::expressions::OperatorType::Ceil: opCode = OpCode::Ceil; break;
+            case storm::expressions::OperatorType::And: opCode = OpCode::And; break;
+            case storm::expressions::OperatorType::Or: opCode = OpCode::Or; break;
+            case storm::expressions::OperatorType::Xor: opCode = OpCode::Xor; break;
+            case storm::expressions::OperatorType::Implies: opCode = OpCode::Implies; break;
+            case storm::expressions::OperatorType::Iff: opCode = OpCode::Iff; break;
+            case storm::expressions::OperatorType::Plus: opCode = OpCode::Plus; break;
+            case storm::expressions::OperatorType::Minus: opCode = expression.getArity() == 1 ? OpCode::Negate : OpCode::Minus; break;
+            case storm::expressions::OperatorType::Times: opCode = OpCode::Times; break;
+            // Division of integers yields an integer, as in the evaluation of Storm
+            case storm::expressions::OperatorType::Divide: opCode = expression.hasIntegerType() ? OpCode::IntegerDivide : OpCode::Divide; break;
+            case storm::expressions::OperatorType::Min: opCode = OpCode::Min; break;
+            case storm::expressions::OperatorType::Max: opCode = OpCode::Max; break;
+            case storm::expressions::OperatorType::Power: opCode = OpCode::Power; break;
+            case storm::expressions::OperatorType::Modulo: opCode = OpCode::Modulo; break;
+            case storm::expressions::OperatorType::Equal: opCode = OpCode::Equal; break;
+            case storm::expressions::OperatorType::NotEqual: opCode = OpCode::NotEqual; break;
+            case storm::expressions::OperatorType::Less: opCode = OpCode::Less; break;
+            case storm::expressions::OperatorType::LessOrEqual: opCode = OpCode::LessOrEqual; break;
+            case storm::expressions::OperatorType::Greater: opCode = OpCode::Greater; break;
+            case storm::expressions::OperatorType::GreaterOrEqual: opCode = OpCode::GreaterOrEqual; break;
+            case storm::expressions::OperatorType::Ite: opCode = OpCode::Ite; break;
+            default:
+                STORM_LOG_THROW(false, storm::exceptions::NotSupportedException, "Operator '" << expression.getOperator() << "' cannot be compiled.");
+        }
+
+        Instruction instruction;
+        instruction.opCode = opCode;
+        bool constant = true;
+        for (uint64_t operand = 0; operand < 3; ++operand) {
+            if (operand < expression.getArity()) {
+                instruction.operands[operand] = compile(expression.getOperand(operand));
+                constant &= constantRegisters[instruction.operands[operand]];
+            } else {
+                instruction.operands[operand] = instruction.operands[0];
+            }
+        }
+        if (constant) {
+            result = addConstant(apply(opCode, initialRegisters[instruction.operands[0]], initialRegisters[instruction.operands[1]], initialRegisters[instruction.operands[2]]));
+        } else {
+            result = addConstant(0);
+            constantRegisters.back() = false;
+            instruction.target = result;
+            instructions.push_back(instruction);
+        }
+    }
+    compiledSubexpressions[&expression.getBaseExpression()] = result;
+    return result;
+}
+
+double CompiledExpression::apply(OpCode opCode, double first, double second, double third) {
+    switch (opCode) {
+        case OpCode::Not: return first == 0;
+        case OpCode::Negate: return -first;
+        case OpCode::Floor: return std::floor(first);
+        case OpCode::Ceil: return std::ceil(first);
+        case OpCode::And: return first != 0 && second != 0;
+        case OpCode::Or: return first != 0 || second != 0;
+        case OpCode::Xor: return (first != 0) != (second != 0);
+        case OpCode::Implies: return first == 0 || second != 0;
+        case OpCode::Iff: return (first != 0) == (second != 0);
+        case OpCode::Plus: return first + second;
+        case OpCode::Minus: return first - second;
+        case OpCode::Times: return first * second;
+        case OpCode::Divide: return first / second;
+        case OpCode::IntegerDivide: return std::trunc(first / second);
+        case OpCode::Min: return std::min(first, second);
+        case OpCode::Max: return std::max(first, second);
+        case OpCode::Power: return std::pow(first, second);
+        case OpCode::Modulo: return std::fmod(first, second);
+        case OpCode::Equal: return first == second;
+        case OpCode::NotEqual: return first != second;
+        case OpCode::Less: return first < second;
+        case OpCode::LessOrEqual: return first <= second;
+        case OpCode::Greater: return first > second;
+        case OpCode::GreaterOrEqual: return first >= second;
+        case OpCode::Ite: return first != 0 ? second : third;
+    }
+    return 0;
+}
+
+void CompiledExpression::run(double* registers, uint64_t stride, uint64_t size) const {
+    for (auto const& instruction : instructions) {
+        double* target = registers + instruction.target * stride;
+        double const* first = registers + instruction.operands[0] * stride;
+        double const* second = registers + instruction.operands[1] * stride;
+        double const* third = registers + instruction.operands[2] * stride;
+        // Dispatch once per instruction and block, the loops over the block are simple enough to be vectorized
+        switch (instruction.opCode) {
+            case OpCode::Plus:
+                for (uint64_t k = 0; k < size; ++k) target[k] = first[k] + second[k];
+                break;
+            case OpCode::Minus:
+                for (uint64_t k = 0; k < size; ++k) target[k] = first[k] - second[k];
+                break;
+            case OpCode::Times:
+                for (uint64_t k = 0; k < size; ++k) target[k] = first[k] * second[k];
+                break;
+            case OpCode::And:
+                for (uint64_t k = 0; k < size; ++k) target[k] = first[k] != 0 && second[k] != 0;
+                break;
+            case OpCode::Or:
+                for (uint64_t k = 0; k < size; ++k) target[k] = first[k] != 0 || second[k] != 0;
+                break;
+            case OpCode::Equal:
+                for (uint64_t k = 0; k < size; ++k) target[k] = first[k] == second[k];
+                break;
+            case OpCode::Less:
+                for (uint64_t k = 0; k < size; ++k) target[k] = first[k] < second[k];
+                break;
+            case OpCode::LessOrEqual:
+                for (uint64_t k = 0; k < size; ++k) target[k] = first[k] <= second[k];
+                break;
+            case OpCode::Ite:
+                for (uint64_t k = 0; k < size; ++k) target[k] = first[k] != 0 ? second[k] : third[k];
+                break;
+            default:
+                for (uint64_t k = 0; k < size; ++k) target[k] = apply(instruction.opCode, first[k], second[k], third[k]);
+        }
+    }
+}
+
+double* CompiledExpression::scalarRegisters() const {
+    // Scratch registers of the calling thread, such that the scalar evaluation does not allocate
+    thread_local std::vector<double> registers;
+    registers.assign(initialRegisters.begin(), initialRegisters.end());
+    return registers.data();
+}
+
+double CompiledExpression::evaluate(double const* values) const {
+    double* registers = scalarRegisters();
+    for (uint64_t input = 0; input < inputs.size(); ++input) {
+        registers[inputRegisters[input]] = values[input];
+    }
+    run(registers, 1, 1);
+    return registers[resultRegister];
+}
+
+double CompiledExpression::evaluate(storm::expressions::SimpleValuation const& valuation) const {
+    double* registers = scalarRegisters();
+    for (uint64_t input = 0; input < inputs.size(); ++input) {
+        auto const& variable = inputs[input];
+        if (variable.hasBooleanType()) {
+            registers[inputRegisters[input]] = valuation.getBooleanValue(variable) ? 1 : 0;
+        } else if (variable.hasIntegerType()) {
+            registers[inputRegisters[input]] = valuation.getIntegerValue(variable);
+        } else {
+            registers[inputRegisters[input]] = valuation.getRationalValue(variable);
+        }
+    }
+    run(registers, 1, 1);
+    return registers[resultRegister];
+}
+
+void CompiledExpression::setLayout(storm::generator::VariableInformation const& variableInformation) {
+    std::vector<LayoutEntry> newLayout;
+    for (auto const& variable : inputs) {
+        bool found = false;
+        for (auto const& information : variableInformation.booleanVariables) {
+            if (information.variable == variable) {
+                newLayout.push_back({information.bitOffset, 1, 0, true});
+                found = true;
+            }
+        }
+        for (auto const& information : variableInformation.integerVariables) {
+            if (information.variable == variable) {
+                newLayout.push_back({information.bitOffset, information.bitWidth, information.lowerBound, false});
+                found = true;
+            }
+        }
+        STORM_LOG_THROW(found, storm::exceptions::InvalidArgumentException, "Variable '" << variable.getName() << "' is not part of the state layout.");
+    }
+    layout = std::move(newLayout);
+}
+
+double CompiledExpression::evaluate(storm::generator::CompressedState const& state) const {
+    STORM_LOG_THROW(layout.size() == inputs.size(), storm::exceptions::InvalidOperationException, "The state layout has not been set.");
+    double* registers = scalarRegisters();
+    for (uint64_t input = 0; input < inputs.size(); ++input) {
+        auto const& entry = layout[input];
+        if (entry.isBoolean) {
+            registers[inputRegisters[input]] = state.get(entry.bitOffset) ? 1 : 0;
+        } else {
+            registers[inputRegisters[input]] = static_cast<int64_t>(state.getAsInt(entry.bitOffset, entry.bitWidth)) + entry.lowerBound;
+        }
+    }
+    run(registers, 1, 1);
+    return registers[resultRegister];
+}
+
+void CompiledExpression::evaluate(std::vector<double const*> const& columns, uint64_t size, double* result, uint64_t numberOfThreads) const {
+    STORM_LOG_THROW(columns.size() == inputs.size(), storm::exceptions::InvalidArgumentException, "Expected " << inputs.size() << " input columns, got " << columns.size() << ".");
+    uint64_t numberOfBlocks = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    uint64_t threads = std::max<uint64_t>(1, std::min(resolveNumberOfThreads(numberOfThreads), numberOfBlocks));
+    uint64_t blocksPerThread = (numberOfBlocks + threads - 1) / threads;
+    parallelFor(0, threads, threads, [&](uint64_t thread) {
+        std::vector<double> registers(initialRegisters.size() * BLOCK_SIZE);
+        for (uint64_t reg = 0; reg < initialRegisters.size(); ++reg) {
+            std::fill(registers.begin() + reg * BLOCK_SIZE, registers.begin() + (reg + 1) * BLOCK_SIZE, initialRegisters[reg]);
+        }
+        for (uint64_t block = thread * blocksPerThread; block < std::min(numberOfBlocks, (thread + 1) * blocksPerThread); ++block) {
+            uint64_t offset = block * BLOCK_SIZE;
+            uint64_t blockSize = std::min(BLOCK_SIZE, size - offset);
+            for (uint64_t input = 0; input < inputs.size(); ++input) {
+                std::copy(columns[input] + offset, columns[input] + offset + blockSize, registers.begin() + inputRegisters[input] * BLOCK_SIZE);
+            }
+            run(registers.data(), BLOCK_SIZE, blockSize);
+            std::copy(registers.begin() + resultRegister * BLOCK_SIZE, registers.begin() + resultRegister * BLOCK_SIZE + blockSize, result + offset);
+        }
+    });
+}
+
+namespace {
+    py::object castResult(CompiledExpression const& compiled, double value) {
+        switch (compiled.getResultType()) {
+            case CompiledExpression::ResultType::Boolean: return py::cast(value != 0);
+            case CompiledExpression::ResultType::Integer: return py::cast(static_cast<int64_t>(value));
+            default: return py::cast(value);
+        }
+    }
+
+    typedef py::array_t<double, py::array::c_style | py::array::forcecast> DoubleArray;
+
+    struct Columns {
+        // Arrays owning the data
+        std::vector<DoubleArray> arrays;
+        std::vector<double const*> data;
+        uint64_t size = 0;
+    };
+
+    // Accept either a 2D array with one column per input or a dict from variable names to arrays, e.g. from StateValuation.to_numpy()
+    Columns getColumns(CompiledExpression const& compiled, py::object const& values) {
+        Columns columns;
+        if (py::isinstance<py::dict>(values)) {
+            py::dict dict = values.cast<py::dict>();
+            for (auto const& variable : compiled.getInputs()) {
+                STORM_LOG_THROW(dict.contains(variable.getName()), storm::exceptions::InvalidArgumentException, "No values given for variable '" << variable.getName() << "'.");
+                DoubleArray column = DoubleArray::ensure(dict[py::str(variable.getName())]);
+                STORM_LOG_THROW(column && column.ndim() == 1, storm::exceptions::InvalidArgumentException, "Values of variable '" << variable.getName() << "' must be a one-dimensional array.");
+                STORM_LOG_THROW(columns.arrays.empty() || static_cast<uint64_t>(column.size()) == columns.size, storm::exceptions::InvalidArgumentException, "All arrays must have the same length.");
+                columns.size = column.size();
+                columns.data.push_back(column.data());
+                columns.arrays.push_back(std::move(column));
+            }
+            if (columns.arrays.empty() && dict.size() > 0) {
+                columns.size = py::len((*dict.begin()).second);
+            }
+        } else {
+            DoubleArray matrix = DoubleArray::ensure(values);
+            STORM_LOG_THROW(matrix && matrix.ndim() == 2 && static_cast<uint64_t>(matrix.shape(1)) == compiled.getInputs().size(), storm::exceptions::InvalidArgumentException,
+                            "Values must be a two-dimensional array with one column per variable.");
+            columns.size = matrix.shape(0);
+            // Transpose such that the values of each input are contiguous
+            DoubleArray transposed = DoubleArray::ensure(py::module::import("numpy").attr("ascontiguousarray")(matrix.attr("T")));
+            for (uint64_t input = 0; input < compiled.getInputs().size(); ++input) {
+                columns.data.push_back(transposed.data() + input * columns.size);
+            }
+            columns.arrays.push_back(std::move(transposed));
+        }
+        return columns;
+    }
+}
+
+void define_expression_compiler(py::module& m) {
+    py::class_<CompiledExpression, std::shared_ptr<CompiledExpression>>(m, "CompiledExpression", R"doc(
+        Expression compiled into a register-based bytecode for fast repeated evaluation.
+        Constant subexpressions are folded during compilation. All values are computed in double precision, integers are exact up to 2^53.
+        )doc")
+        .def(py::init<storm::expressions::Expression const&, std::vector<storm::expressions::Variable> const&>(), R"doc(
+            Compile an expression.
+
+            :param expression: Expression.
+            :param variables: Variables of the expression in the order in which their values are passed to evaluate.
+            )doc", py::arg("expression"), py::arg("variables"))
+        .def(py::init([](storm::expressions::Expression const& expression) {
+            auto variables = expression.getVariables();
+            std::vector<storm::expressions::Variable> inputs(variables.begin(), variables.end());
+            std::sort(inputs.begin(), inputs.end(), [](auto const& a, auto const& b) { return a.getName() < b.getName(); });
+            return std::make_shared<CompiledExpression>(expression, inputs);
+        }), "Compile an expression with its variables ordered by name as inputs", py::arg("expression"))
+        .def_property_readonly("variables", &CompiledExpression::getInputs, "Input variables in the order of their values")
+        .def_property_readonly("nr_instructions", &CompiledExpression::getNumberOfInstructions, "Number of instructions after constant folding")
+        .def_property_readonly("nr_registers", &CompiledExpression::getNumberOfRegisters, "Number of registers")
+        .def_property_readonly("is_constant", &CompiledExpression::isConstant, "Whether the expression does not depend on its inputs")
+        .def("evaluate", [](CompiledExpression const& compiled, std::vector<double> const& values) {
+            STORM_LOG_THROW(values.size() == compiled.getInputs().size(), storm::exceptions::InvalidArgumentException, "Expected " << compiled.getInputs().size() << " values, got " << values.size() << ".");
+            return castResult(compiled, compiled.evaluate(values.data()));
+        }, "Evaluate for the given values of the variables", py::arg("values"))
+        .def("evaluate", [](CompiledExpression const& compiled, storm::expressions::SimpleValuation const& valuation) {
+            return castResult(compiled, compiled.evaluate(valuation));
+        }, "Evaluate for the given valuation", py::arg("valuation"))
+        .def("evaluate_batch", [](CompiledExpression const& compiled, py::object const& values, uint64_t numberOfThreads) -> py::array {
+            Columns columns = getColumns(compiled, values);
+            py::array_t<double> result(columns.size);
+            double* output = result.mutable_data();
+            {
+                py::gil_scoped_release release;
+                compiled.evaluate(columns.data, columns.size, output, numberOfThreads);
+            }
+            switch (compiled.getResultType()) {
+                case CompiledExpression::ResultType::Boolean: return result.attr("astype")("bool");
+                case CompiledExpression::ResultType::Integer: return result.attr("astype")("int64");
+                default: return result;
+            }
+        }, R"doc(
+            Evaluate for many valuations at once.
+
+            :param values: Either a 2D array with one row per valuation and one column per variable, or a dict from variable names to 1D arrays as returned by StateValuation.to_numpy().
+            :param nr_threads: Number of threads, 0 for the number of cores.
+            :return: NumPy array of results with dtype bool, int64 or float64 according to the type of the expression.
+            )doc", py::arg("values"), py::arg("nr_threads") = 1)
+    ;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "common.h"
+
+#include <unordered_map>
+
+#include "storm/generator/CompressedState.h"
+#include "storm/generator/VariableInformation.h"
+#include "storm/storage/expressions/Expression.h"
+#include "storm/storage/expressions/SimpleValuation.h"
+
+void define_expression_compiler(py::module& m);
+
+/*!
+ * An expression compiled into a register-based bytecode.
+ * Every subexpression is assigned a register holding a double; Booleans are stored as 0 and 1, integers are exact up to 2^53.
+ * Subexpressions over constants only are folded during compilation and shared subexpressions are computed once.
+ * The inputs are the variables of the expression in a fixed order. Their values can be read from an array, a valuation,
+ * or from a compressed state of a next-state generator after setting its variable layout.
+ */
+class CompiledExpression {
+   public:
+    enum class ResultType { Boolean, Integer, Rational };
+
+    /*!
+     * @param expression The expression to compile.
+     * @param inputs The variables of the expression in the order in which their values are given. Must contain all variables of the expression.
+     */
+    CompiledExpression(storm::expressions::Expression const& expression, std::vector<storm::expressions::Variable> const& inputs);
+
+    std::vector<storm::expressions::Variable> const& getInputs() const;
+    ResultType getResultType() const;
+    uint64_t getNumberOfInstructions() const;
+    uint64_t getNumberOfRegisters() const;
+    bool isConstant() const;
+
+    /*!
+     * Evaluate for the given values of the inputs.
+     */
+    double evaluate(double const* values) const;
+    double evaluate(storm::expressions::SimpleValuation const& valuation) const;
+
+    /*!
+     * Set the layout of compressed states from which the inputs are read by evaluate(CompressedState).
+     * Only Boolean and integer variables are part of compressed states.
+     */
+    void setLayout(storm::generator::VariableInformation const& variableInformation);
+    double evaluate(storm::generator::CompressedState const& state) const;
+
+    /*!
+     * Evaluate for many valuations at once. The values of input i are given by columns[i][0..size).
+     * Valuations are processed in blocks, such that each instruction runs as a tight loop over a block.
+     */
+    void evaluate(std::vector<double const*> const& columns, uint64_t size, double* result, uint64_t numberOfThreads = 1) const;
+
+   private:
+    enum class OpCode : uint8_t {
+        Not, Negate, Floor, Ceil,
+        And, Or, Xor, Implies, Iff,
+        Plus, Minus, Times, Divide, IntegerDivide, Min, Max, Power, Modulo,
+        Equal, NotEqual, Less, LessOrEqual, Greater, GreaterOrEqual,
+        Ite
+    };
+
+    struct Instruction {
+        OpCode opCode;
+        uint32_t target;
+        uint32_t operands[3];
+    };
+
+    struct LayoutEntry {
+        uint64_t bitOffset;
+        uint64_t bitWidth;
+        int64_t lowerBound;
+        bool isBoolean;
+    };
+
+    uint32_t compile(storm::expressions::Expression const& expression);
+    uint32_t addConstant(double value);
+    static double apply(OpCode opCode, double first, double second, double third);
+    // Run all instructions on 'size' valuations, where register r of valuation k is at registers[r * stride + k]
+    void run(double* registers, uint64_t stride, uint64_t size) const;
+    double* scalarRegisters() const;
+
+    std::vector<storm::expressions::Variable> inputs;
+    std::vector<uint32_t> inputRegisters;
+    std::vector<Instruction> instructions;
+    // Initial content of the registers, which holds the constants
+    std::vector<double> initialRegisters;
+    std::vector<bool> constantRegisters;
+    std::unordered_map<storm::expressions::BaseExpression const*, uint32_t> compiledSubexpressions;
+    std::vector<LayoutEntry> layout;
+    uint32_t resultRegister;
+    ResultType resultType;
+};
@@ -0,0 +1,299 @@
+#include "jani_io.h"
+
+#include <fstream>
+#include <sstream>
+
+#include <boost/container/flat_set.hpp>
+
+#include "storm/adapters/JsonAdapter.h"
+#include "storm-parsers/api/storm-parsers.h"
+#include "storm/storage/jani/Model.h"
+#include "storm/storage/jani/Property.h"
+#include "storm/storage/jani/visitor/JSONExporter.h"
+#include "storm/exceptions/FileIoException.h"
+#include "storm/exceptions/WrongFormatException.h"
+
+namespace {
+
+    void writeEscaped(std::string& output, std::string const& value) {
+        static char const* hexDigits = "0123456789abcdef";
+        output.push_back('"');
+        for (char c : value) {
+            switch (c) {
+                case '"': output += "\\\""; break;
+                case '\\': output += "\\\\"; break;
+                case '\n': output += "\\n"; break;
+                case '\r': output += "\\r"; break;
+                case '\t': output += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        output += "\\u00";
+                        output.push_back(hexDigits[(c >> 4) & 0xf]);
+                        output.push_back(hexDigits[c & 0xf]);
+                    } else {
+                        output.push_back(c);
+                    }
+            }
+        }
+        output.push_back('"');
+    }
+
+    /*!
+     * SAX handler writing the parsed JSON in compact form without building a tree.
+     * Comments are dropped outside of the properties, as they are not used by the JANI parser but make up a large part of exported files.
+     * Values are copied verbatim, in particular numbers keep their textual representation.
+     */
+    class CompactingHandler {
+       public:
+        using json = nlohmann::json;
+
+        explicit CompactingHandler(std::string& output) : output(output) {
+        }
+
+        bool null() {
+            return scalar("null");
+        }
+
+        bool boolean(bool b) {
+            return scalar(b ? "true" : "false");
+        }
+
+        bool number_integer(json::number_integer_t number) {
+            return scalar(std::to_string(number));
+        }
+
+        bool number_unsigned(json::number_unsigned_t number) {
+            return scalar(std::to_string(number));
+        }
+
+        bool number_float(json::number_float_t, json::string_t const& raw) {
+            return scalar(raw);
+        }
+
+        bool string(json::string_t& s) {
+            if (beginValue(false)) {
+                writeEscaped(output, s);
+            }
+            return true;
+        }
+
+        bool binary(json::binary_t&) {
+            STORM_LOG_THROW(false, storm::exceptions::WrongFormatException, "Binary values are not supported in JANI.");
+        }
+
+        bool start_object(std::size_t) {
+            return start(true, '{');
+        }
+
+        bool key(json::string_t& k) {
+            if (skippedDepth > 0) {
+                return true;
+            }
+            // The properties keep their comments
+            if (k == "comment" && !insideProperties()) {
+                skipNext = true;
+                return true;
+            }
+            Frame& frame = frames.back();
+            if (!frame.first) {
+                output.push_back(',');
+            }
+            frame.first = false;
+            writeEscaped(output, k);
+            output.push_back(':');
+            nextIsProperties = frames.size() == 1 && k == "properties";
+            return true;
+        }
+
+        bool end_object() {
+            return end('}');
+        }
+
+        bool start_array(std::size_t) {
+            return start(false, '[');
+        }
+
+        bool end_array() {
+            return end(']');
+        }
+
+        bool parse_error(std::size_t position, std::string const&, nlohmann::detail::exception const& e) {
+            STORM_LOG_THROW(false, storm::exceptions::WrongFormatException, "Could not parse JANI input at position " << position << ": " << e.what());
+        }
+
+       private:
+        struct Frame {
+            bool isObject;
+            bool first;
+        };
+
+        bool insideProperties() const {
+            return propertiesDepth > 0 && frames.size() >= propertiesDepth;
+        }
+
+        // Start a value, returns whether it is written. Structures that are skipped increase the skipped depth.
+        bool beginValue(bool structure) {
+            if (skippedDepth > 0 || skipNext) {
+                skipNext = false;
+                if (structure) {
+                    ++skippedDepth;
+                }
+                return false;
+            }
+            if (!frames.empty() && !frames.back().isObject) {
+                if (!frames.back().first) {
+                    output.push_back(',');
+                }
+                frames.back().first = false;
+            }
+            return true;
+        }
+
+        bool scalar(std::string const& text) {
+            if (beginValue(false)) {
+                output += text;
+            }
+            return true;
+        }
+
+        bool start(bool isObject, char c) {
+            bool properties = nextIsProperties && !isObject;
+            nextIsProperties = false;
+            if (beginValue(true)) {
+                output.push_back(c);
+                frames.push_back({isObject, true});
+                if (properties) {
+                    propertiesDepth = frames.size();
+                }
+            }
+            return true;
+        }
+
+        bool end(char c) {
+            if (skippedDepth > 0) {
+                --skippedDepth;
+                return true;
+            }
+            if (propertiesDepth == frames.size()) {
+                propertiesDepth = 0;
+            }
+            frames.pop_back();
+            output.push_back(c);
+            return true;
+        }
+
+        std::string& output;
+        std::vector<Frame> frames;
+        // Number of open structures inside a skipped value
+        uint64_t skippedDepth = 0;
+        bool skipNext = false;
+        bool nextIsProperties = false;
+        // Number of frames up to the properties array, 0 if not inside of it
+        uint64_t propertiesDepth = 0;
+    };
+
+    template<typename InputType>
+    std::string compactJani(InputType&& input) {
+        std::string output;
+        CompactingHandler handler(output);
+        nlohmann::json::sax_parse(std::forward<InputType>(input), &handler);
+        return output;
+    }
+
+    std::pair<storm::jani::Model, std::vector<storm::jani::Property>> parseJaniModelStreaming(std::string const& path) {
+        std::ifstream stream(path, std::ios::in | std::ios::binary);
+        STORM_LOG_THROW(stream.good(), storm::exceptions::FileIoException, "Could not open file " << path << ".");
+        std::string compacted = compactJani(stream);
+        stream.close();
+        return storm::api::parseJaniModelFromString(compacted);
+    }
+
+    std::pair<storm::jani::Model, std::vector<storm::jani::Property>> parseJaniModelFromStringStreaming(std::string const& json) {
+        return storm::api::parseJaniModelFromString(compactJani(json));
+    }
+
+    /*!
+     * Write a JANI model automaton by automaton and edge by edge.
+     * Only the skeleton of the model, i.e. the model without edges, is converted into a JSON tree at once.
+     * The edges are converted one at a time and written right away, such that the tree of the full model is never built.
+     */
+    void writeJaniModelStreaming(storm::jani::Model const& model, std::vector<storm::jani::Property> const& properties, std::ostream& stream, bool commentExpressions) {
+        using ExportJson = storm::json<storm::RationalNumber>;
+        ExportJson skeleton;
+        {
+            std::stringstream skeletonStream;
+            storm::jani::JsonExporter::toStream(model.restrictEdges(boost::container::flat_set<uint_fast64_t>()), properties, skeletonStream, false, true);
+            skeleton = ExportJson::parse(skeletonStream.str());
+        }
+        STORM_LOG_THROW(skeleton.is_object() && skeleton.count("automata") > 0, storm::exceptions::WrongFormatException, "Unexpected JSON structure of the JANI model.");
+
+        stream << '{';
+        bool first = true;
+        for (auto it = skeleton.begin(); it != skeleton.end(); ++it) {
+            stream << (first ? "" : ",") << ExportJson(it.key()).dump() << ':';
+            first = false;
+            if (it.key() != "automata") {
+                stream << it.value().dump();
+                continue;
+            }
+            stream << '[';
+            uint64_t automatonIndex = 0;
+            for (auto const& automaton : it.value()) {
+                STORM_LOG_THROW(automatonIndex < model.getNumberOfAutomata(), storm::exceptions::WrongFormatException, "Unexpected number of automata.");
+                stream << (automatonIndex == 0 ? "{" : ",{");
+                for (auto entry = automaton.begin(); entry != automaton.end(); ++entry) {
+                    if (entry.key() != "edges") {
+                        stream << ExportJson(entry.key()).dump() << ':' << entry.value().dump() << ',';
+                    }
+                }
+                stream << "\"edges\":[";
+                uint64_t numberOfEdges = model.getAutomata()[automatonIndex].getNumberOfEdges();
+                for (uint64_t edgeIndex = 0; edgeIndex < numberOfEdges; ++edgeIndex) {
+                    stream << (edgeIndex == 0 ? "" : ",") << storm::jani::JsonExporter::getEdgeAsJson(model, automatonIndex, edgeIndex, commentExpressions).dump();
+                }
+                stream << "]}";
+                ++automatonIndex;
+            }
+            stream << ']';
+        }
+        stream << '}';
+        STORM_LOG_THROW(stream.good(), storm::exceptions::FileIoException, "Could not write the JANI model.");
+    }
+
+    void exportJaniModelStreaming(storm::jani::Model const& model, std::string const& path, std::vector<storm::jani::Property> const& properties, bool commentExpressions) {
+        std::ofstream stream(path, std::ios::out | std::ios::binary);
+        STORM_LOG_THROW(stream.good(), storm::exceptions::FileIoException, "Could not open file " << path << ".");
+        writeJaniModelStreaming(model, properties, stream, commentExpressions);
+    }
+
+    std::string janiModelToStringStreaming(storm::jani::Model const& model, std::vector<storm::jani::Property> const& properties, bool commentExpressions) {
+        std::stringstream stream;
+        writeJaniModelStreaming(model, properties, stream, commentExpressions);
+        return stream.str();
+    }
+}
+
+void define_jani_io(py::module& m) {
+    m.def("parse_jani_model_streaming", &parseJaniModelStreaming, py::arg("path"), py::call_guard<py::gil_scoped_release>(), R"doc(
+        Parse a JANI model with a streaming front-end.
+        The file is read by a SAX parser that writes a compact copy without whitespace and without the comments of the model, which are not used by Storm.
+        Only this compact copy is parsed into a JSON tree, which reduces time and memory for large, pretty-printed or commented files.
+
+        :param path: Path to the JANI file.
+        :return: Pair of the JANI model and the properties.
+        )doc");
+    m.def("parse_jani_model_from_string_streaming", &parseJaniModelFromStringStreaming, py::arg("json_string"), py::call_guard<py::gil_scoped_release>(),
+          "Parse a JANI model from a string with a streaming front-end, see parse_jani_model_streaming");
+    m.def("export_jani_model_streaming", &exportJaniModelStreaming, py::arg("model"), py::arg("path"), py::arg("properties") = std::vector<storm::jani::Property>(),
+          py::arg("comment_expressions") = true, py::call_guard<py::gil_scoped_release>(), R"doc(
+        Export a JANI model to a file without building the JSON tree of the complete model.
+        The model without edges is converted at once, edges are converted and written one at a time.
+
+        :param model: The JANI model.
+        :param path: Path of the file to write.
+        :param properties: Properties to export along with the model.
+        :param comment_expressions: Whether the expressions of the edges are commented with their textual representation.
+        )doc");
+    m.def("jani_model_to_string_streaming", &janiModelToStringStreaming, py::arg("model"), py::arg("properties") = std::vector<storm::jani::Property>(),
+          py::arg("comment_expressions") = true, py::call_guard<py::gil_scoped_release>(), "Write a JANI model into a string edge by edge, see export_jani_model_streaming");
+}
@@ -1,5 +1,6 @@
 #include "modelchecking.h"
 #include "result.h"
+#include "sylvan.h"
 #include "storm/api/verification.h"
 #include "storm/environment/Environment.h"
 #include "storm/environment/solver/MinMaxSolverEnvironment.h"
@@ -40,12 +41,14 @@ std::shared_ptr<storm::modelchecker::CheckResult> modelCheckingFullyObservableSp
 // Thin wrapper for model checking using dd engine
 template<storm::dd::DdType DdType, typename ValueType>
 std::shared_ptr<storm::modelchecker::CheckResult> modelCheckingDdEngine(std::shared_ptr<storm::models::symbolic::Model<DdType, ValueType>> model, CheckTask<ValueType> const& task, storm::Environment const& env) {
+    SylvanOperationRecorder recorder("check_dd");
     return storm::api::verifyWithDdEngine<DdType, ValueType>(env, model, task);
 }
 
 // Thin wrapper for model checking using hybrid engine
 template<storm::dd::DdType DdType, typename ValueType>
 std::shared_ptr<storm::modelchecker::CheckResult> modelCheckingHybridEngine(std::shared_ptr<storm::models::symbolic::Model<DdType, ValueType>> model, CheckTask<ValueType> const& task, storm::Environment const& env) {
+    SylvanOperationRecorder recorder("check_hybrid");
     return storm::api::verifyWithHybridEngine<DdType, ValueType>(env, model, task);
 }
 
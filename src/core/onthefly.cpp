@@ -0,0 +1,313 @@
+#include "onthefly.h"
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <unordered_set>
+
+#include "storm/builder/BuilderOptions.h"
+#include "storm/generator/JaniNextStateGenerator.h"
+#include "storm/generator/PrismNextStateGenerator.h"
+#include "storm/logic/Formulas.h"
+#include "storm/solver/OptimizationDirection.h"
+#include "storm/storage/BitVectorHashMap.h"
+#include "storm/storage/SymbolicModelDescription.h"
+#include "storm/storage/expressions/SimpleValuation.h"
+#include "storm/storage/jani/Model.h"
+#include "storm/storage/prism/Program.h"
+#include "storm/exceptions/NotSupportedException.h"
+
+typedef storm::generator::CompressedState CompressedState;
+
+struct OnTheFlyOptions {
+    // Maximal number of explored states, 0 for no bound. The result is undecided if the bound is reached.
+    uint64_t maxStates = 0;
+    // Only store hashes of visited states. Collisions may hide states, so negative results become inexact.
+    bool hashCompaction = false;
+    // Number of explored states after which the first graph analysis for almost-sure queries is performed.
+    uint64_t graphCheckInterval = 1000;
+    // Compute a path to the state that decides the property.
+    bool buildTrace = true;
+};
+
+struct OnTheFlyResult {
+    // True iff the property was decided (false if the exploration bound was hit).
+    bool decided = false;
+    bool result = false;
+    // False iff hash compaction was used and the result relies on the absence of a state.
+    bool exact = true;
+    // True iff all reachable states were explored.
+    bool complete = false;
+    uint64_t exploredStates = 0;
+    uint64_t exploredTransitions = 0;
+    // Path from an initial state to the state deciding the property (if any).
+    std::vector<storm::expressions::SimpleValuation> trace;
+};
+
+/*!
+ * Checks qualitative reachability properties while exploring the state space of a PRISM program or JANI model.
+ * Supported are P>0 and P<=0 (existence of a path, maximizing for nondeterministic models) and P>=1 and P<1
+ * (almost-sure reachability, deterministic models only) of until, eventually and globally formulas.
+ * The exploration stops as soon as the property is decided.
+ */
+class OnTheFlyChecker {
+   public:
+    OnTheFlyChecker(storm::storage::SymbolicModelDescription const& modelDescription, storm::logic::Formula const& formula, OnTheFlyOptions const& options)
+        : options(options) {
+        storm::builder::BuilderOptions builderOptions(false, false);
+        std::map<std::string, storm::expressions::Expression> labels;
+        storm::expressions::ExpressionManager const* manager;
+        if (modelDescription.isPrismProgram()) {
+            generator = std::make_unique<storm::generator::PrismNextStateGenerator<double, uint32_t>>(modelDescription.asPrismProgram(), builderOptions);
+            labels = modelDescription.asPrismProgram().getLabelToExpressionMapping();
+            manager = &modelDescription.asPrismProgram().getManager();
+        } else {
+            STORM_LOG_THROW(modelDescription.isJaniModel(), storm::exceptions::NotSupportedException, "On-the-fly checking requires a PRISM program or JANI model.");
+            generator = std::make_unique<storm::generator::JaniNextStateGenerator<double, uint32_t>>(modelDescription.asJaniModel(), builderOptions);
+            manager = &modelDescription.asJaniModel().getManager();
+        }
+        analyzeFormula(formula, *manager, labels);
+    }
+
+    OnTheFlyResult check() {
+        OnTheFlyResult result;
+        storm::storage::BitVectorHashMap<uint32_t> stateToId(generator->getVariableInformation().getTotalBitOffset(true));
+        std::unordered_set<std::size_t> visitedHashes;
+        std::deque<std::pair<CompressedState, uint32_t>> queue;
+        uint32_t const noParent = std::numeric_limits<uint32_t>::max();
+
+        // Returns the index of the state; with hash compaction, revisited states are not indexed
+        auto visit = [&](CompressedState const& state, uint32_t parent) {
+            uint32_t id;
+            if (options.hashCompaction) {
+                if (!visitedHashes.insert(std::hash<CompressedState>()(state)).second) {
+                    return noParent;
+                }
+                id = static_cast<uint32_t>(visitedHashes.size() - 1);
+            } else {
+                id = static_cast<uint32_t>(states.size());
+                if (stateToId.findOrAdd(state, id) != id) {
+                    return stateToId.getValue(state);
+                }
+                states.push_back(state);
+                parents.push_back(parent);
+                if (almostSure) {
+                    successors.emplace_back();
+                    expanded.push_back(false);
+                }
+            }
+            queue.emplace_back(state, id);
+            return id;
+        };
+
+        generator->getInitialStates([&](CompressedState const& s) { return visit(s, noParent); });
+        uint64_t nextGraphCheck = std::max<uint64_t>(1, options.graphCheckInterval);
+        while (!queue.empty()) {
+            if (options.maxStates > 0 && result.exploredStates >= options.maxStates) {
+                return result;
+            }
+            auto current = std::move(queue.front());
+            queue.pop_front();
+            ++result.exploredStates;
+            generator->load(current.first);
+
+            bool isTarget = generator->satisfies(target);
+            if (isTarget || !generator->satisfies(constraint)) {
+                if (isTarget && !almostSure) {
+                    // A path to the target exists
+                    return decide(result, true, current.second);
+                }
+                if (!isTarget && almostSure) {
+                    // States violating the constraint have probability zero
+                    return decide(result, false, current.second);
+                }
+                continue;
+            }
+
+            auto behavior = generator->expand([&](CompressedState const& s) { return visit(s, current.second); });
+            if (behavior.empty() && almostSure) {
+                // Deadlocks are fixed by self-loops and never reach the target
+                return decide(result, false, current.second);
+            }
+            for (auto const& choice : behavior) {
+                for (auto const& entry : choice) {
+                    ++result.exploredTransitions;
+                    if (almostSure) {
+                        successors[current.second].push_back(entry.first);
+                    }
+                }
+            }
+            if (almostSure) {
+                expanded[current.second] = true;
+                if (result.exploredStates >= nextGraphCheck) {
+                    // Double the interval to keep the overall effort linear in the number of states
+                    nextGraphCheck *= 2;
+                    if (auto witness = findProbabilityZeroState()) {
+                        return decide(result, false, *witness);
+                    }
+                }
+            }
+        }
+
+        result.complete = true;
+        if (almostSure) {
+            if (auto witness = findProbabilityZeroState()) {
+                return decide(result, false, *witness);
+            }
+            return decide(result, true, noParent);
+        }
+        // No path to the target exists; with hash compaction, states might have been skipped due to collisions
+        result.exact = !options.hashCompaction;
+        return decide(result, false, noParent);
+    }
+
+   private:
+    /*!
+     * Translate the formula into constraint/target expressions and the kind of query.
+     */
+    void analyzeFormula(storm::logic::Formula const& formula, storm::expressions::ExpressionManager const& manager, std::map<std::string, storm::expressions::Expression> const& labels) {
+        STORM_LOG_THROW(formula.isProbabilityOperatorFormula() && formula.asProbabilityOperatorFormula().hasBound(), storm::exceptions::NotSupportedException,
+                        "On-the-fly checking requires a probability operator with a bound, got " << formula << ".");
+        auto const& operatorFormula = formula.asProbabilityOperatorFormula();
+        auto const& subformula = operatorFormula.getSubformula();
+        storm::logic::ComparisonType comparison = operatorFormula.getBound().comparisonType;
+        double threshold = operatorFormula.getThresholdAs<double>();
+        bool globally = false;
+        if (subformula.isEventuallyFormula()) {
+            constraint = manager.boolean(true);
+            target = subformula.asEventuallyFormula().getSubformula().toExpression(manager, labels);
+        } else if (subformula.isUntilFormula()) {
+            constraint = subformula.asUntilFormula().getLeftSubformula().toExpression(manager, labels);
+            target = subformula.asUntilFormula().getRightSubformula().toExpression(manager, labels);
+        } else if (subformula.isGloballyFormula()) {
+            // P~b [G phi] iff P~' 1-b [F !phi] where ~' is ~ in the opposite direction, e.g., >= becomes <=
+            globally = true;
+            constraint = manager.boolean(true);
+            target = !subformula.asGloballyFormula().getSubformula().toExpression(manager, labels);
+            threshold = 1 - threshold;
+            comparison = storm::logic::invertPreserveStrictness(comparison);
+        } else {
+            STORM_LOG_THROW(false, storm::exceptions::NotSupportedException, "Unsupported path formula " << subformula << " for on-the-fly checking.");
+        }
+
+        bool maximize = true;
+        if (!generator->isDeterministicModel()) {
+            if (operatorFormula.hasOptimalityType()) {
+                maximize = storm::solver::maximize(operatorFormula.getOptimalityType()) != globally;
+            } else {
+                // Bounds quantify over all schedulers, i.e., lower bounds minimize and upper bounds maximize
+                maximize = !storm::logic::isLowerBound(comparison);
+            }
+        }
+
+        if (threshold == 0 && (comparison == storm::logic::ComparisonType::Greater || comparison == storm::logic::ComparisonType::LessEqual)) {
+            almostSure = false;
+            negate = comparison == storm::logic::ComparisonType::LessEqual;
+            STORM_LOG_THROW(maximize, storm::exceptions::NotSupportedException, "Qualitative queries for minimizing schedulers are not supported on-the-fly.");
+        } else if (threshold == 1 && (comparison == storm::logic::ComparisonType::GreaterEqual || comparison == storm::logic::ComparisonType::Less)) {
+            almostSure = true;
+            negate = comparison == storm::logic::ComparisonType::Less;
+            STORM_LOG_THROW(generator->isDeterministicModel(), storm::exceptions::NotSupportedException, "Almost-sure reachability is only supported on-the-fly for deterministic models.");
+            STORM_LOG_THROW(!options.hashCompaction, storm::exceptions::NotSupportedException, "Almost-sure reachability requires the explored graph and cannot be used with hash compaction.");
+        } else {
+            STORM_LOG_THROW(false, storm::exceptions::NotSupportedException, "Only qualitative bounds (>0, <=0, >=1, <1) are supported on-the-fly.");
+        }
+    }
+
+    /*!
+     * Backward search from the target states and the unexplored frontier in the explored graph.
+     * An expanded state that reaches neither has probability zero to reach the target.
+     */
+    boost::optional<uint32_t> findProbabilityZeroState() const {
+        uint64_t numberOfStates = states.size();
+        std::vector<std::vector<uint32_t>> predecessors(numberOfStates);
+        for (uint32_t state = 0; state < numberOfStates; ++state) {
+            for (uint32_t successor : successors[state]) {
+                predecessors[successor].push_back(state);
+            }
+        }
+        std::vector<bool> reaches(numberOfStates, false);
+        std::vector<uint32_t> stack;
+        for (uint32_t state = 0; state < numberOfStates; ++state) {
+            // Unexpanded states are either targets or not explored yet
+            if (!expanded[state]) {
+                reaches[state] = true;
+                stack.push_back(state);
+            }
+        }
+        while (!stack.empty()) {
+            uint32_t state = stack.back();
+            stack.pop_back();
+            for (uint32_t predecessor : predecessors[state]) {
+                if (!reaches[predecessor]) {
+                    reaches[predecessor] = true;
+                    stack.push_back(predecessor);
+                }
+            }
+        }
+        for (uint32_t state = 0; state < numberOfStates; ++state) {
+            if (!reaches[state]) {
+                return state;
+            }
+        }
+        return boost::none;
+    }
+
+    OnTheFlyResult& decide(OnTheFlyResult& result, bool found, uint32_t state) const {
+        result.decided = true;
+        result.result = found != negate;
+        if (options.buildTrace && !options.hashCompaction && state != std::numeric_limits<uint32_t>::max()) {
+            for (uint32_t current = state; current != std::numeric_limits<uint32_t>::max(); current = parents[current]) {
+                result.trace.push_back(generator->toValuation(states[current]));
+            }
+            std::reverse(result.trace.begin(), result.trace.end());
+        }
+        return result;
+    }
+
+    OnTheFlyOptions options;
+    std::unique_ptr<storm::generator::NextStateGenerator<double, uint32_t>> generator;
+    storm::expressions::Expression constraint;
+    storm::expressions::Expression target;
+    bool almostSure = false;
+    // True iff the property holds iff the query is not satisfied
+    bool negate = false;
+
+    // Explored graph (not stored with hash compaction)
+    std::vector<CompressedState> states;
+    std::vector<uint32_t> parents;
+    std::vector<std::vector<uint32_t>> successors;
+    std::vector<bool> expanded;
+};
+
+OnTheFlyResult checkOnTheFly(storm::storage::SymbolicModelDescription const& modelDescription, std::shared_ptr<storm::logic::Formula const> const& formula, OnTheFlyOptions const& options) {
+    OnTheFlyChecker checker(modelDescription, *formula, options);
+    return checker.check();
+}
+
+void define_on_the_fly(py::module& m) {
+    py::class_<OnTheFlyOptions>(m, "OnTheFlyOptions", "Options for on-the-fly checking")
+        .def(py::init<>())
+        .def_readwrite("max_states", &OnTheFlyOptions::maxStates, "Maximal number of explored states (0 for no bound)")
+        .def_readwrite("hash_compaction", &OnTheFlyOptions::hashCompaction, "Only store hashes of visited states to bound the memory. Negative answers of existential queries become inexact.")
+        .def_readwrite("graph_check_interval", &OnTheFlyOptions::graphCheckInterval, "Number of explored states before the first graph analysis for almost-sure queries, doubled after each analysis")
+        .def_readwrite("build_trace", &OnTheFlyOptions::buildTrace, "Compute a path to the state deciding the property")
+    ;
+
+    py::class_<OnTheFlyResult>(m, "OnTheFlyResult", "Result of on-the-fly checking")
+        .def_readonly("decided", &OnTheFlyResult::decided, "True iff the property was decided before reaching the exploration bound")
+        .def_readonly("result", &OnTheFlyResult::result, "Truth value of the property (if decided)")
+        .def_readonly("exact", &OnTheFlyResult::exact, "False iff hash collisions might have influenced the result")
+        .def_readonly("complete", &OnTheFlyResult::complete, "True iff all reachable states were explored")
+        .def_readonly("explored_states", &OnTheFlyResult::exploredStates, "Number of explored states")
+        .def_readonly("explored_transitions", &OnTheFlyResult::exploredTransitions, "Number of explored transitions")
+        .def_readonly("trace", &OnTheFlyResult::trace, "Path from an initial state to the state deciding the property, given as state valuations")
+        .def("__str__", [](OnTheFlyResult const& result) {
+            std::stringstream stream;
+            stream << (result.decided ? (result.result ? "true" : "false") : "undecided") << " (" << result.exploredStates << " states explored)";
+            return stream.str();
+        })
+    ;
+
+    m.def("_check_on_the_fly", &checkOnTheFly, "Check a qualitative reachability property while exploring the state space", py::arg("model_description"), py::arg("formula"), py::arg("options") = OnTheFlyOptions(), py::call_guard<py::gil_scoped_release>());
+}
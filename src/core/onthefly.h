@@ -0,0 +1,5 @@
+#pragma once
+
+#include "common.h"
+
+void define_on_the_fly(py::module& m);
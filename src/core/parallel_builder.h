@@ -0,0 +1,326 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <set>
+#include <unordered_map>
+
+#include "src/parallel.h"
+
+#include "storm/builder/BuilderOptions.h"
+#include "storm/builder/ExplorationOrder.h"
+#include "storm/builder/RewardModelBuilder.h"
+#include "storm/generator/JaniNextStateGenerator.h"
+#include "storm/generator/PrismNextStateGenerator.h"
+#include "storm/models/sparse/ChoiceLabeling.h"
+#include "storm/models/sparse/StandardRewardModel.h"
+#include "storm/settings/SettingsManager.h"
+#include "storm/settings/modules/BuildSettings.h"
+#include "storm/storage/SparseMatrix.h"
+#include "storm/storage/SymbolicModelDescription.h"
+#include "storm/storage/sparse/ModelComponents.h"
+#include "storm/storage/sparse/StateStorage.h"
+#include "storm/storage/sparse/StateValuations.h"
+#include "storm/utility/builder.h"
+#include "storm/exceptions/WrongFormatException.h"
+
+/*!
+ * Builder options extended by the number of threads used for the explicit state exploration.
+ * The default of one thread keeps the sequential builder of Storm.
+ */
+class ParallelBuilderOptions : public storm::builder::BuilderOptions {
+   public:
+    using storm::builder::BuilderOptions::BuilderOptions;
+
+    ParallelBuilderOptions& setExplorationThreads(uint64_t numberOfThreads) {
+        explorationThreads = numberOfThreads;
+        return *this;
+    }
+
+    uint64_t getExplorationThreads() const {
+        return explorationThreads;
+    }
+
+   private:
+    // 0 means 'use all hardware threads'
+    uint64_t explorationThreads = 1;
+};
+
+/*!
+ * Explicit state builder exploring the states of a PRISM program or JANI model with multiple threads.
+ * States are explored layer by layer in breadth-first order. The successors of a layer are computed in parallel,
+ * each thread using its own next-state generator and local state indices. Afterwards, the states are numbered
+ * sequentially in the order of the layer, which yields the same state ordering as the sequential builder.
+ */
+template<typename ValueType>
+class ParallelExplicitModelBuilder {
+   public:
+    typedef uint32_t StateType;
+    typedef storm::generator::NextStateGenerator<ValueType, StateType> Generator;
+    typedef storm::generator::CompressedState CompressedState;
+
+    /*!
+     * @param actionMask If given, the mask is queried by all threads concurrently and must therefore be thread-safe.
+     */
+    ParallelExplicitModelBuilder(storm::storage::SymbolicModelDescription const& modelDescription, ParallelBuilderOptions const& options,
+                                 std::shared_ptr<storm::generator::ActionMask<ValueType, StateType>> const& actionMask = nullptr)
+        : modelDescription(modelDescription), options(options), numberOfThreads(resolveNumberOfThreads(options.getExplorationThreads())), actionMask(actionMask) {
+        for (uint64_t thread = 0; thread < numberOfThreads; ++thread) {
+            generators.push_back(createGenerator());
+        }
+    }
+
+    /*!
+     * Check whether the parallel exploration supports the given options and description.
+     * Unsupported features are handled by the sequential builder.
+     */
+    static bool isSupported(storm::storage::SymbolicModelDescription const& modelDescription, storm::builder::BuilderOptions const& options, bool hasActionMask = false) {
+        if (!modelDescription.isPrismProgram() && !modelDescription.isJaniModel()) {
+            return false;
+        }
+        // Only the PRISM generator supports action masks
+        if (hasActionMask && !modelDescription.isPrismProgram()) {
+            return false;
+        }
+        // Observations of POMDPs and players of games are not built by the parallel exploration
+        if (modelDescription.isPrismProgram()) {
+            auto modelType = modelDescription.asPrismProgram().getModelType();
+            if (modelType != storm::prism::Program::ModelType::DTMC && modelType != storm::prism::Program::ModelType::CTMC &&
+                modelType != storm::prism::Program::ModelType::MDP && modelType != storm::prism::Program::ModelType::MA) {
+                return false;
+            }
+        } else {
+            auto modelType = modelDescription.asJaniModel().getModelType();
+            if (modelType != storm::jani::ModelType::DTMC && modelType != storm::jani::ModelType::CTMC && modelType != storm::jani::ModelType::MDP &&
+                modelType != storm::jani::ModelType::MA) {
+                return false;
+            }
+        }
+        if (options.isBuildChoiceOriginsSet() || options.isBuildObservationValuationsSet() || options.isAddOutOfBoundsStateSet() || options.hasTerminalStates()) {
+            return false;
+        }
+        return storm::settings::getModule<storm::settings::modules::BuildSettings>().getExplorationOrder() == storm::builder::ExplorationOrder::Bfs;
+    }
+
+    std::shared_ptr<storm::models::sparse::Model<ValueType>> build() {
+        Generator& generator = *generators.front();
+        auto modelType = generator.getModelType();
+        STORM_LOG_THROW(modelType != storm::generator::ModelType::POMDP && modelType != storm::generator::ModelType::SMG, storm::exceptions::WrongFormatException,
+                        "The parallel exploration does not support partially observable models and games.");
+        bool deterministic = generator.isDeterministicModel();
+        bool markovAutomaton = modelType == storm::generator::ModelType::MA;
+
+        storm::storage::sparse::StateStorage<StateType> stateStorage(generator.getVariableInformation().getTotalBitOffset(true));
+        std::vector<CompressedState> states;
+        auto findOrAdd = [&](CompressedState const& state) -> StateType {
+            StateType newIndex = static_cast<StateType>(states.size());
+            StateType actualIndex = stateStorage.stateToId.findOrAdd(state, newIndex);
+            if (actualIndex == newIndex) {
+                states.push_back(state);
+            }
+            return actualIndex;
+        };
+        stateStorage.initialStateIndices = generator.getInitialStates(findOrAdd);
+        STORM_LOG_THROW(!stateStorage.initialStateIndices.empty(), storm::exceptions::WrongFormatException, "The model does not have a single initial state.");
+
+        std::vector<storm::builder::RewardModelBuilder<ValueType>> rewardModelBuilders;
+        for (uint64_t i = 0; i < generator.getNumberOfRewardModels(); ++i) {
+            rewardModelBuilders.emplace_back(generator.getRewardModelInformation(i));
+        }
+        storm::storage::SparseMatrixBuilder<ValueType> matrixBuilder(0, 0, 0, false, !deterministic, 0);
+        std::map<std::string, std::vector<uint64_t>> choiceLabels;
+        std::vector<uint64_t> markovianStates;
+        bool fixDeadlocks = !storm::settings::getModule<storm::settings::modules::BuildSettings>().isDontFixDeadlocksSet();
+        uint64_t currentRow = 0;
+
+        uint64_t layerBegin = 0;
+        while (layerBegin < states.size()) {
+            uint64_t layerEnd = states.size();
+            std::vector<ExpandedState> layer(layerEnd - layerBegin);
+            expandLayer(states, layerBegin, layerEnd, layer);
+
+            for (uint64_t state = layerBegin; state < layerEnd; ++state) {
+                ExpandedState& expanded = layer[state - layerBegin];
+                // Number the successors in the order in which the sequential builder encounters them
+                std::vector<StateType> successorIndices;
+                successorIndices.reserve(expanded.successors.size());
+                for (auto const& successor : expanded.successors) {
+                    successorIndices.push_back(findOrAdd(successor));
+                }
+
+                if (!deterministic) {
+                    matrixBuilder.newRowGroup(currentRow);
+                }
+                if (expanded.choices.empty()) {
+                    STORM_LOG_THROW(fixDeadlocks, storm::exceptions::WrongFormatException,
+                                    "Error while creating sparse matrix from probabilistic program: found deadlock state (" << generator.toValuation(states[state]).toString(true) << ").");
+                    stateStorage.deadlockStateIndices.push_back(state);
+                    if (markovAutomaton) {
+                        markovianStates.push_back(state);
+                    }
+                    matrixBuilder.addNextValue(currentRow, state, storm::utility::one<ValueType>());
+                    for (auto& rewardModelBuilder : rewardModelBuilders) {
+                        if (rewardModelBuilder.hasStateRewards()) {
+                            rewardModelBuilder.addStateReward(storm::utility::zero<ValueType>());
+                        }
+                        if (rewardModelBuilder.hasStateActionRewards()) {
+                            rewardModelBuilder.addStateActionReward(storm::utility::zero<ValueType>());
+                        }
+                    }
+                    ++currentRow;
+                    continue;
+                }
+
+                auto stateRewardIt = expanded.stateRewards.begin();
+                for (auto& rewardModelBuilder : rewardModelBuilders) {
+                    if (rewardModelBuilder.hasStateRewards()) {
+                        rewardModelBuilder.addStateReward(*stateRewardIt);
+                    }
+                    ++stateRewardIt;
+                }
+                bool markovianAdded = false;
+                for (auto& choice : expanded.choices) {
+                    for (auto const& label : choice.labels) {
+                        choiceLabels[label].push_back(currentRow);
+                    }
+                    if (markovAutomaton && choice.markovian && !markovianAdded) {
+                        markovianStates.push_back(state);
+                        markovianAdded = true;
+                    }
+                    for (auto& entry : choice.entries) {
+                        entry.first = successorIndices[entry.first];
+                    }
+                    std::sort(choice.entries.begin(), choice.entries.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+                    for (auto const& entry : choice.entries) {
+                        matrixBuilder.addNextValue(currentRow, entry.first, entry.second);
+                    }
+                    auto choiceRewardIt = choice.rewards.begin();
+                    for (auto& rewardModelBuilder : rewardModelBuilders) {
+                        if (rewardModelBuilder.hasStateActionRewards()) {
+                            rewardModelBuilder.addStateActionReward(*choiceRewardIt);
+                        }
+                        ++choiceRewardIt;
+                    }
+                    ++currentRow;
+                }
+            }
+            layerBegin = layerEnd;
+        }
+
+        uint64_t numberOfStates = states.size();
+        storm::storage::sparse::ModelComponents<ValueType> components(matrixBuilder.build(currentRow, numberOfStates, deterministic ? 0 : numberOfStates));
+        components.rateTransitions = !generator.isDiscreteTimeModel();
+        for (auto& rewardModelBuilder : rewardModelBuilders) {
+            components.rewardModels.emplace(rewardModelBuilder.getName(),
+                                            rewardModelBuilder.build(components.transitionMatrix.getRowCount(), components.transitionMatrix.getColumnCount(),
+                                                                     components.transitionMatrix.getRowGroupCount()));
+        }
+        components.stateLabeling = generator.label(stateStorage, stateStorage.initialStateIndices, stateStorage.deadlockStateIndices);
+        if (options.isBuildChoiceLabelsSet()) {
+            storm::models::sparse::ChoiceLabeling choiceLabeling(currentRow);
+            for (auto const& entry : choiceLabels) {
+                choiceLabeling.addLabel(entry.first, storm::storage::BitVector(currentRow, entry.second));
+            }
+            components.choiceLabeling = std::move(choiceLabeling);
+        }
+        if (markovAutomaton) {
+            components.markovianStates = storm::storage::BitVector(numberOfStates, markovianStates);
+        }
+        if (options.isBuildStateValuationsSet()) {
+            auto valuationsBuilder = generator.initializeStateValuationsBuilder();
+            for (uint64_t state = 0; state < numberOfStates; ++state) {
+                generator.load(states[state]);
+                generator.addStateValuation(state, valuationsBuilder);
+            }
+            components.stateValuations = valuationsBuilder.build(numberOfStates);
+        }
+        return storm::utility::builder::buildModelFromComponents(getModelType(modelType), std::move(components));
+    }
+
+   private:
+    struct ExpandedChoice {
+        // Successors are given by their index in ExpandedState::successors
+        std::vector<std::pair<StateType, ValueType>> entries;
+        std::vector<ValueType> rewards;
+        std::set<std::string> labels;
+        bool markovian = false;
+    };
+
+    struct ExpandedState {
+        std::vector<ExpandedChoice> choices;
+        std::vector<ValueType> stateRewards;
+        // Distinct successors in the order of their first occurrence
+        std::vector<CompressedState> successors;
+    };
+
+    std::unique_ptr<Generator> createGenerator() const {
+        if (modelDescription.isPrismProgram()) {
+            return std::make_unique<storm::generator::PrismNextStateGenerator<ValueType, StateType>>(modelDescription.asPrismProgram(), options, actionMask);
+        } else {
+            return std::make_unique<storm::generator::JaniNextStateGenerator<ValueType, StateType>>(modelDescription.asJaniModel(), options);
+        }
+    }
+
+    /*!
+     * Expand the states in [begin, end). Threads fetch blocks of states dynamically to balance uneven expansion costs.
+     */
+    void expandLayer(std::vector<CompressedState> const& states, uint64_t begin, uint64_t end, std::vector<ExpandedState>& layer) {
+        uint64_t const blockSize = 64;
+        std::atomic<uint64_t> nextBlock(begin);
+        parallelFor(0, numberOfThreads, numberOfThreads, [&](uint64_t thread) {
+            Generator& generator = *generators[thread];
+            std::unordered_map<CompressedState, StateType> localIndices;
+            for (uint64_t blockBegin = nextBlock.fetch_add(blockSize); blockBegin < end; blockBegin = nextBlock.fetch_add(blockSize)) {
+                for (uint64_t state = blockBegin; state < std::min(end, blockBegin + blockSize); ++state) {
+                    ExpandedState& expanded = layer[state - begin];
+                    localIndices.clear();
+                    auto toLocalIndex = [&](CompressedState const& successor) -> StateType {
+                        auto result = localIndices.emplace(successor, static_cast<StateType>(expanded.successors.size()));
+                        if (result.second) {
+                            expanded.successors.push_back(successor);
+                        }
+                        return result.first->second;
+                    };
+                    generator.load(states[state]);
+                    auto behavior = generator.expand(toLocalIndex);
+                    if (behavior.empty()) {
+                        continue;
+                    }
+                    expanded.stateRewards = behavior.getStateRewards();
+                    for (auto const& choice : behavior) {
+                        ExpandedChoice expandedChoice;
+                        expandedChoice.entries.assign(choice.begin(), choice.end());
+                        expandedChoice.rewards = choice.getRewards();
+                        expandedChoice.markovian = choice.isMarkovian();
+                        if (options.isBuildChoiceLabelsSet() && choice.hasLabels()) {
+                            expandedChoice.labels = choice.getLabels();
+                        }
+                        expanded.choices.push_back(std::move(expandedChoice));
+                    }
+                }
+            }
+        });
+    }
+
+    static storm::models::ModelType getModelType(storm::generator::ModelType modelType) {
+        switch (modelType) {
+            case storm::generator::ModelType::DTMC:
+                return storm::models::ModelType::Dtmc;
+            case storm::generator::ModelType::CTMC:
+                return storm::models::ModelType::Ctmc;
+            case storm::generator::ModelType::MDP:
+                return storm::models::ModelType::Mdp;
+            case storm::generator::ModelType::MA:
+                return storm::models::ModelType::MarkovAutomaton;
+            default:
+                STORM_LOG_THROW(false, storm::exceptions::WrongFormatException, "Unsupported model type.");
+        }
+    }
+
+    storm::storage::SymbolicModelDescription const& modelDescription;
+    ParallelBuilderOptions const& options;
+    uint64_t numberOfThreads;
+    std::shared_ptr<storm::generator::ActionMask<ValueType, StateType>> actionMask;
+    std::vector<std::unique_ptr<Generator>> generators;
+};
@@ -0,0 +1,286 @@
+#include "pareto.h"
+#include "src/parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <set>
+
+#include <pybind11/numpy.h>
+
+#include "storm/environment/Environment.h"
+#include "storm/logic/Formulas.h"
+#include "storm/models/sparse/MarkovAutomaton.h"
+#include "storm/models/sparse/Mdp.h"
+#include "storm/modelchecker/multiobjective/pcaa/PcaaWeightVectorChecker.h"
+#include "storm/modelchecker/multiobjective/preprocessing/SparseMultiObjectivePreprocessor.h"
+#include "storm/solver/OptimizationDirection.h"
+#include "storm/storage/geometry/Halfspace.h"
+#include "storm/storage/geometry/Polytope.h"
+#include "storm/utility/constants.h"
+#include "storm/utility/vector.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+#include "storm/exceptions/NotSupportedException.h"
+
+struct ParetoExplorationOptions {
+    double precision = 1e-4;
+    uint64_t numberOfThreads = 0;
+    // Budgets, 0 for no limit
+    double timeLimit = 0;
+    uint64_t maximalNumberOfQueries = 0;
+};
+
+/*!
+ * Result of a Pareto exploration. Points and approximations refer to the objectives of the original formula.
+ */
+struct ParetoExplorationResult {
+    std::shared_ptr<storm::storage::geometry::Polytope<double>> underApproximation;
+    std::shared_ptr<storm::storage::geometry::Polytope<double>> overApproximation;
+    // Achievable point found for each weight vector
+    std::vector<std::vector<double>> points;
+    std::vector<std::vector<double>> weightVectors;
+    uint64_t rounds = 0;
+    // Largest remaining distance between under- and over-approximation in the direction of a facet of the under-approximation
+    double gap = std::numeric_limits<double>::infinity();
+    bool converged = false;
+    double seconds = 0;
+};
+
+namespace {
+    using GeometryValueType = storm::RationalNumber;
+    using Point = std::vector<GeometryValueType>;
+    using Polytope = storm::storage::geometry::Polytope<GeometryValueType>;
+
+    /*!
+     * Approximates the Pareto curve of a multi-objective query by weighted-sum queries, like the Pareto query of Storm.
+     * Each round checks a batch of weight vectors in parallel: the normals of the facets of the under-approximation with the largest distance
+     * to the over-approximation. Every thread keeps its weight vector checker, so the preprocessing of the checker is done once per thread.
+     * As in Storm, all objectives are maximized internally, the values of minimizing objectives are negated.
+     */
+    template<typename SparseModelType>
+    class ParetoExplorer {
+       public:
+        using ValueType = typename SparseModelType::ValueType;
+        using Preprocessor = storm::modelchecker::multiobjective::preprocessing::SparseMultiObjectivePreprocessor<SparseModelType>;
+        using PreprocessorResult = storm::modelchecker::multiobjective::preprocessing::SparseMultiObjectivePreprocessorResult<SparseModelType>;
+        using Checker = storm::modelchecker::multiobjective::PcaaWeightVectorChecker<SparseModelType>;
+
+        ParetoExplorer(storm::Environment const& env, SparseModelType const& model, storm::logic::MultiObjectiveFormula const& formula, ParetoExplorationOptions const& options)
+            : env(env), options(options), preprocessorResult(Preprocessor::preprocess(env, model, formula)) {
+            STORM_LOG_THROW(preprocessorResult.queryType == PreprocessorResult::QueryType::Pareto, storm::exceptions::NotSupportedException,
+                            "Only Pareto queries are supported, i.e. all objectives have to be of the form '=?'.");
+            STORM_LOG_THROW(options.precision > 0, storm::exceptions::InvalidArgumentException, "The precision has to be positive.");
+            numberOfObjectives = preprocessorResult.objectives.size();
+            checkers.resize(resolveNumberOfThreads(options.numberOfThreads));
+            overApproximation = Polytope::createUniversalPolytope();
+        }
+
+        ParetoExplorationResult explore() {
+            auto start = std::chrono::steady_clock::now();
+            ParetoExplorationResult result;
+            // Start with the optimum of each single objective
+            std::vector<Point> batch;
+            for (uint64_t objective = 0; objective < numberOfObjectives; ++objective) {
+                Point weightVector(numberOfObjectives, storm::utility::zero<GeometryValueType>());
+                weightVector[objective] = storm::utility::one<GeometryValueType>();
+                batch.push_back(std::move(weightVector));
+            }
+            if (options.maximalNumberOfQueries > 0) {
+                batch.resize(std::min<uint64_t>(batch.size(), options.maximalNumberOfQueries));
+            }
+            uint64_t queries = 0;
+            while (!batch.empty()) {
+                ++result.rounds;
+                queries += batch.size();
+                check(batch);
+                underApproximation = Polytope::create(points)->downwardClosure();
+                batch = selectWeightVectors(result.gap);
+                if (batch.empty()) {
+                    result.converged = true;
+                    break;
+                }
+                if (options.timeLimit > 0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= options.timeLimit) {
+                    break;
+                }
+                if (options.maximalNumberOfQueries > 0) {
+                    batch.resize(std::min<uint64_t>(batch.size(), options.maximalNumberOfQueries - std::min(queries, options.maximalNumberOfQueries)));
+                }
+            }
+
+            std::vector<Point> matrix;
+            Point offset;
+            getTransformationToOriginal(matrix, offset);
+            for (Point const& point : points) {
+                std::vector<double> original(numberOfObjectives);
+                for (uint64_t objective = 0; objective < numberOfObjectives; ++objective) {
+                    original[objective] = storm::utility::convertNumber<double>(matrix[objective][objective] * point[objective] + offset[objective]);
+                }
+                result.points.push_back(std::move(original));
+            }
+            for (Point const& weightVector : weightVectors) {
+                result.weightVectors.push_back(storm::utility::vector::convertNumericVector<double>(weightVector));
+            }
+            result.underApproximation = underApproximation->affineTransformation(matrix, offset)->template convertNumberRepresentation<double>();
+            result.overApproximation = overApproximation->affineTransformation(matrix, offset)->template convertNumberRepresentation<double>();
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return result;
+        }
+
+       private:
+        struct Step {
+            Point lowerBound;
+            Point upperBound;
+        };
+
+        void check(std::vector<Point> const& batch) {
+            std::vector<Step> steps(batch.size());
+            std::atomic<uint64_t> next(0);
+            uint64_t numberOfThreads = std::min<uint64_t>(checkers.size(), batch.size());
+            parallelFor(0, numberOfThreads, numberOfThreads, [&](uint64_t thread) {
+                storm::Environment threadEnvironment(env);
+                if (!checkers[thread]) {
+                    checkers[thread] = storm::modelchecker::multiobjective::WeightVectorCheckerFactory<SparseModelType>::create(preprocessorResult);
+                    checkers[thread]->setWeightedPrecision(storm::utility::convertNumber<ValueType>(options.precision / 2));
+                }
+                Checker& checker = *checkers[thread];
+                for (uint64_t index = next++; index < batch.size(); index = next++) {
+                    checker.check(threadEnvironment, storm::utility::vector::convertNumericVector<ValueType>(batch[index]));
+                    steps[index].lowerBound = storm::utility::vector::convertNumericVector<GeometryValueType>(checker.getUnderApproximationOfInitialStateResults());
+                    steps[index].upperBound = storm::utility::vector::convertNumericVector<GeometryValueType>(checker.getOverApproximationOfInitialStateResults());
+                    for (uint64_t objective = 0; objective < numberOfObjectives; ++objective) {
+                        if (storm::solver::minimize(preprocessorResult.objectives[objective].formula->getOptimalityType())) {
+                            steps[index].lowerBound[objective] = -steps[index].lowerBound[objective];
+                            steps[index].upperBound[objective] = -steps[index].upperBound[objective];
+                        }
+                    }
+                }
+            });
+
+            for (uint64_t index = 0; index < batch.size(); ++index) {
+                queriedWeightVectors.insert(batch[index]);
+                weightVectors.push_back(batch[index]);
+                points.push_back(std::move(steps[index].lowerBound));
+                GeometryValueType bound = storm::utility::vector::dotProduct(batch[index], steps[index].upperBound);
+                overApproximation = overApproximation->intersection(storm::storage::geometry::Halfspace<GeometryValueType>(batch[index], bound));
+            }
+        }
+
+        // Normals of facets of the under-approximation that are further away from the over-approximation than the precision, largest distance first
+        std::vector<Point> selectWeightVectors(double& largestGap) const {
+            std::vector<std::pair<double, Point>> candidates;
+            largestGap = 0;
+            for (auto const& halfspace : underApproximation->getHalfspaces()) {
+                Point weightVector = halfspace.normalVector();
+                GeometryValueType sum = storm::utility::zero<GeometryValueType>();
+                bool nonNegative = true;
+                for (auto const& weight : weightVector) {
+                    nonNegative &= weight >= storm::utility::zero<GeometryValueType>();
+                    sum += weight;
+                }
+                // Facets of the downward closure with negative normals do not correspond to a weighted sum
+                if (!nonNegative || storm::utility::isZero(sum)) {
+                    continue;
+                }
+                for (auto& weight : weightVector) {
+                    weight /= sum;
+                }
+                if (queriedWeightVectors.count(weightVector) > 0) {
+                    continue;
+                }
+                auto optimum = overApproximation->optimize(weightVector);
+                double gap = optimum.second ? storm::utility::convertNumber<double>(storm::utility::vector::dotProduct(weightVector, optimum.first) - halfspace.offset() / sum)
+                                            : std::numeric_limits<double>::infinity();
+                largestGap = std::max(largestGap, gap);
+                if (gap > options.precision) {
+                    candidates.emplace_back(gap, std::move(weightVector));
+                }
+            }
+            std::sort(candidates.begin(), candidates.end(), [](auto const& first, auto const& second) { return first.first > second.first; });
+            std::vector<Point> batch;
+            for (uint64_t index = 0; index < std::min<uint64_t>(candidates.size(), checkers.size()); ++index) {
+                batch.push_back(std::move(candidates[index].second));
+            }
+            return batch;
+        }
+
+        // Undo the negation of minimizing objectives and the complement of objectives that consider the complementary event, see Storm's SparsePcaaQuery
+        void getTransformationToOriginal(std::vector<Point>& matrix, Point& offset) const {
+            matrix.assign(numberOfObjectives, Point(numberOfObjectives, storm::utility::zero<GeometryValueType>()));
+            offset.assign(numberOfObjectives, storm::utility::zero<GeometryValueType>());
+            for (uint64_t objective = 0; objective < numberOfObjectives; ++objective) {
+                auto const& objectiveInformation = preprocessorResult.objectives[objective];
+                bool maximize = storm::solver::maximize(objectiveInformation.formula->getOptimalityType());
+                bool complementary = objectiveInformation.considersComplementaryEvent;
+                matrix[objective][objective] = maximize != complementary ? storm::utility::one<GeometryValueType>() : -storm::utility::one<GeometryValueType>();
+                if (complementary) {
+                    offset[objective] = storm::utility::one<GeometryValueType>();
+                }
+            }
+        }
+
+        storm::Environment const& env;
+        ParetoExplorationOptions options;
+        PreprocessorResult preprocessorResult;
+        uint64_t numberOfObjectives;
+        std::vector<std::unique_ptr<Checker>> checkers;
+        std::set<Point> queriedWeightVectors;
+        std::vector<Point> weightVectors;
+        std::vector<Point> points;
+        std::shared_ptr<Polytope> underApproximation;
+        std::shared_ptr<Polytope> overApproximation;
+    };
+
+    template<typename SparseModelType>
+    ParetoExplorationResult exploreParetoCurve(storm::Environment const& env, SparseModelType const& model, storm::logic::MultiObjectiveFormula const& formula, ParetoExplorationOptions const& options) {
+        STORM_LOG_THROW(model.getInitialStates().getNumberOfSetBits() == 1, storm::exceptions::InvalidArgumentException, "Multi-objective model checking requires a single initial state.");
+        return ParetoExplorer<SparseModelType>(env, model, formula, options).explore();
+    }
+
+    py::array_t<double> toArray(std::vector<std::vector<double>> const& rows, uint64_t columns) {
+        py::array_t<double> array(std::vector<py::ssize_t>{static_cast<py::ssize_t>(rows.size()), static_cast<py::ssize_t>(columns)});
+        auto view = array.mutable_unchecked<2>();
+        for (uint64_t row = 0; row < rows.size(); ++row) {
+            for (uint64_t column = 0; column < columns; ++column) {
+                view(row, column) = rows[row][column];
+            }
+        }
+        return array;
+    }
+}
+
+void define_pareto_exploration(py::module& m) {
+    py::class_<ParetoExplorationOptions>(m, "ParetoExplorationOptions", "Options for the exploration of Pareto curves")
+        .def(py::init<>())
+        .def_readwrite("precision", &ParetoExplorationOptions::precision, "Stop once the approximations are closer than this in the direction of each facet, where weight vectors sum up to 1")
+        .def_readwrite("nr_threads", &ParetoExplorationOptions::numberOfThreads, "Number of threads and of weight vectors checked per round, 0 for the number of cores")
+        .def_readwrite("time_limit", &ParetoExplorationOptions::timeLimit, "Stop starting new rounds after this many seconds, 0 for no limit")
+        .def_readwrite("max_queries", &ParetoExplorationOptions::maximalNumberOfQueries, "Maximal number of weight vectors to check, 0 for no limit")
+    ;
+
+    py::class_<ParetoExplorationResult>(m, "ParetoExplorationResult", "Under- and over-approximation of a Pareto curve")
+        .def_readonly("under_approximation", &ParetoExplorationResult::underApproximation, "Under-approximation of the achievable points")
+        .def_readonly("over_approximation", &ParetoExplorationResult::overApproximation, "Over-approximation of the achievable points")
+        .def_property_readonly("points", [](ParetoExplorationResult const& result) {
+            return toArray(result.points, result.weightVectors.empty() ? 0 : result.weightVectors.front().size());
+        }, "Achievable point found for each weight vector as NumPy array with one row per point")
+        .def_property_readonly("weight_vectors", [](ParetoExplorationResult const& result) {
+            return toArray(result.weightVectors, result.weightVectors.empty() ? 0 : result.weightVectors.front().size());
+        }, "Checked weight vectors as NumPy array with one row per vector")
+        .def_property_readonly("nr_queries", [](ParetoExplorationResult const& result) { return result.weightVectors.size(); }, "Number of checked weight vectors")
+        .def_readonly("rounds", &ParetoExplorationResult::rounds, "Number of rounds of parallel queries")
+        .def_readonly("gap", &ParetoExplorationResult::gap, "Largest remaining distance between under- and over-approximation")
+        .def_readonly("converged", &ParetoExplorationResult::converged, "Whether the precision was reached before a budget was exhausted")
+        .def_readonly("seconds", &ParetoExplorationResult::seconds, "Wall time in seconds")
+    ;
+
+    m.def("_explore_pareto_curve_double", [](std::shared_ptr<storm::models::sparse::Model<double>> const& model, storm::logic::MultiObjectiveFormula const& formula, ParetoExplorationOptions const& options, storm::Environment const& env) -> ParetoExplorationResult {
+        if (model->isOfType(storm::models::ModelType::Mdp)) {
+            return exploreParetoCurve(env, *model->template as<storm::models::sparse::Mdp<double>>(), formula, options);
+        } else if (model->isOfType(storm::models::ModelType::MarkovAutomaton)) {
+            return exploreParetoCurve(env, *model->template as<storm::models::sparse::MarkovAutomaton<double>>(), formula, options);
+        }
+        STORM_LOG_THROW(false, storm::exceptions::NotSupportedException, "Only systems with nondeterminism are supported.");
+    }, py::arg("model"), py::arg("formula"), py::arg("options"), py::arg("environment") = storm::Environment(), py::call_guard<py::gil_scoped_release>(),
+       "Approximate the Pareto curve of a multi-objective formula with weighted-sum queries checked in parallel");
+}
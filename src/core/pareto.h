@@ -0,0 +1,5 @@
+#pragma once
+
+#include "common.h"
+
+void define_pareto_exploration(py::module& m);
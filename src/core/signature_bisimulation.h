@@ -0,0 +1,357 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+#include <boost/functional/hash.hpp>
+
+#include "src/parallel.h"
+
+#include "storm/logic/Formulas.h"
+#include "storm/models/sparse/Model.h"
+#include "storm/models/sparse/StandardRewardModel.h"
+#include "storm/storage/SparseMatrix.h"
+#include "storm/storage/sparse/ModelComponents.h"
+#include "storm/utility/builder.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+#include "storm/exceptions/NotSupportedException.h"
+
+/*!
+ * Statistics of one refinement round of the signature-based bisimulation.
+ */
+struct SignatureBisimulationRound {
+    uint64_t blocks = 0;
+    double seconds = 0;
+};
+
+struct SignatureBisimulationResult {
+    std::shared_ptr<storm::models::sparse::Model<double>> quotient;
+    // Block of each state of the original model, blocks are the states of the quotient
+    std::vector<uint64_t> stateToBlock;
+    std::vector<SignatureBisimulationRound> rounds;
+};
+
+/*!
+ * Strong bisimulation minimization of sparse DTMCs, CTMCs and MDPs by signature-based partition refinement.
+ * In each round, the signature of every state (its block together with the probabilities or rates of moving into each block,
+ * and for MDPs the set of such distributions over all choices) is computed in parallel. States are then regrouped by their
+ * signature until the number of blocks is stable. Blocks are numbered by their smallest state, so the result does not
+ * depend on the number of threads.
+ */
+class SignatureBisimulation {
+   public:
+    typedef std::vector<uint64_t> Signature;
+
+    /*!
+     * @param initialPartition If given, the block of each state from a previous run on a structurally identical model.
+     *                         Refinement starts from this partition (intersected with the labels and rewards), so the result is
+     *                         a bisimulation that refines it. If the previous partition is already stable, a single round suffices.
+     */
+    SignatureBisimulation(std::shared_ptr<storm::models::sparse::Model<double>> const& model,
+                          std::vector<std::shared_ptr<storm::logic::Formula const>> const& formulas, uint64_t numberOfThreads,
+                          boost::optional<std::vector<uint64_t>> initialPartition = boost::none)
+        : model(model), matrix(model->getTransitionMatrix()), numberOfThreads(resolveNumberOfThreads(numberOfThreads)), initialPartition(std::move(initialPartition)) {
+        STORM_LOG_THROW(model->isOfType(storm::models::ModelType::Dtmc) || model->isOfType(storm::models::ModelType::Ctmc) ||
+                            model->isOfType(storm::models::ModelType::Mdp),
+                        storm::exceptions::NotSupportedException, "Signature-based bisimulation is only supported for DTMCs, CTMCs and MDPs.");
+        nondeterministic = model->isOfType(storm::models::ModelType::Mdp);
+        // The row groups of trivially grouped matrices are created lazily, which must not happen inside the workers
+        matrix.getRowGroupIndices();
+        STORM_LOG_THROW(!this->initialPartition || this->initialPartition->size() == model->getNumberOfStates(), storm::exceptions::InvalidArgumentException,
+                        "Initial partition has " << this->initialPartition->size() << " entries, but the model has " << model->getNumberOfStates() << " states.");
+        collectRespectedProperties(formulas);
+    }
+
+    SignatureBisimulationResult compute() {
+        SignatureBisimulationResult result;
+        uint64_t numberOfBlocks = computeInitialPartition(result.stateToBlock);
+        while (true) {
+            auto start = std::chrono::steady_clock::now();
+            uint64_t newNumberOfBlocks = refine(result.stateToBlock);
+            result.rounds.push_back({newNumberOfBlocks, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()});
+            if (newNumberOfBlocks == numberOfBlocks) {
+                break;
+            }
+            numberOfBlocks = newNumberOfBlocks;
+        }
+        result.quotient = buildQuotient(result.stateToBlock, numberOfBlocks);
+        return result;
+    }
+
+   private:
+    void collectRespectedProperties(std::vector<std::shared_ptr<storm::logic::Formula const>> const& formulas) {
+        std::set<std::string> labels;
+        std::set<std::string> rewardModels;
+        if (formulas.empty()) {
+            labels = model->getStateLabeling().getLabels();
+            for (auto const& rewardModel : model->getRewardModels()) {
+                rewardModels.insert(rewardModel.first);
+            }
+        }
+        for (auto const& formula : formulas) {
+            for (auto const& labelFormula : formula->getAtomicLabelFormulas()) {
+                labels.insert(labelFormula->getLabel());
+            }
+            for (auto const& expressionFormula : formula->getAtomicExpressionFormulas()) {
+                // Atomic expressions are labelled by their string representation when building the model
+                std::stringstream stream;
+                stream << expressionFormula->getExpression();
+                labels.insert(stream.str());
+            }
+            for (auto const& rewardModelName : formula->getReferencedRewardModels()) {
+                if (rewardModelName.empty()) {
+                    STORM_LOG_THROW(model->getRewardModels().size() == 1, storm::exceptions::InvalidArgumentException,
+                                    "Formula refers to the default reward model, but the model does not have a unique reward model.");
+                    rewardModels.insert(model->getRewardModels().begin()->first);
+                } else {
+                    rewardModels.insert(rewardModelName);
+                }
+            }
+        }
+
+        for (auto const& label : labels) {
+            STORM_LOG_THROW(model->getStateLabeling().containsLabel(label), storm::exceptions::InvalidArgumentException,
+                            "Label '" << label << "' does not exist in the model.");
+            respectedLabels.push_back(label);
+            respectedLabelStates.push_back(model->getStateLabeling().getStates(label));
+        }
+        for (auto const& rewardModelName : rewardModels) {
+            STORM_LOG_THROW(model->hasRewardModel(rewardModelName), storm::exceptions::InvalidArgumentException,
+                            "Reward model '" << rewardModelName << "' does not exist in the model.");
+            auto const& rewardModel = model->getRewardModel(rewardModelName);
+            STORM_LOG_THROW(!rewardModel.hasTransitionRewards(), storm::exceptions::NotSupportedException,
+                            "Signature-based bisimulation does not support transition rewards.");
+            respectedRewardModels.emplace_back(rewardModelName, &rewardModel);
+        }
+    }
+
+    /*!
+     * Round a value to 40 bits of mantissa and return its bit pattern.
+     * This makes signatures robust against different summation orders of the same probabilities.
+     */
+    static uint64_t encodeValue(double value) {
+        int exponent;
+        double mantissa = std::frexp(value, &exponent);
+        double rounded = std::ldexp(std::round(std::ldexp(mantissa, 40)), exponent - 40);
+        uint64_t bits;
+        std::memcpy(&bits, &rounded, sizeof(bits));
+        return bits;
+    }
+
+    // Compute the distribution of the given row over the blocks, sorted by block
+    void collectDistribution(uint64_t row, std::vector<uint64_t> const& partition, std::vector<std::pair<uint64_t, double>>& distribution) const {
+        distribution.clear();
+        for (auto const& entry : matrix.getRow(row)) {
+            if (entry.getValue() != 0) {
+                distribution.emplace_back(partition[entry.getColumn()], entry.getValue());
+            }
+        }
+        std::sort(distribution.begin(), distribution.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+        uint64_t size = 0;
+        for (uint64_t i = 0; i < distribution.size(); ++i) {
+            if (size > 0 && distribution[size - 1].first == distribution[i].first) {
+                distribution[size - 1].second += distribution[i].second;
+            } else {
+                distribution[size++] = distribution[i];
+            }
+        }
+        distribution.resize(size);
+    }
+
+    void appendDistribution(uint64_t row, std::vector<uint64_t> const& partition, std::vector<std::pair<uint64_t, double>>& scratch,
+                            Signature& signature) const {
+        collectDistribution(row, partition, scratch);
+        for (auto const& entry : scratch) {
+            signature.push_back(entry.first);
+            signature.push_back(encodeValue(entry.second));
+        }
+    }
+
+    void appendStateActionRewards(uint64_t row, Signature& signature) const {
+        for (auto const& rewardModel : respectedRewardModels) {
+            if (rewardModel.second->hasStateActionRewards()) {
+                signature.push_back(encodeValue(rewardModel.second->getStateActionReward(row)));
+            }
+        }
+    }
+
+    // Signature of a choice in an MDP: its rewards and its distribution over the blocks
+    void computeChoiceSignature(uint64_t row, std::vector<uint64_t> const& partition, std::vector<std::pair<uint64_t, double>>& scratch,
+                                Signature& signature) const {
+        signature.clear();
+        appendStateActionRewards(row, signature);
+        appendDistribution(row, partition, scratch, signature);
+    }
+
+    /*!
+     * Assign a block to each state such that states share a block iff their signatures are equal.
+     * @return The number of blocks.
+     */
+    uint64_t assignBlocks(std::vector<Signature> const& signatures, std::vector<uint64_t>& partition) const {
+        std::vector<std::size_t> hashes(signatures.size());
+        parallelFor(0, signatures.size(), numberOfThreads,
+                    [&](uint64_t state) { hashes[state] = boost::hash_range(signatures[state].begin(), signatures[state].end()); });
+
+        auto hash = [&hashes](uint64_t state) { return hashes[state]; };
+        auto equal = [&signatures](uint64_t first, uint64_t second) { return signatures[first] == signatures[second]; };
+        std::unordered_map<uint64_t, uint64_t, decltype(hash), decltype(equal)> blocks(signatures.size(), hash, equal);
+        partition.resize(signatures.size());
+        for (uint64_t state = 0; state < signatures.size(); ++state) {
+            partition[state] = blocks.emplace(state, blocks.size()).first->second;
+        }
+        return blocks.size();
+    }
+
+    /*!
+     * Compute signatures for all states, using one scratch buffer per thread.
+     */
+    template<typename Function>
+    std::vector<Signature> computeSignatures(Function const& computeSignature) const {
+        uint64_t numberOfStates = model->getNumberOfStates();
+        std::vector<Signature> signatures(numberOfStates);
+        uint64_t threads = std::max<uint64_t>(1, std::min(numberOfThreads, numberOfStates));
+        uint64_t chunk = (numberOfStates + threads - 1) / threads;
+        parallelFor(0, threads, threads, [&](uint64_t thread) {
+            std::vector<std::pair<uint64_t, double>> scratch;
+            std::vector<Signature> choiceSignatures;
+            for (uint64_t state = thread * chunk; state < std::min(numberOfStates, (thread + 1) * chunk); ++state) {
+                computeSignature(state, scratch, choiceSignatures, signatures[state]);
+            }
+        });
+        return signatures;
+    }
+
+    // The initial partition groups states by their respected labels and rewards, and by their previous block if given
+    uint64_t computeInitialPartition(std::vector<uint64_t>& partition) const {
+        auto signatures = computeSignatures([&](uint64_t state, auto&, auto&, Signature& signature) {
+            if (initialPartition) {
+                signature.push_back(initialPartition.get()[state]);
+            }
+            for (auto const& states : respectedLabelStates) {
+                signature.push_back(states.get(state) ? 1 : 0);
+            }
+            for (auto const& rewardModel : respectedRewardModels) {
+                if (rewardModel.second->hasStateRewards()) {
+                    signature.push_back(encodeValue(rewardModel.second->getStateReward(state)));
+                }
+            }
+            if (!nondeterministic) {
+                // Deterministic models have exactly one row per state
+                appendStateActionRewards(state, signature);
+            }
+        });
+        return assignBlocks(signatures, partition);
+    }
+
+    uint64_t refine(std::vector<uint64_t>& partition) const {
+        auto const& rowGroups = matrix.getRowGroupIndices();
+        auto signatures = computeSignatures([&](uint64_t state, auto& scratch, auto& choiceSignatures, Signature& signature) {
+            signature.push_back(partition[state]);
+            if (!nondeterministic) {
+                appendDistribution(state, partition, scratch, signature);
+                return;
+            }
+            uint64_t numberOfChoices = rowGroups[state + 1] - rowGroups[state];
+            choiceSignatures.resize(std::max<uint64_t>(choiceSignatures.size(), numberOfChoices));
+            for (uint64_t choice = 0; choice < numberOfChoices; ++choice) {
+                computeChoiceSignature(rowGroups[state] + choice, partition, scratch, choiceSignatures[choice]);
+            }
+            std::sort(choiceSignatures.begin(), choiceSignatures.begin() + numberOfChoices);
+            auto end = std::unique(choiceSignatures.begin(), choiceSignatures.begin() + numberOfChoices);
+            for (auto it = choiceSignatures.begin(); it != end; ++it) {
+                signature.push_back(it->size());
+                signature.insert(signature.end(), it->begin(), it->end());
+            }
+        });
+        return assignBlocks(signatures, partition);
+    }
+
+    std::shared_ptr<storm::models::sparse::Model<double>> buildQuotient(std::vector<uint64_t> const& partition, uint64_t numberOfBlocks) const {
+        auto const& rowGroups = matrix.getRowGroupIndices();
+        std::vector<uint64_t> representatives(numberOfBlocks, model->getNumberOfStates());
+        for (uint64_t state = partition.size(); state > 0; --state) {
+            representatives[partition[state - 1]] = state - 1;
+        }
+
+        storm::storage::SparseMatrixBuilder<double> builder(0, numberOfBlocks, 0, false, nondeterministic, 0);
+        std::vector<uint64_t> quotientRows;
+        std::vector<std::pair<uint64_t, double>> scratch;
+        std::set<Signature> choiceSignatures;
+        Signature choiceSignature;
+        uint64_t row = 0;
+        for (uint64_t block = 0; block < numberOfBlocks; ++block) {
+            uint64_t representative = representatives[block];
+            if (nondeterministic) {
+                builder.newRowGroup(row);
+            }
+            choiceSignatures.clear();
+            for (uint64_t originalRow = rowGroups[representative]; originalRow < rowGroups[representative + 1]; ++originalRow) {
+                // Choices of the representative that behave identically are merged
+                computeChoiceSignature(originalRow, partition, scratch, choiceSignature);
+                if (!choiceSignatures.insert(choiceSignature).second) {
+                    continue;
+                }
+                collectDistribution(originalRow, partition, scratch);
+                for (auto const& entry : scratch) {
+                    builder.addNextValue(row, entry.first, entry.second);
+                }
+                quotientRows.push_back(originalRow);
+                ++row;
+            }
+        }
+
+        storm::models::sparse::StateLabeling labeling(numberOfBlocks);
+        for (uint64_t label = 0; label < respectedLabels.size(); ++label) {
+            labeling.addLabel(respectedLabels[label]);
+            for (uint64_t block = 0; block < numberOfBlocks; ++block) {
+                if (respectedLabelStates[label].get(representatives[block])) {
+                    labeling.addLabelToState(respectedLabels[label], block);
+                }
+            }
+        }
+        if (!labeling.containsLabel("init")) {
+            labeling.addLabel("init");
+            for (auto state : model->getInitialStates()) {
+                labeling.addLabelToState("init", partition[state]);
+            }
+        }
+
+        std::unordered_map<std::string, storm::models::sparse::StandardRewardModel<double>> rewardModels;
+        for (auto const& rewardModel : respectedRewardModels) {
+            boost::optional<std::vector<double>> stateRewards;
+            boost::optional<std::vector<double>> stateActionRewards;
+            if (rewardModel.second->hasStateRewards()) {
+                stateRewards = std::vector<double>(numberOfBlocks);
+                for (uint64_t block = 0; block < numberOfBlocks; ++block) {
+                    stateRewards.get()[block] = rewardModel.second->getStateReward(representatives[block]);
+                }
+            }
+            if (rewardModel.second->hasStateActionRewards()) {
+                stateActionRewards = std::vector<double>(quotientRows.size());
+                for (uint64_t quotientRow = 0; quotientRow < quotientRows.size(); ++quotientRow) {
+                    stateActionRewards.get()[quotientRow] = rewardModel.second->getStateActionReward(quotientRows[quotientRow]);
+                }
+            }
+            rewardModels.emplace(rewardModel.first, storm::models::sparse::StandardRewardModel<double>(std::move(stateRewards), std::move(stateActionRewards)));
+        }
+
+        // The transition matrix of a CTMC holds rates, which are preserved by the quotient
+        storm::storage::sparse::ModelComponents<double> components(builder.build(row, numberOfBlocks, numberOfBlocks), std::move(labeling), std::move(rewardModels),
+                                                                   model->isOfType(storm::models::ModelType::Ctmc));
+        return storm::utility::builder::buildModelFromComponents(model->getType(), std::move(components));
+    }
+
+    std::shared_ptr<storm::models::sparse::Model<double>> model;
+    storm::storage::SparseMatrix<double> const& matrix;
+    uint64_t numberOfThreads;
+    bool nondeterministic;
+    boost::optional<std::vector<uint64_t>> initialPartition;
+    std::vector<std::string> respectedLabels;
+    std::vector<storm::storage::BitVector> respectedLabelStates;
+    std::vector<std::pair<std::string, storm::models::sparse::StandardRewardModel<double> const*>> respectedRewardModels;
+};
@@ -1,4 +1,5 @@
 #include "simulator.h"
+#include "parallel_builder.h"
 
 #include <storm/adapters/JsonAdapter.h>
 #include <storm/simulator/DiscreteTimeSparseModelSimulator.h>
@@ -22,7 +23,7 @@ void define_sparse_model_simulator(py::module& m, std::string const& vtSuffix) {
 template<typename ValueType>
 void define_prism_program_simulator(py::module& m, std::string const& vtSuffix) {
     py::class_<storm::simulator::DiscreteTimePrismProgramSimulator<ValueType>> dtpps(m, ("_DiscreteTimePrismProgramSimulator" + vtSuffix).c_str(), "Simulator for prism programs");
-    dtpps.def(py::init<storm::prism::Program const&, storm::builder::BuilderOptions const&>(), py::arg("program"), py::arg("options"));
+    dtpps.def(py::init<storm::prism::Program const&, ParallelBuilderOptions const&>(), py::arg("program"), py::arg("options"));
     dtpps.def("set_seed", &storm::simulator::DiscreteTimePrismProgramSimulator<ValueType>::setSeed, py::arg("seed"));
     dtpps.def("step", &storm::simulator::DiscreteTimePrismProgramSimulator<ValueType>::step, py::arg("action_index"), "Make a step and randomly select the successor. The action is given as an argument, the index reflects the index of the getChoices vector that can be accessed.");
     dtpps.def("get_action_indices", [](storm::simulator::DiscreteTimePrismProgramSimulator<ValueType> const& sim) { std::vector<uint64_t> actionIndices; for(auto const& c : sim.getChoices()) {actionIndices.push_back(c.getActionIndex());} return actionIndices;}, "A list of choices that encode the possibilities in the current state.");
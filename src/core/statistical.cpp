@@ -0,0 +1,490 @@
+#include "statistical.h"
+#include "src/parallel.h"
+
+#include <pybind11/functional.h>
+
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include <boost/math/distributions/normal.hpp>
+#include <boost/math/special_functions/beta.hpp>
+
+#include "storm/builder/BuilderOptions.h"
+#include "storm/generator/PrismNextStateGenerator.h"
+#include "storm/logic/Formulas.h"
+#include "storm/storage/expressions/SimpleValuation.h"
+#include "storm/storage/prism/Program.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+#include "storm/exceptions/NotSupportedException.h"
+
+typedef storm::generator::CompressedState CompressedState;
+
+enum class SmcStoppingRule { Fixed, Chernoff, Wald, ClopperPearson, Sprt };
+
+struct SmcOptions {
+    SmcStoppingRule stoppingRule = SmcStoppingRule::Chernoff;
+    // Half-width of the confidence interval (or the indifference region for the SPRT).
+    double epsilon = 0.01;
+    // Probability of an error, i.e., the confidence is 1-delta (type I and II error for the SPRT).
+    double delta = 0.05;
+    // Number of samples for the fixed stopping rule.
+    uint64_t samples = 10000;
+    // Upper bound on the number of samples for sequential stopping rules.
+    uint64_t maxSamples = 10000000;
+    // Maximal length of a path for unbounded properties. Longer paths are undecided and not counted as samples,
+    // except for globally formulas, where a path that did not violate the formula within this length is counted as satisfying.
+    uint64_t maxSteps = 10000;
+    uint64_t numberOfThreads = 0;
+    uint64_t seed = 0;
+    // Number of samples drawn with one random stream. Results only depend on the seed, not on the number of threads.
+    uint64_t batchSize = 1000;
+    // Resolves nondeterminism by choosing a choice index given the state valuation and the number of choices.
+    // If not given, choices are selected uniformly at random.
+    std::function<uint64_t(storm::expressions::SimpleValuation const&, uint64_t)> scheduler;
+};
+
+struct SmcResult {
+    double estimate = 0;
+    double lowerBound = 0;
+    double upperBound = 0;
+    uint64_t samples = 0;
+    // Paths which reached the maximal length without deciding the property. They are not part of the samples.
+    uint64_t undecided = 0;
+    // True iff the stopping rule was satisfied before reaching the maximal number of samples.
+    bool converged = false;
+    // Outcome of the comparison with the bound of the formula, if it has one.
+    boost::optional<bool> decision;
+};
+
+/*!
+ * Path property derived from a formula.
+ */
+struct SmcQuery {
+    enum class Type { Reachability, ReachabilityReward, CumulativeReward };
+    Type type = Type::Reachability;
+    storm::expressions::Expression constraint;
+    storm::expressions::Expression target;
+    // Globally formulas are checked as reachability of the negation
+    bool negate = false;
+    boost::optional<uint64_t> stepBound;
+    std::string rewardModelName;
+    boost::optional<storm::logic::ComparisonType> comparison;
+    double threshold = 0;
+
+    bool isProbability() const {
+        return type == Type::Reachability;
+    }
+};
+
+SmcQuery analyzeFormula(storm::logic::Formula const& formula, storm::prism::Program const& program) {
+    auto const& manager = program.getManager();
+    auto labels = program.getLabelToExpressionMapping();
+    SmcQuery query;
+    STORM_LOG_THROW(formula.isOperatorFormula(), storm::exceptions::NotSupportedException, "Statistical model checking requires a probability or reward operator, got " << formula << ".");
+    auto const& operatorFormula = formula.asOperatorFormula();
+    if (operatorFormula.hasBound()) {
+        query.comparison = operatorFormula.getBound().comparisonType;
+        query.threshold = operatorFormula.getThresholdAs<double>();
+    }
+    auto const& subformula = operatorFormula.getSubformula();
+    auto toExpression = [&](storm::logic::Formula const& stateFormula) { return stateFormula.toExpression(manager, labels); };
+
+    if (formula.isProbabilityOperatorFormula()) {
+        query.constraint = manager.boolean(true);
+        if (subformula.isEventuallyFormula()) {
+            query.target = toExpression(subformula.asEventuallyFormula().getSubformula());
+        } else if (subformula.isUntilFormula()) {
+            query.constraint = toExpression(subformula.asUntilFormula().getLeftSubformula());
+            query.target = toExpression(subformula.asUntilFormula().getRightSubformula());
+        } else if (subformula.isBoundedUntilFormula()) {
+            auto const& boundedUntil = subformula.asBoundedUntilFormula();
+            STORM_LOG_THROW(!boundedUntil.isMultiDimensional() && !boundedUntil.hasLowerBound() && boundedUntil.hasUpperBound(), storm::exceptions::NotSupportedException,
+                            "Only step-bounded until formulas with an upper bound are supported, got " << subformula << ".");
+            query.constraint = toExpression(boundedUntil.getLeftSubformula());
+            query.target = toExpression(boundedUntil.getRightSubformula());
+            int64_t bound = boundedUntil.getUpperBound().evaluateAsInt();
+            query.stepBound = static_cast<uint64_t>(std::max<int64_t>(0, boundedUntil.isUpperBoundStrict() ? bound - 1 : bound));
+        } else if (subformula.isGloballyFormula()) {
+            query.target = !toExpression(subformula.asGloballyFormula().getSubformula());
+            query.negate = true;
+        } else {
+            STORM_LOG_THROW(false, storm::exceptions::NotSupportedException, "Unsupported path formula " << subformula << " for statistical model checking.");
+        }
+    } else if (formula.isRewardOperatorFormula()) {
+        auto const& rewardFormula = formula.asRewardOperatorFormula();
+        if (rewardFormula.hasRewardModelName()) {
+            query.rewardModelName = rewardFormula.getRewardModelName();
+        }
+        query.constraint = manager.boolean(true);
+        if (subformula.isEventuallyFormula()) {
+            query.type = SmcQuery::Type::ReachabilityReward;
+            query.target = toExpression(subformula.asEventuallyFormula().getSubformula());
+        } else if (subformula.isCumulativeRewardFormula()) {
+            auto const& cumulative = subformula.asCumulativeRewardFormula();
+            STORM_LOG_THROW(!cumulative.isMultiDimensional(), storm::exceptions::NotSupportedException, "Multi-dimensional cumulative rewards are not supported.");
+            query.type = SmcQuery::Type::CumulativeReward;
+            query.target = manager.boolean(false);
+            int64_t bound = cumulative.getBound().evaluateAsInt();
+            query.stepBound = static_cast<uint64_t>(std::max<int64_t>(0, cumulative.isBoundStrict() ? bound - 1 : bound));
+        } else {
+            STORM_LOG_THROW(false, storm::exceptions::NotSupportedException, "Unsupported reward formula " << subformula << " for statistical model checking.");
+        }
+    } else {
+        STORM_LOG_THROW(false, storm::exceptions::NotSupportedException, "Statistical model checking requires a probability or reward operator, got " << formula << ".");
+    }
+    return query;
+}
+
+/*!
+ * Samples paths of a PRISM program with its own next-state generator. Not thread-safe; every thread uses its own sampler.
+ */
+class PathSampler {
+   public:
+    struct Batch {
+        uint64_t samples = 0;
+        uint64_t undecided = 0;
+        double sum = 0;
+        double sumOfSquares = 0;
+        // Outcome of every sample, required for sequential tests on individual samples
+        std::vector<double> values;
+    };
+
+    PathSampler(storm::prism::Program const& program, std::shared_ptr<storm::logic::Formula const> const& formula, SmcQuery const& query, SmcOptions const& options)
+        : generator(program, storm::builder::BuilderOptions(std::vector<std::shared_ptr<storm::logic::Formula const>>{formula})), query(query), options(options) {
+        STORM_LOG_THROW(generator.isDiscreteTimeModel(), storm::exceptions::NotSupportedException, "Statistical model checking is only supported for discrete-time models.");
+        if (!query.isProbability()) {
+            bool found = false;
+            for (uint64_t i = 0; i < generator.getNumberOfRewardModels(); ++i) {
+                if (query.rewardModelName.empty() || generator.getRewardModelInformation(i).getName() == query.rewardModelName) {
+                    rewardModelIndex = i;
+                    found = true;
+                    break;
+                }
+            }
+            STORM_LOG_THROW(found, storm::exceptions::InvalidArgumentException, "Reward model '" << query.rewardModelName << "' not found.");
+        }
+        auto initialStates = generator.getInitialStates([this](CompressedState const& state) { return addSuccessor(state); });
+        STORM_LOG_THROW(initialStates.size() == 1, storm::exceptions::NotSupportedException, "Statistical model checking requires a unique initial state.");
+        initialState = successors.front();
+    }
+
+    Batch sampleBatch(uint64_t batchIndex, uint64_t numberOfSamples) {
+        // Every batch uses an independent stream, so results do not depend on the assignment of batches to threads
+        std::seed_seq seedSequence{options.seed & 0xffffffff, options.seed >> 32, batchIndex & 0xffffffff, batchIndex >> 32};
+        std::mt19937_64 randomGenerator(seedSequence);
+        Batch batch;
+        for (uint64_t i = 0; i < numberOfSamples; ++i) {
+            auto value = samplePath(randomGenerator);
+            if (!value) {
+                ++batch.undecided;
+                continue;
+            }
+            ++batch.samples;
+            batch.sum += *value;
+            batch.sumOfSquares += *value * *value;
+            batch.values.push_back(*value);
+        }
+        return batch;
+    }
+
+   private:
+    uint32_t addSuccessor(CompressedState const& state) {
+        successors.push_back(state);
+        return static_cast<uint32_t>(successors.size() - 1);
+    }
+
+    /*!
+     * Sample a single path and return its value (0 or 1 for probabilities), or none if the path was too long to decide the property.
+     */
+    boost::optional<double> samplePath(std::mt19937_64& randomGenerator) {
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        double reward = 0;
+        CompressedState current = initialState;
+        for (uint64_t step = 0;; ++step) {
+            generator.load(current);
+            if (query.type != SmcQuery::Type::CumulativeReward) {
+                if (generator.satisfies(query.target)) {
+                    return query.isProbability() ? (query.negate ? 0.0 : 1.0) : reward;
+                }
+                if (!generator.satisfies(query.constraint)) {
+                    return query.isProbability() ? (query.negate ? 1.0 : 0.0) : std::numeric_limits<double>::infinity();
+                }
+            }
+            if (query.stepBound && step >= *query.stepBound) {
+                return query.isProbability() ? (query.negate ? 1.0 : 0.0) : reward;
+            }
+            if (!query.stepBound && step >= options.maxSteps) {
+                // For globally formulas, the path satisfied the formula so far
+                if (query.negate) {
+                    return 1.0;
+                }
+                return boost::none;
+            }
+
+            successors.clear();
+            auto behavior = generator.expand([this](CompressedState const& state) { return addSuccessor(state); });
+            if (behavior.empty()) {
+                // Deadlocks are treated as self-loops
+                if (query.type == SmcQuery::Type::CumulativeReward) {
+                    return reward;
+                }
+                return query.isProbability() ? (query.negate ? 1.0 : 0.0) : std::numeric_limits<double>::infinity();
+            }
+            auto const& choices = behavior.getChoices();
+            uint64_t choiceIndex = 0;
+            if (choices.size() > 1) {
+                if (options.scheduler) {
+                    choiceIndex = options.scheduler(generator.toValuation(current), choices.size());
+                    STORM_LOG_THROW(choiceIndex < choices.size(), storm::exceptions::InvalidArgumentException, "The scheduler selected choice " << choiceIndex << " out of " << choices.size() << ".");
+                } else {
+                    choiceIndex = std::uniform_int_distribution<uint64_t>(0, choices.size() - 1)(randomGenerator);
+                }
+            }
+            auto const& choice = choices[choiceIndex];
+            if (!query.isProbability()) {
+                reward += behavior.getStateRewards()[rewardModelIndex] + choice.getRewards()[rewardModelIndex];
+            }
+
+            double random = uniform(randomGenerator) * choice.getTotalMass();
+            auto successorIt = choice.begin();
+            for (auto it = choice.begin(); it != choice.end(); ++it) {
+                successorIt = it;
+                if (random < it->second) {
+                    break;
+                }
+                random -= it->second;
+            }
+            current = successors[successorIt->first];
+        }
+    }
+
+    storm::generator::PrismNextStateGenerator<double, uint32_t> generator;
+    SmcQuery const& query;
+    SmcOptions const& options;
+    uint64_t rewardModelIndex = 0;
+    CompressedState initialState;
+    // Successors of the last expansion, indexed by the ids handed to the generator
+    std::vector<CompressedState> successors;
+};
+
+/*!
+ * Statistical model checking with parallel sampling and sequential stopping rules.
+ */
+class StatisticalModelChecker {
+   public:
+    StatisticalModelChecker(storm::prism::Program const& program, std::shared_ptr<storm::logic::Formula const> const& formula, SmcOptions const& options)
+        : options(options), query(analyzeFormula(*formula, program)) {
+        STORM_LOG_THROW(options.epsilon > 0 && options.delta > 0 && options.delta < 1, storm::exceptions::InvalidArgumentException, "Epsilon and delta must be in (0, 1).");
+        STORM_LOG_THROW(options.batchSize > 0, storm::exceptions::InvalidArgumentException, "The batch size must be positive.");
+        STORM_LOG_THROW(query.isProbability() || (options.stoppingRule != SmcStoppingRule::Chernoff && options.stoppingRule != SmcStoppingRule::ClopperPearson && options.stoppingRule != SmcStoppingRule::Sprt),
+                        storm::exceptions::InvalidArgumentException, "Rewards require the fixed or Wald stopping rule.");
+        STORM_LOG_THROW(options.stoppingRule != SmcStoppingRule::Sprt || query.comparison, storm::exceptions::InvalidArgumentException, "The SPRT requires a formula with a probability bound.");
+        numberOfThreads = resolveNumberOfThreads(options.numberOfThreads);
+        for (uint64_t thread = 0; thread < numberOfThreads; ++thread) {
+            samplers.push_back(std::make_unique<PathSampler>(program, formula, query, this->options));
+        }
+    }
+
+    SmcResult check() {
+        SmcResult result;
+        boost::optional<uint64_t> requiredSamples;
+        if (options.stoppingRule == SmcStoppingRule::Fixed) {
+            requiredSamples = options.samples;
+        } else if (options.stoppingRule == SmcStoppingRule::Chernoff) {
+            // Okamoto bound: P(|estimate - p| >= epsilon) <= 2 exp(-2 n epsilon^2)
+            requiredSamples = static_cast<uint64_t>(std::ceil(std::log(2 / options.delta) / (2 * options.epsilon * options.epsilon)));
+        }
+        uint64_t maxSamples = requiredSamples ? *requiredSamples : options.maxSamples;
+        // Undecided paths are not samples, hence the number of sampled paths is bounded separately
+        uint64_t maxPaths = std::max(maxSamples, options.maxSamples);
+
+        double sum = 0;
+        double sumOfSquares = 0;
+        for (uint64_t nextBatch = 0; result.samples < maxSamples && result.samples + result.undecided < maxPaths && !result.converged;) {
+            // Sample one batch per thread, then evaluate the stopping rule in batch order
+            uint64_t remaining = std::min(maxSamples - result.samples, maxPaths - result.samples - result.undecided);
+            uint64_t numberOfBatches = std::min(numberOfThreads, (remaining + options.batchSize - 1) / options.batchSize);
+            std::vector<PathSampler::Batch> batches(numberOfBatches);
+            std::atomic<uint64_t> next(0);
+            parallelFor(0, numberOfThreads, numberOfThreads, [&](uint64_t thread) {
+                for (uint64_t i = next++; i < numberOfBatches; i = next++) {
+                    uint64_t size = std::min(options.batchSize, remaining - i * options.batchSize);
+                    batches[i] = samplers[thread]->sampleBatch(nextBatch + i, size);
+                }
+            });
+            nextBatch += numberOfBatches;
+
+            for (auto const& batch : batches) {
+                if (options.stoppingRule == SmcStoppingRule::Sprt) {
+                    for (double value : batch.values) {
+                        sum += value;
+                        sumOfSquares += value * value;
+                        ++result.samples;
+                        if (auto decision = sprtDecision(sum, result.samples)) {
+                            result.decision = decision;
+                            result.converged = true;
+                            break;
+                        }
+                    }
+                } else {
+                    sum += batch.sum;
+                    sumOfSquares += batch.sumOfSquares;
+                    result.samples += batch.samples;
+                    if (std::isinf(sum)) {
+                        // The expected reward is infinite
+                        result.converged = true;
+                    } else if (!requiredSamples) {
+                        auto interval = computeInterval(sum, sumOfSquares, result.samples);
+                        double estimate = sum / result.samples;
+                        // Avoid stopping early on the degenerate interval of a few samples
+                        result.converged = result.samples >= options.batchSize && std::max(estimate - interval.first, interval.second - estimate) <= options.epsilon;
+                    }
+                }
+                result.undecided += batch.undecided;
+                if (result.converged) {
+                    break;
+                }
+            }
+        }
+        if (requiredSamples) {
+            result.converged = result.samples >= *requiredSamples;
+        }
+        STORM_LOG_WARN_COND(result.undecided <= result.samples, result.undecided << " of " << result.samples + result.undecided
+                                                                  << " paths exceeded the maximal length without deciding the property. Consider increasing max_steps.");
+
+        result.estimate = result.samples > 0 ? sum / result.samples : 0;
+        auto interval = computeInterval(sum, sumOfSquares, result.samples);
+        result.lowerBound = interval.first;
+        result.upperBound = interval.second;
+        if (query.comparison && !result.decision) {
+            result.decision = compare(result.estimate, query.threshold, *query.comparison);
+        }
+        return result;
+    }
+
+   private:
+    static bool compare(double value, double threshold, storm::logic::ComparisonType comparison) {
+        switch (comparison) {
+            case storm::logic::ComparisonType::Less:
+                return value < threshold;
+            case storm::logic::ComparisonType::LessEqual:
+                return value <= threshold;
+            case storm::logic::ComparisonType::Greater:
+                return value > threshold;
+            case storm::logic::ComparisonType::GreaterEqual:
+                return value >= threshold;
+        }
+        return false;
+    }
+
+    /*!
+     * Confidence interval with confidence 1-delta for the current samples.
+     */
+    std::pair<double, double> computeInterval(double sum, double sumOfSquares, uint64_t samples) const {
+        if (samples == 0) {
+            return {query.isProbability() ? 0.0 : -std::numeric_limits<double>::infinity(), query.isProbability() ? 1.0 : std::numeric_limits<double>::infinity()};
+        }
+        double n = static_cast<double>(samples);
+        double estimate = sum / n;
+        if (std::isinf(estimate)) {
+            return {estimate, estimate};
+        }
+        std::pair<double, double> interval;
+        if (options.stoppingRule == SmcStoppingRule::ClopperPearson) {
+            double successes = std::round(sum);
+            interval.first = successes == 0 ? 0 : boost::math::ibeta_inv(successes, n - successes + 1, options.delta / 2);
+            interval.second = successes == n ? 1 : boost::math::ibeta_inv(successes + 1, n - successes, 1 - options.delta / 2);
+            return interval;
+        }
+        if (query.isProbability() && (options.stoppingRule == SmcStoppingRule::Fixed || options.stoppingRule == SmcStoppingRule::Chernoff)) {
+            double halfWidth = std::sqrt(std::log(2 / options.delta) / (2 * n));
+            interval = {estimate - halfWidth, estimate + halfWidth};
+        } else {
+            // Wald interval based on the normal approximation
+            double variance = std::max(0.0, (sumOfSquares - n * estimate * estimate) / std::max(1.0, n - 1));
+            double z = boost::math::quantile(boost::math::normal(), 1 - options.delta / 2);
+            double halfWidth = z * std::sqrt(variance / n);
+            interval = {estimate - halfWidth, estimate + halfWidth};
+        }
+        if (query.isProbability()) {
+            interval.first = std::max(0.0, interval.first);
+            interval.second = std::min(1.0, interval.second);
+        }
+        return interval;
+    }
+
+    /*!
+     * Wald's sequential probability ratio test with indifference region [threshold - epsilon, threshold + epsilon].
+     * @return True iff the bound holds, false iff it is violated, none if more samples are needed.
+     */
+    boost::optional<bool> sprtDecision(double successes, uint64_t samples) const {
+        double const margin = 1e-12;
+        double p0 = std::min(1.0 - margin, query.threshold + options.epsilon);
+        double p1 = std::max(margin, query.threshold - options.epsilon);
+        double failures = samples - successes;
+        // Log-likelihood ratio of H1: p <= p1 against H0: p >= p0
+        double ratio = successes * (std::log(p1) - std::log(p0)) + failures * (std::log1p(-p1) - std::log1p(-p0));
+        bool lowerBound = storm::logic::isLowerBound(*query.comparison);
+        if (ratio <= std::log(options.delta / (1 - options.delta))) {
+            // Accept H0, i.e., the probability is above the threshold
+            return lowerBound;
+        }
+        if (ratio >= std::log((1 - options.delta) / options.delta)) {
+            return !lowerBound;
+        }
+        return boost::none;
+    }
+
+    SmcOptions options;
+    SmcQuery query;
+    uint64_t numberOfThreads;
+    std::vector<std::unique_ptr<PathSampler>> samplers;
+};
+
+SmcResult checkStatistically(storm::prism::Program const& program, std::shared_ptr<storm::logic::Formula const> const& formula, SmcOptions const& options) {
+    StatisticalModelChecker checker(program, formula, options);
+    return checker.check();
+}
+
+void define_statistical_model_checking(py::module& m) {
+    py::enum_<SmcStoppingRule>(m, "SmcStoppingRule", "Stopping rule for statistical model checking")
+        .value("FIXED", SmcStoppingRule::Fixed, "Fixed number of samples")
+        .value("CHERNOFF", SmcStoppingRule::Chernoff, "Number of samples given by the Chernoff-Hoeffding (Okamoto) bound")
+        .value("WALD", SmcStoppingRule::Wald, "Sample until the Wald (normal approximation) confidence interval is small enough")
+        .value("CLOPPER_PEARSON", SmcStoppingRule::ClopperPearson, "Sample until the exact Clopper-Pearson confidence interval is small enough")
+        .value("SPRT", SmcStoppingRule::Sprt, "Sequential probability ratio test for the bound of the formula")
+    ;
+
+    py::class_<SmcOptions>(m, "StatisticalModelCheckingOptions", "Options for statistical model checking")
+        .def(py::init<>())
+        .def_readwrite("stopping_rule", &SmcOptions::stoppingRule, "Stopping rule")
+        .def_readwrite("epsilon", &SmcOptions::epsilon, "Half-width of the confidence interval or of the indifference region of the SPRT")
+        .def_readwrite("delta", &SmcOptions::delta, "Error probability, i.e., the confidence is 1-delta")
+        .def_readwrite("samples", &SmcOptions::samples, "Number of samples for the fixed stopping rule")
+        .def_readwrite("max_samples", &SmcOptions::maxSamples, "Maximal number of samples for sequential stopping rules")
+        .def_readwrite("max_steps", &SmcOptions::maxSteps, "Maximal path length for unbounded properties")
+        .def_readwrite("nr_threads", &SmcOptions::numberOfThreads, "Number of threads (0 = all hardware threads)")
+        .def_readwrite("seed", &SmcOptions::seed, "Seed; results only depend on the seed and batch size, not on the number of threads")
+        .def_readwrite("batch_size", &SmcOptions::batchSize, "Number of samples drawn from one random stream")
+        .def_readwrite("scheduler", &SmcOptions::scheduler, "Function (valuation, number of choices) -> choice index resolving nondeterminism. If None, choices are selected uniformly.")
+    ;
+
+    py::class_<SmcResult>(m, "StatisticalModelCheckingResult", "Result of statistical model checking")
+        .def_readonly("estimate", &SmcResult::estimate, "Estimated value")
+        .def_readonly("lower_bound", &SmcResult::lowerBound, "Lower bound of the confidence interval")
+        .def_readonly("upper_bound", &SmcResult::upperBound, "Upper bound of the confidence interval")
+        .def_readonly("samples", &SmcResult::samples, "Number of sampled paths")
+        .def_readonly("undecided", &SmcResult::undecided, "Number of paths exceeding the maximal length without deciding the property; they are not part of the samples")
+        .def_readonly("converged", &SmcResult::converged, "True iff the stopping rule was satisfied")
+        .def_readonly("decision", &SmcResult::decision, "Whether the bound of the formula holds, None if the formula has no bound")
+        .def("__str__", [](SmcResult const& result) {
+            std::stringstream stream;
+            stream << result.estimate << " in [" << result.lowerBound << ", " << result.upperBound << "] (" << result.samples << " samples)";
+            return stream.str();
+        })
+    ;
+
+    m.def("_check_statistically", &checkStatistically, "Statistical model checking of a PRISM program", py::arg("program"), py::arg("formula"), py::arg("options") = SmcOptions(), py::call_guard<py::gil_scoped_release>());
+}
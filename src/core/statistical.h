@@ -0,0 +1,5 @@
+#pragma once
+
+#include "common.h"
+
+void define_statistical_model_checking(py::module& m);
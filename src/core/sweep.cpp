@@ -0,0 +1,153 @@
+#include "sweep.h"
+#include "src/parallel.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+#include "storm/api/builder.h"
+#include "storm/api/properties.h"
+#include "storm/api/verification.h"
+#include "storm/modelchecker/results/ExplicitQualitativeCheckResult.h"
+#include "storm/modelchecker/results/ExplicitQuantitativeCheckResult.h"
+#include "storm/storage/SymbolicModelDescription.h"
+#include "storm/storage/jani/Property.h"
+#include "storm/exceptions/NotSupportedException.h"
+
+struct ConstantSweepOptions {
+    bool flatten = false;
+    bool build = true;
+    bool check = true;
+    bool keepModels = false;
+    uint64_t numberOfThreads = 0;
+};
+
+/*!
+ * One instance of a constant sweep: the instantiated description and properties, and optionally the built model and the results for the initial state.
+ */
+struct ConstantSweepInstance {
+    std::string constants;
+    storm::storage::SymbolicModelDescription description;
+    std::vector<storm::jani::Property> properties;
+    uint64_t states = 0;
+    uint64_t transitions = 0;
+    // Result per property, NaN if not checked. Qualitative results are given as 0 or 1.
+    std::vector<double> results;
+    std::shared_ptr<storm::models::sparse::Model<double>> model;
+    double seconds = 0;
+};
+
+namespace {
+    double getInitialStateResult(storm::models::sparse::Model<double> const& model, storm::modelchecker::CheckResult const& result) {
+        uint64_t initialState = *model.getInitialStates().begin();
+        if (result.isExplicitQuantitativeCheckResult()) {
+            return result.asExplicitQuantitativeCheckResult<double>()[initialState];
+        }
+        STORM_LOG_THROW(result.isExplicitQualitativeCheckResult(), storm::exceptions::NotSupportedException, "Unexpected kind of check result.");
+        return result.asExplicitQualitativeCheckResult()[initialState] ? 1 : 0;
+    }
+
+    storm::storage::SymbolicModelDescription simplify(storm::storage::SymbolicModelDescription const& description, bool flatten) {
+        if (description.isPrismProgram()) {
+            storm::prism::Program program = description.asPrismProgram().simplify();
+            if (flatten && program.getNumberOfModules() > 1) {
+                program = program.flattenModules();
+            }
+            return storm::storage::SymbolicModelDescription(program);
+        }
+        storm::jani::Model model = description.asJaniModel().substituteConstantsFunctions();
+        if (flatten) {
+            model = model.flattenComposition();
+        }
+        return storm::storage::SymbolicModelDescription(model);
+    }
+}
+
+std::vector<ConstantSweepInstance> sweepConstants(storm::storage::SymbolicModelDescription const& description, std::vector<storm::jani::Property> const& properties,
+                                                  std::vector<std::string> const& constantDefinitions, ConstantSweepOptions const& options) {
+    // The definitions are parsed upfront, as parsing is not thread-safe
+    std::vector<std::map<storm::expressions::Variable, storm::expressions::Expression>> definitions;
+    for (auto const& definition : constantDefinitions) {
+        definitions.push_back(description.parseConstantDefinitions(definition));
+    }
+
+    std::vector<ConstantSweepInstance> instances(constantDefinitions.size());
+    std::atomic<uint64_t> nextInstance(0);
+    // All instances share the expression manager of the description, which is not thread-safe. Every step that may declare or
+    // create expressions (instantiation, simplification, flattening and building) is therefore serialized, only the model checking
+    // of the built models runs concurrently.
+    std::mutex managerMutex;
+    uint64_t numberOfThreads = std::min<uint64_t>(resolveNumberOfThreads(options.numberOfThreads), std::max<uint64_t>(1, instances.size()));
+    // Instances are fetched dynamically, as their sizes may differ considerably
+    parallelFor(0, numberOfThreads, numberOfThreads, [&](uint64_t) {
+        for (uint64_t index = nextInstance++; index < instances.size(); index = nextInstance++) {
+            auto start = std::chrono::steady_clock::now();
+            ConstantSweepInstance& instance = instances[index];
+            instance.constants = constantDefinitions[index];
+            std::vector<std::shared_ptr<storm::logic::Formula const>> formulas;
+            std::shared_ptr<storm::models::sparse::Model<double>> model;
+            {
+                std::lock_guard<std::mutex> lock(managerMutex);
+                instance.description = simplify(description.preprocess(definitions[index]), options.flatten);
+                if (!properties.empty()) {
+                    instance.properties = storm::api::substituteConstantsInProperties(properties, definitions[index]);
+                }
+                formulas = storm::api::extractFormulasFromProperties(instance.properties);
+                if (options.build) {
+                    model = storm::api::buildSparseModel<double>(instance.description, formulas)->template as<storm::models::sparse::Model<double>>();
+                }
+            }
+            instance.results.assign(instance.properties.size(), std::numeric_limits<double>::quiet_NaN());
+            if (model) {
+                instance.states = model->getNumberOfStates();
+                instance.transitions = model->getNumberOfTransitions();
+                if (options.check) {
+                    for (uint64_t property = 0; property < formulas.size(); ++property) {
+                        auto result = storm::api::verifyWithSparseEngine<double>(model, storm::api::createTask<double>(formulas[property], true));
+                        STORM_LOG_THROW(result, storm::exceptions::NotSupportedException, "Property " << instance.properties[property].getName() << " cannot be checked on this model.");
+                        instance.results[property] = getInitialStateResult(*model, *result);
+                    }
+                }
+                if (options.keepModels) {
+                    instance.model = model;
+                }
+            }
+            instance.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    });
+    return instances;
+}
+
+void define_constant_sweep(py::module& m) {
+    py::class_<ConstantSweepOptions>(m, "ConstantSweepOptions", "Options for sweeping over constant definitions")
+        .def(py::init<>())
+        .def_readwrite("flatten", &ConstantSweepOptions::flatten, "Flatten the modules of PRISM programs or the composition of JANI models")
+        .def_readwrite("build", &ConstantSweepOptions::build, "Build the sparse model of each instance")
+        .def_readwrite("check", &ConstantSweepOptions::check, "Check the properties on each model")
+        .def_readwrite("keep_models", &ConstantSweepOptions::keepModels, "Keep the built models in the results")
+        .def_readwrite("nr_threads", &ConstantSweepOptions::numberOfThreads, "Number of threads, 0 for the number of cores")
+    ;
+
+    py::class_<ConstantSweepInstance>(m, "ConstantSweepInstance", "Instance of a constant sweep")
+        .def_readonly("constants", &ConstantSweepInstance::constants, "Constant definitions of the instance")
+        .def_readonly("description", &ConstantSweepInstance::description, "Instantiated and simplified symbolic description")
+        .def_readonly("properties", &ConstantSweepInstance::properties, "Instantiated properties")
+        .def_readonly("nr_states", &ConstantSweepInstance::states, "Number of states of the model, 0 if not built")
+        .def_readonly("nr_transitions", &ConstantSweepInstance::transitions, "Number of transitions of the model, 0 if not built")
+        .def_readonly("results", &ConstantSweepInstance::results, "Result for the initial state per property, NaN if not checked")
+        .def_readonly("model", &ConstantSweepInstance::model, "Built model if models are kept, otherwise None")
+        .def_readonly("seconds", &ConstantSweepInstance::seconds, "Wall time spent on the instance in seconds")
+    ;
+
+    m.def("_sweep_constants", &sweepConstants, R"doc(
+        Instantiate a symbolic description for each of the given constant definitions in parallel and optionally build and check the models.
+
+        :param symbolic_description: Symbolic description with undefined constants.
+        :param properties: Properties to instantiate and check.
+        :param constant_definitions: Constant definition strings, e.g. 'N=16,p=0.5'.
+        :param options: Options of the sweep.
+        :return: One instance per constant definition, in the same order.
+        )doc", py::arg("symbolic_description"), py::arg("properties"), py::arg("constant_definitions"), py::arg("options"), py::call_guard<py::gil_scoped_release>());
+}
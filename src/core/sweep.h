@@ -0,0 +1,5 @@
+#pragma once
+
+#include "common.h"
+
+void define_constant_sweep(py::module& m);
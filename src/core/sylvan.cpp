@@ -0,0 +1,151 @@
+#include "sylvan.h"
+
+#include "storm/settings/SettingsManager.h"
+#include "storm/settings/modules/SylvanSettings.h"
+#include "storm/storage/dd/sylvan/InternalSylvanDdManager.h"
+
+#include <atomic>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+struct SylvanOptions {
+    uint64_t numberOfThreads = 0;
+    uint64_t maximalMemory = 0;
+};
+
+struct SylvanOperationStatistics {
+    uint64_t calls = 0;
+    double seconds = 0;
+    uint64_t peakNodes = 0;
+};
+
+struct SylvanStatistics {
+    uint64_t garbageCollections = 0;
+    uint64_t peakNodes = 0;
+    uint64_t tableSize = 0;
+    uint64_t usedNodes = 0;
+    std::map<std::string, SylvanOperationStatistics> operations;
+};
+
+namespace {
+    using namespace sylvan;
+
+    std::atomic<uint64_t> garbageCollections(0);
+    std::atomic<uint64_t> peakNodes(0);
+    std::mutex statisticsMutex;
+    SylvanStatistics statistics;
+
+    void updatePeak(uint64_t nodes) {
+        uint64_t peak = peakNodes.load();
+        while (nodes > peak && !peakNodes.compare_exchange_weak(peak, nodes)) {
+        }
+    }
+
+    // Called by Sylvan before each garbage collection, when the node table is at its fullest
+    VOID_TASK_0(countGarbageCollection) {
+        size_t filled, total;
+        sylvan_table_usage(&filled, &total);
+        updatePeak(filled);
+        ++garbageCollections;
+    }
+
+    std::pair<uint64_t, uint64_t> getTableUsage() {
+        size_t filled, total;
+#ifdef LACE_ME
+        // Older versions of Lace require the worker context of the calling thread
+        LACE_ME;
+#endif
+        sylvan_table_usage(&filled, &total);
+        return {filled, total};
+    }
+
+    SylvanOptions getSylvanOptions() {
+        auto const& settings = storm::settings::getModule<storm::settings::modules::SylvanSettings>();
+        SylvanOptions options;
+        options.numberOfThreads = settings.isNumberOfThreadsSet() ? settings.getNumberOfThreads() : 0;
+        options.maximalMemory = settings.getMaximalMemory();
+        return options;
+    }
+
+    void setSylvanOptions(SylvanOptions const& options) {
+        // Always pass the threads, as an option that is already set is not reset otherwise, so 0 (all cores) could not be restored
+        std::vector<std::string> arguments = {"--sylvan:maxmem", std::to_string(options.maximalMemory), "--sylvan:threads", std::to_string(options.numberOfThreads)};
+        storm::settings::mutableManager().setFromExplodedString(arguments);
+    }
+}
+
+SylvanOperationRecorder::SylvanOperationRecorder(std::string const& operation) : operation(operation), start(std::chrono::steady_clock::now()), uncaughtExceptions(std::uncaught_exceptions()) {
+    // Registering the hook does not require Sylvan to be initialized. It is registered only once, such that it is not set again on every operation.
+    static std::once_flag hookRegistered;
+    std::call_once(hookRegistered, []() { sylvan_gc_hook_pregc(TASK(countGarbageCollection)); });
+}
+
+SylvanOperationRecorder::~SylvanOperationRecorder() {
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+    SylvanOperationStatistics& operationStatistics = statistics.operations[operation];
+    ++operationStatistics.calls;
+    operationStatistics.seconds += seconds;
+    // If the operation failed, the DD manager and with it Sylvan may already be gone
+    if (std::uncaught_exceptions() == uncaughtExceptions) {
+        auto usage = getTableUsage();
+        updatePeak(usage.first);
+        statistics.usedNodes = usage.first;
+        statistics.tableSize = usage.second;
+        operationStatistics.peakNodes = std::max<uint64_t>(operationStatistics.peakNodes, peakNodes.load());
+    }
+}
+
+void define_sylvan(py::module& m) {
+    py::class_<SylvanOptions>(m, "SylvanOptions", R"doc(
+        Options for the Sylvan DD library used by the symbolic engines.
+        The sizes of the node table and the operation cache are derived from the maximal memory.
+        The options take effect when Sylvan is initialized the next time, i.e. when a DD manager is created while no other symbolic model exists.
+        )doc")
+        .def(py::init<>())
+        .def_readwrite("nr_threads", &SylvanOptions::numberOfThreads, "Number of worker threads, 0 for the number of cores")
+        .def_readwrite("max_memory", &SylvanOptions::maximalMemory, "Maximal memory of the node table and cache in MB")
+    ;
+    m.def("get_sylvan_options", &getSylvanOptions, "Get the current options of Sylvan");
+    m.def("set_sylvan_options", &setSylvanOptions, py::arg("options"), "Set the options of Sylvan");
+
+    py::class_<SylvanOperationStatistics>(m, "SylvanOperationStatistics", "Statistics of one kind of symbolic operation")
+        .def_readonly("calls", &SylvanOperationStatistics::calls, "Number of calls")
+        .def_readonly("seconds", &SylvanOperationStatistics::seconds, "Total wall time in seconds")
+        .def_readonly("peak_nodes", &SylvanOperationStatistics::peakNodes, "Peak number of nodes in the table observed until the end of the last call")
+    ;
+
+    py::class_<SylvanStatistics>(m, "SylvanStatistics", R"doc(
+        Statistics of Sylvan collected while building and checking symbolic models.
+        The node table usage is sampled before each garbage collection and after each operation.
+        )doc")
+        .def_readonly("garbage_collections", &SylvanStatistics::garbageCollections, "Number of garbage collections")
+        .def_readonly("peak_nodes", &SylvanStatistics::peakNodes, "Peak number of nodes in the table")
+        .def_readonly("used_nodes", &SylvanStatistics::usedNodes, "Number of nodes in the table after the last operation")
+        .def_readonly("table_size", &SylvanStatistics::tableSize, "Current size of the node table")
+        .def_readonly("operations", &SylvanStatistics::operations, "Statistics per operation")
+        .def("__str__", [](SylvanStatistics const& stats) {
+            std::stringstream stream;
+            stream << "Sylvan: " << stats.garbageCollections << " garbage collections, peak " << stats.peakNodes << " of " << stats.tableSize << " nodes" << std::endl;
+            for (auto const& entry : stats.operations) {
+                stream << "  " << entry.first << ": " << entry.second.calls << " calls, " << entry.second.seconds << "s" << std::endl;
+            }
+            return stream.str();
+        })
+    ;
+    m.def("get_sylvan_statistics", []() {
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+        SylvanStatistics result = statistics;
+        result.garbageCollections = garbageCollections.load();
+        result.peakNodes = peakNodes.load();
+        return result;
+    }, "Get the statistics of Sylvan collected since the last reset");
+    m.def("reset_sylvan_statistics", []() {
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+        statistics = SylvanStatistics();
+        garbageCollections = 0;
+        peakNodes = 0;
+    }, "Reset the statistics of Sylvan");
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "common.h"
+
+#include <chrono>
+
+void define_sylvan(py::module& m);
+
+/*!
+ * Records the duration and the node table usage of a symbolic operation in the global Sylvan statistics.
+ * Must only be created while a Sylvan DD manager exists, i.e. while Sylvan is initialized.
+ */
+class SylvanOperationRecorder {
+public:
+    SylvanOperationRecorder(std::string const& operation);
+    ~SylvanOperationRecorder();
+
+    SylvanOperationRecorder(SylvanOperationRecorder const&) = delete;
+    SylvanOperationRecorder& operator=(SylvanOperationRecorder const&) = delete;
+
+private:
+    std::string operation;
+    std::chrono::steady_clock::time_point start;
+    int uncaughtExceptions;
+};
@@ -0,0 +1,491 @@
+#include "symbolic_io.h"
+#include "sylvan.h"
+
+#include "storm/models/ModelBase.h"
+#include "storm/models/symbolic/Model.h"
+#include "storm/models/symbolic/Dtmc.h"
+#include "storm/models/symbolic/Ctmc.h"
+#include "storm/models/symbolic/Mdp.h"
+#include "storm/models/symbolic/StandardRewardModel.h"
+#include "storm/storage/dd/DdManager.h"
+#include "storm/storage/dd/DdMetaVariable.h"
+#include "storm/storage/dd/Bdd.h"
+#include "storm/storage/dd/Add.h"
+#include "storm/storage/dd/sylvan/InternalSylvanBdd.h"
+#include "storm/storage/dd/sylvan/InternalSylvanAdd.h"
+#include "storm/io/file.h"
+#include "storm/exceptions/FileIoException.h"
+#include "storm/exceptions/NotSupportedException.h"
+#include "storm/exceptions/WrongFormatException.h"
+
+#include <fstream>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+
+/*
+ * Binary format for symbolic models.
+ *
+ * The file stores the meta variables of the DD manager, one table of BDD nodes and one table of ADD nodes shared by all DDs of the model,
+ * and the components of the model referring to the roots in these tables.
+ * Nodes are written in post-order, so children always precede their parents and loading only needs a single ite per node.
+ * DD variables are identified by their meta variable and bit position, so the loaded model does not depend on the variable order.
+ */
+
+namespace {
+
+    const storm::dd::DdType Library = storm::dd::DdType::Sylvan;
+    const std::string FileMagic = "STORMPY-DD";
+    const uint32_t FileVersion = 1;
+    const uint64_t LeafVariable = std::numeric_limits<uint64_t>::max();
+
+    typedef storm::dd::DdManager<Library> Manager;
+    typedef storm::dd::Bdd<Library> Bdd;
+    typedef storm::dd::Add<Library, double> Add;
+    typedef storm::models::symbolic::Model<Library, double> SymbolicModel;
+    typedef storm::models::symbolic::StandardRewardModel<Library, double> SymbolicRewardModel;
+
+    class BinaryWriter {
+    public:
+        // openFile opens in text mode, which would translate bytes of the dump on some platforms
+        BinaryWriter(std::string const& file) : stream(file, std::ios::out | std::ios::binary | std::ios::trunc) {
+            STORM_LOG_THROW(stream.good(), storm::exceptions::FileIoException, "Could not open file " << file << ".");
+        }
+
+        ~BinaryWriter() {
+            storm::utility::closeFile(stream);
+        }
+
+        template<typename T>
+        void write(T const& value) {
+            stream.write(reinterpret_cast<char const*>(&value), sizeof(T));
+        }
+
+        void write(std::string const& value) {
+            write<uint64_t>(value.size());
+            stream.write(value.data(), value.size());
+        }
+
+    private:
+        std::ofstream stream;
+    };
+
+    class BinaryReader {
+    public:
+        BinaryReader(std::string const& file) : stream(file, std::ios::in | std::ios::binary) {
+            STORM_LOG_THROW(stream.good(), storm::exceptions::FileIoException, "Could not open file " << file << ".");
+        }
+
+        template<typename T>
+        T read() {
+            T value;
+            stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+            STORM_LOG_THROW(stream.good(), storm::exceptions::WrongFormatException, "Unexpected end of file.");
+            return value;
+        }
+
+        std::string readString() {
+            std::string value(read<uint64_t>(), '\0');
+            stream.read(&value[0], value.size());
+            STORM_LOG_THROW(stream.good(), storm::exceptions::WrongFormatException, "Unexpected end of file.");
+            return value;
+        }
+
+    private:
+        std::ifstream stream;
+    };
+
+    struct DdNode {
+        uint64_t variable;
+        uint64_t low;
+        uint64_t high;
+        double value;
+    };
+
+    void writeNodes(BinaryWriter& writer, std::vector<DdNode> const& nodes) {
+        writer.write<uint64_t>(nodes.size());
+        for (auto const& node : nodes) {
+            writer.write(node.variable);
+            if (node.variable == LeafVariable) {
+                writer.write(node.value);
+            } else {
+                writer.write(node.low);
+                writer.write(node.high);
+            }
+        }
+    }
+
+    std::vector<DdNode> readNodes(BinaryReader& reader) {
+        std::vector<DdNode> nodes(reader.read<uint64_t>());
+        for (uint64_t i = 0; i < nodes.size(); ++i) {
+            DdNode& node = nodes[i];
+            node.variable = reader.read<uint64_t>();
+            if (node.variable == LeafVariable) {
+                node.value = reader.read<double>();
+            } else {
+                node.low = reader.read<uint64_t>();
+                node.high = reader.read<uint64_t>();
+                STORM_LOG_THROW(node.low < i && node.high < i, storm::exceptions::WrongFormatException, "Node " << i << " refers to a node that is not yet defined.");
+            }
+        }
+        return nodes;
+    }
+
+    // Flattens Sylvan DDs into node tables, sharing nodes between all encoded DDs
+    class DdEncoder {
+    public:
+        uint64_t addBdd(Bdd const& bdd) {
+            return encode(bdd.getInternalBdd().getSylvanBdd().GetBDD(), true);
+        }
+
+        uint64_t addAdd(Add const& add) {
+            return encode(add.getInternalAdd().getSylvanMtbdd().GetMTBDD(), false);
+        }
+
+        std::vector<DdNode> const& getBddNodes() const {
+            return bddNodes;
+        }
+
+        std::vector<DdNode> const& getAddNodes() const {
+            return addNodes;
+        }
+
+    private:
+        uint64_t encode(uint64_t dd, bool isBdd) {
+            // The C interface of Sylvan, wrapped in its namespace for C++
+            using namespace sylvan;
+            auto& ids = isBdd ? bddIds : addIds;
+            auto it = ids.find(dd);
+            if (it != ids.end()) {
+                return it->second;
+            }
+
+            DdNode node;
+            if (mtbdd_isleaf(dd)) {
+                node.variable = LeafVariable;
+                if (dd == mtbdd_false || dd == mtbdd_true) {
+                    node.value = dd == mtbdd_true ? 1.0 : 0.0;
+                } else {
+                    STORM_LOG_THROW(!isBdd && mtbdd_gettype(dd) == 1, storm::exceptions::NotSupportedException, "Only ADDs with double values can be exported.");
+                    node.value = mtbdd_getdouble(dd);
+                }
+            } else {
+                // The low and high successors carry over complement marks
+                node.variable = mtbdd_getvar(dd);
+                node.low = encode(mtbdd_getlow(dd), isBdd);
+                node.high = encode(mtbdd_gethigh(dd), isBdd);
+            }
+
+            auto& nodes = isBdd ? bddNodes : addNodes;
+            uint64_t id = nodes.size();
+            nodes.push_back(node);
+            ids.emplace(dd, id);
+            return id;
+        }
+
+        std::vector<DdNode> bddNodes;
+        std::vector<DdNode> addNodes;
+        std::unordered_map<uint64_t, uint64_t> bddIds;
+        std::unordered_map<uint64_t, uint64_t> addIds;
+    };
+
+    // Rebuilds the DDs of the node tables in the given manager
+    class DdDecoder {
+    public:
+        DdDecoder(Manager const& manager, std::unordered_map<uint64_t, Bdd> const& variables, std::vector<DdNode> const& bddNodes, std::vector<DdNode> const& addNodes) {
+            bdds.reserve(bddNodes.size());
+            for (auto const& node : bddNodes) {
+                if (node.variable == LeafVariable) {
+                    bdds.push_back(node.value != 0 ? manager.getBddOne() : manager.getBddZero());
+                } else {
+                    bdds.push_back(getVariable(variables, node.variable).ite(bdds[node.high], bdds[node.low]));
+                }
+            }
+            adds.reserve(addNodes.size());
+            for (auto const& node : addNodes) {
+                if (node.variable == LeafVariable) {
+                    adds.push_back(manager.template getConstant<double>(node.value));
+                } else {
+                    adds.push_back(getVariable(variables, node.variable).ite(adds[node.high], adds[node.low]));
+                }
+            }
+        }
+
+        Bdd const& getBdd(uint64_t id) const {
+            STORM_LOG_THROW(id < bdds.size(), storm::exceptions::WrongFormatException, "Unknown BDD node " << id << ".");
+            return bdds[id];
+        }
+
+        Add const& getAdd(uint64_t id) const {
+            STORM_LOG_THROW(id < adds.size(), storm::exceptions::WrongFormatException, "Unknown ADD node " << id << ".");
+            return adds[id];
+        }
+
+    private:
+        static Bdd const& getVariable(std::unordered_map<uint64_t, Bdd> const& variables, uint64_t index) {
+            auto it = variables.find(index);
+            STORM_LOG_THROW(it != variables.end(), storm::exceptions::WrongFormatException, "Unknown DD variable " << index << ".");
+            return it->second;
+        }
+
+        std::vector<Bdd> bdds;
+        std::vector<Add> adds;
+    };
+
+    void writeVariables(BinaryWriter& writer, std::set<storm::expressions::Variable> const& variables) {
+        writer.write<uint64_t>(variables.size());
+        for (auto const& variable : variables) {
+            writer.write(variable.getName());
+        }
+    }
+
+    std::set<storm::expressions::Variable> readVariables(BinaryReader& reader, std::map<std::string, storm::expressions::Variable> const& metaVariables) {
+        std::set<storm::expressions::Variable> result;
+        uint64_t size = reader.read<uint64_t>();
+        for (uint64_t i = 0; i < size; ++i) {
+            std::string name = reader.readString();
+            auto it = metaVariables.find(name);
+            STORM_LOG_THROW(it != metaVariables.end(), storm::exceptions::WrongFormatException, "Unknown meta variable " << name << ".");
+            result.insert(it->second);
+        }
+        return result;
+    }
+
+    struct MetaVariableInfo {
+        std::string name;
+        storm::dd::MetaVariableType type;
+        int64_t low;
+        int64_t high;
+        std::vector<uint64_t> indices;
+    };
+
+    // Meta variables created together as layers are named x, x', x'', ...
+    std::string baseName(std::string const& name) {
+        return name.substr(0, name.find_last_not_of('\'') + 1);
+    }
+
+    // Recreates the meta variables in the manager and maps each DD variable index of the file to the corresponding new DD variable
+    std::map<std::string, storm::expressions::Variable> createMetaVariables(Manager& manager, std::vector<MetaVariableInfo> const& infos, std::unordered_map<uint64_t, Bdd>& ddVariables) {
+        std::vector<std::string> order;
+        std::map<std::string, std::vector<MetaVariableInfo const*>> layers;
+        for (auto const& info : infos) {
+            std::string base = baseName(info.name);
+            if (layers.count(base) == 0) {
+                order.push_back(base);
+            }
+            layers[base].push_back(&info);
+        }
+
+        std::map<std::string, storm::expressions::Variable> result;
+        for (auto const& base : order) {
+            auto& group = layers[base];
+            std::sort(group.begin(), group.end(), [](MetaVariableInfo const* a, MetaVariableInfo const* b) { return a->name.size() < b->name.size(); });
+            MetaVariableInfo const& first = *group.front();
+            std::vector<storm::expressions::Variable> created;
+            if (first.type == storm::dd::MetaVariableType::Bool) {
+                STORM_LOG_THROW(group.size() == 2, storm::exceptions::NotSupportedException, "Boolean meta variable " << base << " must have exactly two layers.");
+                auto pair = manager.addMetaVariable(base);
+                created = {pair.first, pair.second};
+            } else if (first.type == storm::dd::MetaVariableType::Int) {
+                created = manager.addMetaVariable(base, first.low, first.high, group.size());
+            } else {
+                created = manager.addBitVectorMetaVariable(base, first.indices.size(), group.size());
+            }
+
+            for (uint64_t layer = 0; layer < group.size(); ++layer) {
+                MetaVariableInfo const& info = *group[layer];
+                storm::expressions::Variable const& variable = created[layer];
+                STORM_LOG_THROW(variable.getName() == info.name, storm::exceptions::WrongFormatException, "Meta variable " << info.name << " was recreated as " << variable.getName() << ".");
+                auto const& newVariables = manager.getMetaVariable(variable).getDdVariables();
+                STORM_LOG_THROW(newVariables.size() == info.indices.size(), storm::exceptions::WrongFormatException, "Meta variable " << info.name << " has a different number of DD variables.");
+                for (uint64_t bit = 0; bit < info.indices.size(); ++bit) {
+                    ddVariables.emplace(info.indices[bit], newVariables[bit]);
+                }
+                result.emplace(info.name, variable);
+            }
+        }
+        return result;
+    }
+
+}
+
+void exportSymbolicModel(std::shared_ptr<SymbolicModel> const& model, std::string const& file) {
+    storm::models::ModelType type = model->getType();
+    STORM_LOG_THROW(type == storm::models::ModelType::Dtmc || type == storm::models::ModelType::Ctmc || type == storm::models::ModelType::Mdp, storm::exceptions::NotSupportedException,
+                    "Exporting symbolic models of type " << type << " is not supported.");
+    Manager const& manager = model->getManager();
+
+    // Meta variables with the DD variables they consist of, in the order of their creation
+    std::set<storm::expressions::Variable> allMetaVariables = manager.getAllMetaVariables();
+    std::vector<storm::expressions::Variable> metaVariables(allMetaVariables.begin(), allMetaVariables.end());
+    std::sort(metaVariables.begin(), metaVariables.end(), [](storm::expressions::Variable const& a, storm::expressions::Variable const& b) { return a.getIndex() < b.getIndex(); });
+
+    DdEncoder encoder;
+    uint64_t reachableStates = encoder.addBdd(model->getReachableStates());
+    uint64_t initialStates = encoder.addBdd(model->getInitialStates());
+    uint64_t deadlockStates = encoder.addBdd(model->getDeadlockStates());
+    uint64_t transitionMatrix = encoder.addAdd(model->getTransitionMatrix());
+    std::vector<std::pair<std::string, uint64_t>> labels;
+    for (auto const& label : model->getLabels()) {
+        labels.emplace_back(label, encoder.addBdd(model->getStates(label)));
+    }
+    std::vector<std::tuple<std::string, std::optional<uint64_t>, std::optional<uint64_t>, std::optional<uint64_t>>> rewardModels;
+    for (auto const& entry : model->getRewardModels()) {
+        SymbolicRewardModel const& rewardModel = entry.second;
+        rewardModels.emplace_back(entry.first,
+                                  rewardModel.hasStateRewards() ? std::make_optional(encoder.addAdd(rewardModel.getStateRewardVector())) : std::nullopt,
+                                  rewardModel.hasStateActionRewards() ? std::make_optional(encoder.addAdd(rewardModel.getStateActionRewardVector())) : std::nullopt,
+                                  rewardModel.hasTransitionRewards() ? std::make_optional(encoder.addAdd(rewardModel.getTransitionRewardMatrix())) : std::nullopt);
+    }
+    std::optional<uint64_t> exitRates;
+    if (type == storm::models::ModelType::Ctmc) {
+        exitRates = encoder.addAdd(model->template as<storm::models::symbolic::Ctmc<Library, double>>()->getExitRateVector());
+    }
+
+    BinaryWriter writer(file);
+    writer.write(FileMagic);
+    writer.write(FileVersion);
+    writer.write<uint64_t>(static_cast<uint64_t>(type));
+
+    writer.write<uint64_t>(metaVariables.size());
+    for (auto const& variable : metaVariables) {
+        auto const& metaVariable = manager.getMetaVariable(variable);
+        writer.write(metaVariable.getName());
+        writer.write<uint64_t>(static_cast<uint64_t>(metaVariable.getType()));
+        writer.write<int64_t>(metaVariable.getLow());
+        writer.write<int64_t>(metaVariable.getHigh());
+        std::vector<uint64_t> indices = metaVariable.getIndices(false);
+        writer.write<uint64_t>(indices.size());
+        for (auto index : indices) {
+            writer.write(index);
+        }
+    }
+    writeNodes(writer, encoder.getBddNodes());
+    writeNodes(writer, encoder.getAddNodes());
+
+    writeVariables(writer, model->getRowVariables());
+    writeVariables(writer, model->getColumnVariables());
+    writer.write<uint64_t>(model->getRowColumnMetaVariablePairs().size());
+    for (auto const& pair : model->getRowColumnMetaVariablePairs()) {
+        writer.write(pair.first.getName());
+        writer.write(pair.second.getName());
+    }
+    if (type == storm::models::ModelType::Mdp) {
+        writeVariables(writer, model->template as<storm::models::symbolic::Mdp<Library, double>>()->getNondeterminismVariables());
+    }
+
+    writer.write(reachableStates);
+    writer.write(initialStates);
+    writer.write(deadlockStates);
+    writer.write(transitionMatrix);
+    if (exitRates) {
+        writer.write(exitRates.value());
+    }
+    writer.write<uint64_t>(labels.size());
+    for (auto const& label : labels) {
+        writer.write(label.first);
+        writer.write(label.second);
+    }
+    writer.write<uint64_t>(rewardModels.size());
+    for (auto const& rewardModel : rewardModels) {
+        writer.write(std::get<0>(rewardModel));
+        for (auto const& component : {std::get<1>(rewardModel), std::get<2>(rewardModel), std::get<3>(rewardModel)}) {
+            writer.write<uint8_t>(component.has_value());
+            if (component) {
+                writer.write(component.value());
+            }
+        }
+    }
+}
+
+std::shared_ptr<storm::models::ModelBase> loadSymbolicModel(std::string const& file) {
+    BinaryReader reader(file);
+    STORM_LOG_THROW(reader.readString() == FileMagic, storm::exceptions::WrongFormatException, "File " << file << " does not contain a symbolic model.");
+    uint32_t version = reader.read<uint32_t>();
+    STORM_LOG_THROW(version == FileVersion, storm::exceptions::WrongFormatException, "Unsupported file version " << version << ".");
+    auto type = static_cast<storm::models::ModelType>(reader.read<uint64_t>());
+    STORM_LOG_THROW(type == storm::models::ModelType::Dtmc || type == storm::models::ModelType::Ctmc || type == storm::models::ModelType::Mdp, storm::exceptions::WrongFormatException, "Unsupported model type " << type << ".");
+
+    auto manager = std::make_shared<Manager>();
+    std::vector<MetaVariableInfo> infos(reader.read<uint64_t>());
+    for (auto& info : infos) {
+        info.name = reader.readString();
+        info.type = static_cast<storm::dd::MetaVariableType>(reader.read<uint64_t>());
+        info.low = reader.read<int64_t>();
+        info.high = reader.read<int64_t>();
+        info.indices.resize(reader.read<uint64_t>());
+        for (auto& index : info.indices) {
+            index = reader.read<uint64_t>();
+        }
+    }
+    std::unordered_map<uint64_t, Bdd> ddVariables;
+    std::map<std::string, storm::expressions::Variable> metaVariables = createMetaVariables(*manager, infos, ddVariables);
+    std::vector<DdNode> bddNodes = readNodes(reader);
+    std::vector<DdNode> addNodes = readNodes(reader);
+    SylvanOperationRecorder recorder("load");
+    DdDecoder decoder(*manager, ddVariables, bddNodes, addNodes);
+
+    std::set<storm::expressions::Variable> rowVariables = readVariables(reader, metaVariables);
+    std::set<storm::expressions::Variable> columnVariables = readVariables(reader, metaVariables);
+    std::vector<std::pair<storm::expressions::Variable, storm::expressions::Variable>> rowColumnPairs(reader.read<uint64_t>());
+    for (auto& pair : rowColumnPairs) {
+        pair.first = metaVariables.at(reader.readString());
+        pair.second = metaVariables.at(reader.readString());
+    }
+    std::set<storm::expressions::Variable> nondeterminismVariables;
+    if (type == storm::models::ModelType::Mdp) {
+        nondeterminismVariables = readVariables(reader, metaVariables);
+    }
+
+    Bdd reachableStates = decoder.getBdd(reader.read<uint64_t>());
+    Bdd initialStates = decoder.getBdd(reader.read<uint64_t>());
+    Bdd deadlockStates = decoder.getBdd(reader.read<uint64_t>());
+    Add transitionMatrix = decoder.getAdd(reader.read<uint64_t>());
+    boost::optional<Add> exitRates;
+    if (type == storm::models::ModelType::Ctmc) {
+        exitRates = decoder.getAdd(reader.read<uint64_t>());
+    }
+    std::map<std::string, Bdd> labels;
+    uint64_t nrLabels = reader.read<uint64_t>();
+    for (uint64_t i = 0; i < nrLabels; ++i) {
+        std::string label = reader.readString();
+        labels.emplace(label, decoder.getBdd(reader.read<uint64_t>()));
+    }
+    std::unordered_map<std::string, SymbolicRewardModel> rewardModels;
+    uint64_t nrRewardModels = reader.read<uint64_t>();
+    for (uint64_t i = 0; i < nrRewardModels; ++i) {
+        std::string name = reader.readString();
+        std::vector<boost::optional<Add>> components;
+        for (uint64_t component = 0; component < 3; ++component) {
+            if (reader.read<uint8_t>()) {
+                components.push_back(decoder.getAdd(reader.read<uint64_t>()));
+            } else {
+                components.push_back(boost::none);
+            }
+        }
+        rewardModels.emplace(name, SymbolicRewardModel(components[0], components[1], components[2]));
+    }
+
+    if (type == storm::models::ModelType::Dtmc) {
+        return std::make_shared<storm::models::symbolic::Dtmc<Library, double>>(manager, reachableStates, initialStates, deadlockStates, transitionMatrix, rowVariables, columnVariables, rowColumnPairs, labels, rewardModels);
+    } else if (type == storm::models::ModelType::Ctmc) {
+        return std::make_shared<storm::models::symbolic::Ctmc<Library, double>>(manager, reachableStates, initialStates, deadlockStates, transitionMatrix, exitRates, rowVariables, columnVariables, rowColumnPairs, labels, rewardModels);
+    } else {
+        return std::make_shared<storm::models::symbolic::Mdp<Library, double>>(manager, reachableStates, initialStates, deadlockStates, transitionMatrix, rowVariables, columnVariables, rowColumnPairs, nondeterminismVariables, labels, rewardModels);
+    }
+}
+
+void define_symbolic_io(py::module& m) {
+    m.def("_export_symbolic_model", &exportSymbolicModel, py::arg("model"), py::arg("file"), py::call_guard<py::gil_scoped_release>(), R"doc(
+        Export a symbolic model into a binary file.
+
+        :param model: Symbolic DTMC, CTMC or MDP with double values.
+        :param file: Path of the file.
+        )doc");
+    m.def("_load_symbolic_model", &loadSymbolicModel, py::arg("file"), py::call_guard<py::gil_scoped_release>(), R"doc(
+        Load a symbolic model from a binary file created by _export_symbolic_model.
+
+        :param file: Path of the file.
+        :return: Symbolic model in a new DD manager.
+        )doc");
+}
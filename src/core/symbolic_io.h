@@ -0,0 +1,5 @@
+#pragma once
+
+#include "common.h"
+
+void define_symbolic_io(py::module& m);
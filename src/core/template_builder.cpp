@@ -0,0 +1,208 @@
+#include "template_builder.h"
+
+#include <set>
+#include <unordered_map>
+
+#include "storm/adapters/RationalFunctionAdapter.h"
+#include "storm/api/builder.h"
+#include "storm/models/sparse/Ctmc.h"
+#include "storm/models/sparse/Dtmc.h"
+#include "storm/models/sparse/Mdp.h"
+#include "storm/models/sparse/StandardRewardModel.h"
+#include "storm/storage/SymbolicModelDescription.h"
+#include "storm/storage/sparse/ModelComponents.h"
+#include "storm/utility/builder.h"
+#include "storm/utility/constants.h"
+#include "storm/utility/parametric.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+#include "storm/exceptions/NotSupportedException.h"
+
+/*!
+ * Builder for repeated instantiations of a model whose undefined constants only influence the values of transitions and rewards.
+ * The state space is explored once with the undefined constants as parameters. For every matrix entry and reward, the function
+ * computing its value from the constants is recorded. An instantiation evaluates each distinct function once and writes the
+ * values into a copy of the template model, without exploring the state space again.
+ */
+class TemplateModelBuilder {
+   public:
+    typedef storm::utility::parametric::Valuation<storm::RationalFunction> Valuation;
+
+    TemplateModelBuilder(storm::storage::SymbolicModelDescription const& description, std::vector<std::shared_ptr<storm::logic::Formula const>> const& formulas) {
+        bool graphPreserving = description.isPrismProgram() ? description.asPrismProgram().undefinedConstantsAreGraphPreserving() : description.asJaniModel().undefinedConstantsAreGraphPreserving();
+        STORM_LOG_THROW(graphPreserving, storm::exceptions::InvalidArgumentException, "The undefined constants change the structure of the model, a template build is not possible.");
+        if (description.isPrismProgram()) {
+            for (auto const& constant : description.asPrismProgram().getUndefinedConstants()) {
+                undefinedConstants.insert(constant.get().getName());
+            }
+        } else {
+            for (auto const& constant : description.asJaniModel().getUndefinedConstants()) {
+                undefinedConstants.insert(constant.get().getName());
+            }
+        }
+        auto parametricModel = storm::api::buildSparseModel<storm::RationalFunction>(description, formulas)->template as<storm::models::sparse::Model<storm::RationalFunction>>();
+        STORM_LOG_THROW(parametricModel->isOfType(storm::models::ModelType::Dtmc) || parametricModel->isOfType(storm::models::ModelType::Ctmc) || parametricModel->isOfType(storm::models::ModelType::Mdp),
+                        storm::exceptions::NotSupportedException, "Template builds are only supported for DTMCs, CTMCs and MDPs.");
+        for (auto const& parameter : storm::models::sparse::getAllParameters(*parametricModel)) {
+            parameters.emplace(parameter.name(), parameter);
+        }
+
+        // Record the function of every entry and build the template with the same structure
+        auto const& matrix = parametricModel->getTransitionMatrix();
+        bool nondeterministic = !matrix.hasTrivialRowGrouping();
+        storm::storage::SparseMatrixBuilder<double> builder(matrix.getRowCount(), matrix.getColumnCount(), matrix.getEntryCount(), true, nondeterministic, nondeterministic ? matrix.getRowGroupCount() : 0);
+        for (uint64_t group = 0; group < matrix.getRowGroupCount(); ++group) {
+            if (nondeterministic) {
+                builder.newRowGroup(matrix.getRowGroupIndices()[group]);
+            }
+            for (uint64_t row = matrix.getRowGroupIndices()[group]; row < matrix.getRowGroupIndices()[group + 1]; ++row) {
+                for (auto const& entry : matrix.getRow(row)) {
+                    // The placeholder is overwritten by each instantiation
+                    builder.addNextValue(row, entry.getColumn(), storm::utility::one<double>());
+                    entryFunctions.push_back(getFunctionIndex(entry.getValue()));
+                }
+            }
+        }
+
+        std::unordered_map<std::string, storm::models::sparse::StandardRewardModel<double>> rewardModels;
+        for (auto const& entry : parametricModel->getRewardModels()) {
+            auto const& rewardModel = entry.second;
+            STORM_LOG_THROW(!rewardModel.hasTransitionRewards(), storm::exceptions::NotSupportedException, "Template builds do not support transition rewards.");
+            RewardFunctions functions;
+            boost::optional<std::vector<double>> stateRewards;
+            boost::optional<std::vector<double>> stateActionRewards;
+            if (rewardModel.hasStateRewards()) {
+                for (auto const& reward : rewardModel.getStateRewardVector()) {
+                    functions.stateRewards.push_back(getFunctionIndex(reward));
+                }
+                stateRewards = std::vector<double>(functions.stateRewards.size());
+            }
+            if (rewardModel.hasStateActionRewards()) {
+                for (auto const& reward : rewardModel.getStateActionRewardVector()) {
+                    functions.stateActionRewards.push_back(getFunctionIndex(reward));
+                }
+                stateActionRewards = std::vector<double>(functions.stateActionRewards.size());
+            }
+            rewardFunctions.emplace(entry.first, std::move(functions));
+            rewardModels.emplace(entry.first, storm::models::sparse::StandardRewardModel<double>(std::move(stateRewards), std::move(stateActionRewards)));
+        }
+
+        storm::storage::sparse::ModelComponents<double> components(builder.build(), parametricModel->getStateLabeling(), std::move(rewardModels),
+                                                                   parametricModel->isOfType(storm::models::ModelType::Ctmc));
+        components.choiceLabeling = parametricModel->getOptionalChoiceLabeling();
+        components.stateValuations = parametricModel->getOptionalStateValuations();
+        templateModel = storm::utility::builder::buildModelFromComponents(parametricModel->getType(), std::move(components));
+    }
+
+    std::vector<std::string> getParameters() const {
+        std::vector<std::string> result;
+        for (auto const& entry : parameters) {
+            result.push_back(entry.first);
+        }
+        return result;
+    }
+
+    uint64_t getNumberOfFunctions() const {
+        return functions.size();
+    }
+
+    std::shared_ptr<storm::models::sparse::Model<double>> getTemplateModel() const {
+        return templateModel;
+    }
+
+    std::shared_ptr<storm::models::sparse::Model<double>> instantiate(std::map<std::string, double> const& values) const {
+        Valuation valuation;
+        for (auto const& entry : values) {
+            auto parameter = parameters.find(entry.first);
+            if (parameter == parameters.end()) {
+                // Undefined constants on which no transition or reward value depends do not need a value
+                STORM_LOG_THROW(undefinedConstants.count(entry.first) > 0, storm::exceptions::InvalidArgumentException, "'" << entry.first << "' is not an undefined constant of the model.");
+                continue;
+            }
+            valuation[parameter->second] = storm::utility::convertNumber<storm::RationalFunctionCoefficient>(entry.second);
+        }
+        for (auto const& parameter : parameters) {
+            STORM_LOG_THROW(valuation.count(parameter.second) > 0, storm::exceptions::InvalidArgumentException, "No value given for parameter '" << parameter.first << "'.");
+        }
+
+        std::vector<double> functionValues;
+        functionValues.reserve(functions.size());
+        for (auto const& function : functions) {
+            functionValues.push_back(storm::utility::convertNumber<double>(storm::utility::parametric::evaluate(function, valuation)));
+        }
+
+        auto model = copyTemplate();
+        auto& matrix = model->getTransitionMatrix();
+        uint64_t entry = 0;
+        for (auto it = matrix.begin(); it != matrix.end(); ++it, ++entry) {
+            it->setValue(functionValues[entryFunctions[entry]]);
+        }
+        for (auto const& rewardEntry : rewardFunctions) {
+            auto& rewardModel = model->getRewardModel(rewardEntry.first);
+            for (uint64_t state = 0; state < rewardEntry.second.stateRewards.size(); ++state) {
+                rewardModel.getStateRewardVector()[state] = functionValues[rewardEntry.second.stateRewards[state]];
+            }
+            for (uint64_t row = 0; row < rewardEntry.second.stateActionRewards.size(); ++row) {
+                rewardModel.getStateActionRewardVector()[row] = functionValues[rewardEntry.second.stateActionRewards[row]];
+            }
+        }
+        if (model->isOfType(storm::models::ModelType::Ctmc)) {
+            auto& exitRates = model->template as<storm::models::sparse::Ctmc<double>>()->getExitRateVector();
+            for (uint64_t state = 0; state < matrix.getRowCount(); ++state) {
+                exitRates[state] = matrix.getRowSum(state);
+            }
+        }
+        return model;
+    }
+
+   private:
+    struct RewardFunctions {
+        std::vector<uint64_t> stateRewards;
+        std::vector<uint64_t> stateActionRewards;
+    };
+
+    uint64_t getFunctionIndex(storm::RationalFunction const& function) {
+        auto result = functionIndices.emplace(function, functions.size());
+        if (result.second) {
+            functions.push_back(function);
+        }
+        return result.first->second;
+    }
+
+    std::shared_ptr<storm::models::sparse::Model<double>> copyTemplate() const {
+        if (templateModel->isOfType(storm::models::ModelType::Dtmc)) {
+            return std::make_shared<storm::models::sparse::Dtmc<double>>(*templateModel->template as<storm::models::sparse::Dtmc<double>>());
+        } else if (templateModel->isOfType(storm::models::ModelType::Ctmc)) {
+            return std::make_shared<storm::models::sparse::Ctmc<double>>(*templateModel->template as<storm::models::sparse::Ctmc<double>>());
+        } else {
+            return std::make_shared<storm::models::sparse::Mdp<double>>(*templateModel->template as<storm::models::sparse::Mdp<double>>());
+        }
+    }
+
+    std::map<std::string, storm::RationalFunctionVariable> parameters;
+    std::set<std::string> undefinedConstants;
+    // Distinct functions occurring in the model
+    std::vector<storm::RationalFunction> functions;
+    std::unordered_map<storm::RationalFunction, uint64_t> functionIndices;
+    // Function of each matrix entry, in the order of the entries
+    std::vector<uint64_t> entryFunctions;
+    std::map<std::string, RewardFunctions> rewardFunctions;
+    std::shared_ptr<storm::models::sparse::Model<double>> templateModel;
+};
+
+void define_template_builder(py::module& m) {
+    py::class_<TemplateModelBuilder, std::shared_ptr<TemplateModelBuilder>>(m, "TemplateModelBuilder", R"doc(
+        Builder for repeated instantiations of a model whose undefined constants are graph-preserving.
+        The state space is explored once; each instantiation only re-evaluates the transition and reward values.
+        )doc")
+        .def(py::init<storm::storage::SymbolicModelDescription const&, std::vector<std::shared_ptr<storm::logic::Formula const>> const&>(), R"doc(
+            Explore the state space of the description with its undefined constants as parameters.
+
+            :param symbolic_description: Symbolic description whose undefined constants are graph-preserving.
+            :param formulas: Formulas to preserve. If empty, all labels and reward models are built.
+            )doc", py::arg("symbolic_description"), py::arg("formulas") = std::vector<std::shared_ptr<storm::logic::Formula const>>(), py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("parameters", &TemplateModelBuilder::getParameters, "Names of the undefined constants on which transition or reward values depend")
+        .def_property_readonly("nr_functions", &TemplateModelBuilder::getNumberOfFunctions, "Number of distinct functions evaluated per instantiation")
+        .def_property_readonly("template_model", &TemplateModelBuilder::getTemplateModel, "Model with the structure of all instantiations and placeholder values")
+        .def("instantiate", &TemplateModelBuilder::instantiate, "Instantiate the model for the given values of the undefined constants. Values for constants that are not parameters are ignored", py::arg("values"), py::call_guard<py::gil_scoped_release>())
+    ;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "common.h"
+
+void define_template_builder(py::module& m);
@@ -3,6 +3,7 @@
 #include "storm/models/symbolic/StandardRewardModel.h"
 #include "storm/transformer/SubsystemBuilder.h"
 #include "storm/transformer/EndComponentEliminator.h"
+#include "src/storage/parallel_mec.h"
 
 // Thin wrappers.
 template<typename VT>
@@ -20,8 +21,20 @@ typename storm::transformer::EndComponentEliminator<ValueType>::EndComponentElim
                                                                                  storm::storage::BitVector const& subsystemStates,
                                                                                  storm::storage::BitVector const& possibleECRows,
                                                                                  storm::storage::BitVector const& addSinkRowStates,
-                                                                                 bool addSelfLoopAtSinkStates) {
-    return storm::transformer::EndComponentEliminator<ValueType>::transform(matrix, subsystemStates, possibleECRows, addSinkRowStates, addSelfLoopAtSinkStates);
+                                                                                 bool addSelfLoopAtSinkStates,
+                                                                                 uint64_t numberOfThreads) {
+    if (numberOfThreads == 1) {
+        return storm::transformer::EndComponentEliminator<ValueType>::transform(matrix, subsystemStates, possibleECRows, addSinkRowStates, addSelfLoopAtSinkStates);
+    }
+    // Same candidates as in the eliminator: subsystem states with a possible EC row. Rows leaving the subsystem are removed by the decomposition.
+    storm::storage::BitVector ecStates(subsystemStates);
+    for (uint64_t state : subsystemStates) {
+        if (possibleECRows.getNextSetIndex(matrix.getRowGroupIndices()[state]) >= matrix.getRowGroupIndices()[state + 1]) {
+            ecStates.set(state, false);
+        }
+    }
+    ParallelMaximalEndComponentDecomposition<ValueType> ecs(matrix, ecStates, possibleECRows, numberOfThreads);
+    return storm::transformer::EndComponentEliminator<ValueType>::transform(matrix, ecs, subsystemStates, addSinkRowStates, addSelfLoopAtSinkStates);
 }
 
 
@@ -59,7 +72,7 @@ void define_transformation(py::module& m) {
             .def_readonly("old_to_new_state_mapping", &storm::transformer::EndComponentEliminator<double>::EndComponentEliminatorReturnType::oldToNewStateMapping, "For each state of the original matrix (and subsystem) the corresponding state in the result. Removed states are mapped to the EC.")
             .def_readonly("sink_rows", &storm::transformer::EndComponentEliminator<double>::EndComponentEliminatorReturnType::sinkRows, "Rows that indicate staying in the EC forever");
 
-    m.def("_eliminate_end_components_double", &eliminateECs<double>, "Eliminate ECs in the subystem", py::arg("matrix"), py::arg("subsystem"),  py::arg("possible_ec_rows"),py::arg("addSinkRowStates"), py::arg("addSelfLoopAtSinkStates"));
+    m.def("_eliminate_end_components_double", &eliminateECs<double>, "Eliminate ECs in the subystem", py::arg("matrix"), py::arg("subsystem"),  py::arg("possible_ec_rows"),py::arg("addSinkRowStates"), py::arg("addSelfLoopAtSinkStates"), py::arg("nr_threads") = 1, py::call_guard<py::gil_scoped_release>());
 
 }
 
@@ -0,0 +1,284 @@
+#include "variable_order.h"
+
+#include "storm/storage/prism/Program.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+
+#include <map>
+#include <set>
+#include <numeric>
+
+/*
+ * Static variable orders for symbolic model building.
+ *
+ * The DD variables of the symbolic builder follow the declaration order of the PRISM program:
+ * global variables first, then the variables of each module, integer variables before Boolean ones.
+ * A different order is therefore obtained by rearranging modules and the variables within modules.
+ */
+
+using storm::prism::Program;
+using storm::prism::Module;
+
+namespace {
+
+    // Variables in the order in which the symbolic builder creates DD variables for them
+    std::vector<std::string> getVariableOrder(Program const& program) {
+        std::vector<std::string> order;
+        for (auto const& variable : program.getGlobalIntegerVariables()) {
+            order.push_back(variable.getName());
+        }
+        for (auto const& variable : program.getGlobalBooleanVariables()) {
+            order.push_back(variable.getName());
+        }
+        for (auto const& module : program.getModules()) {
+            for (auto const& variable : module.getIntegerVariables()) {
+                order.push_back(variable.getName());
+            }
+            for (auto const& variable : module.getBooleanVariables()) {
+                order.push_back(variable.getName());
+            }
+        }
+        return order;
+    }
+
+    /*!
+     * Weighted interaction graph between variables.
+     * Two variables interact if one is written by a command that reads or writes the other.
+     * Commands synchronizing on the same action are treated as one command, as they are executed jointly.
+     */
+    std::map<std::string, std::map<std::string, uint64_t>> computeInteractions(Program const& program) {
+        std::map<uint64_t, std::pair<std::set<std::string>, std::set<std::string>>> actionReadWrite;
+        std::map<std::string, std::map<std::string, uint64_t>> interactions;
+
+        auto connect = [&interactions](std::set<std::string> const& written, std::set<std::string> const& accessed) {
+            for (auto const& first : written) {
+                for (auto const& second : accessed) {
+                    if (first != second) {
+                        ++interactions[first][second];
+                        ++interactions[second][first];
+                    }
+                }
+            }
+        };
+
+        for (auto const& module : program.getModules()) {
+            for (auto const& command : module.getCommands()) {
+                std::set<std::string> read;
+                std::set<std::string> written;
+                for (auto const& variable : command.getGuardExpression().getVariables()) {
+                    read.insert(variable.getName());
+                }
+                for (auto const& update : command.getUpdates()) {
+                    for (auto const& assignment : update.getAssignments()) {
+                        written.insert(assignment.getVariableName());
+                        for (auto const& variable : assignment.getExpression().getVariables()) {
+                            read.insert(variable.getName());
+                        }
+                    }
+                }
+                if (command.isLabeled()) {
+                    auto& entry = actionReadWrite[command.getActionIndex()];
+                    entry.first.insert(read.begin(), read.end());
+                    entry.second.insert(written.begin(), written.end());
+                } else {
+                    read.insert(written.begin(), written.end());
+                    connect(written, read);
+                }
+            }
+        }
+        for (auto& entry : actionReadWrite) {
+            std::set<std::string>& accessed = entry.second.first;
+            accessed.insert(entry.second.second.begin(), entry.second.second.end());
+            connect(entry.second.second, accessed);
+        }
+        return interactions;
+    }
+
+    /*!
+     * Greedy linear arrangement: start with the item with the largest total weight
+     * and repeatedly append the item most strongly connected to the already placed ones.
+     * Connections to recently placed items weigh more, which keeps interacting items close together.
+     * Ties are broken by the original position.
+     */
+    std::vector<uint64_t> arrange(std::vector<std::vector<uint64_t>> const& weights) {
+        uint64_t size = weights.size();
+        std::vector<uint64_t> result;
+        std::vector<bool> placed(size, false);
+        std::vector<double> attraction(size, 0.0);
+        for (uint64_t i = 0; i < size; ++i) {
+            attraction[i] = std::accumulate(weights[i].begin(), weights[i].end(), 0.0) * 1e-6;
+        }
+        while (result.size() < size) {
+            uint64_t best = size;
+            for (uint64_t i = 0; i < size; ++i) {
+                if (!placed[i] && (best == size || attraction[i] > attraction[best])) {
+                    best = i;
+                }
+            }
+            placed[best] = true;
+            result.push_back(best);
+            for (uint64_t i = 0; i < size; ++i) {
+                if (!placed[i]) {
+                    attraction[i] = attraction[i] / 2 + weights[best][i];
+                }
+            }
+        }
+        return result;
+    }
+
+    // Order the given variables by the interaction heuristic
+    std::vector<std::string> arrangeVariables(std::vector<std::string> const& variables, std::map<std::string, std::map<std::string, uint64_t>> const& interactions) {
+        std::vector<std::vector<uint64_t>> weights(variables.size(), std::vector<uint64_t>(variables.size(), 0));
+        for (uint64_t i = 0; i < variables.size(); ++i) {
+            auto it = interactions.find(variables[i]);
+            if (it == interactions.end()) {
+                continue;
+            }
+            for (uint64_t j = 0; j < variables.size(); ++j) {
+                auto weight = it->second.find(variables[j]);
+                if (weight != it->second.end()) {
+                    weights[i][j] = weight->second;
+                }
+            }
+        }
+        std::vector<std::string> result;
+        for (auto index : arrange(weights)) {
+            result.push_back(variables[index]);
+        }
+        return result;
+    }
+
+    std::vector<std::string> computeVariableOrder(Program const& program) {
+        auto interactions = computeInteractions(program);
+        std::vector<std::string> order;
+
+        std::vector<std::string> globalIntegers, globalBooleans;
+        for (auto const& variable : program.getGlobalIntegerVariables()) {
+            globalIntegers.push_back(variable.getName());
+        }
+        for (auto const& variable : program.getGlobalBooleanVariables()) {
+            globalBooleans.push_back(variable.getName());
+        }
+        for (auto const& name : arrangeVariables(globalIntegers, interactions)) {
+            order.push_back(name);
+        }
+        for (auto const& name : arrangeVariables(globalBooleans, interactions)) {
+            order.push_back(name);
+        }
+
+        // Arrange modules by the interactions between their variables
+        auto const& modules = program.getModules();
+        std::map<std::string, uint64_t> variableToModule;
+        for (uint64_t i = 0; i < modules.size(); ++i) {
+            for (auto const& variable : modules[i].getIntegerVariables()) {
+                variableToModule[variable.getName()] = i;
+            }
+            for (auto const& variable : modules[i].getBooleanVariables()) {
+                variableToModule[variable.getName()] = i;
+            }
+        }
+        std::vector<std::vector<uint64_t>> moduleWeights(modules.size(), std::vector<uint64_t>(modules.size(), 0));
+        for (auto const& entry : interactions) {
+            auto first = variableToModule.find(entry.first);
+            if (first == variableToModule.end()) {
+                continue;
+            }
+            for (auto const& weight : entry.second) {
+                auto second = variableToModule.find(weight.first);
+                if (second != variableToModule.end() && first->second != second->second) {
+                    moduleWeights[first->second][second->second] += weight.second;
+                }
+            }
+        }
+
+        for (auto moduleIndex : arrange(moduleWeights)) {
+            std::vector<std::string> integers, booleans;
+            for (auto const& variable : modules[moduleIndex].getIntegerVariables()) {
+                integers.push_back(variable.getName());
+            }
+            for (auto const& variable : modules[moduleIndex].getBooleanVariables()) {
+                booleans.push_back(variable.getName());
+            }
+            for (auto const& name : arrangeVariables(integers, interactions)) {
+                order.push_back(name);
+            }
+            for (auto const& name : arrangeVariables(booleans, interactions)) {
+                order.push_back(name);
+            }
+        }
+        return order;
+    }
+
+    template<typename VariableType>
+    std::vector<VariableType> sortVariables(std::vector<VariableType> variables, std::map<std::string, uint64_t> const& position) {
+        std::stable_sort(variables.begin(), variables.end(), [&position](VariableType const& a, VariableType const& b) {
+            return position.at(a.getName()) < position.at(b.getName());
+        });
+        return variables;
+    }
+
+    /*!
+     * Rearrange modules and their variables to follow the given order as closely as possible.
+     * Modules are ordered by the first position of one of their variables, variables not contained in the order keep their relative position behind the given ones.
+     */
+    Program applyVariableOrder(Program const& program, std::vector<std::string> const& order) {
+        std::vector<std::string> currentOrder = getVariableOrder(program);
+        std::set<std::string> variables(currentOrder.begin(), currentOrder.end());
+        std::map<std::string, uint64_t> position;
+        for (auto const& name : order) {
+            STORM_LOG_THROW(variables.count(name) > 0, storm::exceptions::InvalidArgumentException, "The program has no variable " << name << ".");
+            STORM_LOG_THROW(position.count(name) == 0, storm::exceptions::InvalidArgumentException, "Variable " << name << " occurs twice in the order.");
+            position.emplace(name, position.size());
+        }
+        for (auto const& name : currentOrder) {
+            position.emplace(name, position.size());
+        }
+
+        std::vector<Module> modules;
+        std::vector<uint64_t> firstPosition;
+        for (auto const& module : program.getModules()) {
+            uint64_t first = std::numeric_limits<uint64_t>::max();
+            for (auto const& variable : module.getIntegerVariables()) {
+                first = std::min(first, position.at(variable.getName()));
+            }
+            for (auto const& variable : module.getBooleanVariables()) {
+                first = std::min(first, position.at(variable.getName()));
+            }
+            modules.emplace_back(module.getName(), sortVariables(module.getBooleanVariables(), position), sortVariables(module.getIntegerVariables(), position), module.getClockVariables(),
+                                 module.getInvariant(), module.getCommands(), module.getFilename(), module.getLineNumber());
+            firstPosition.push_back(first);
+        }
+        std::vector<uint64_t> moduleOrder(modules.size());
+        std::iota(moduleOrder.begin(), moduleOrder.end(), 0);
+        std::stable_sort(moduleOrder.begin(), moduleOrder.end(), [&firstPosition](uint64_t a, uint64_t b) { return firstPosition[a] < firstPosition[b]; });
+        std::vector<Module> orderedModules;
+        for (auto index : moduleOrder) {
+            orderedModules.push_back(modules[index]);
+        }
+        return program.replaceModulesAndConstantsInProgram(orderedModules, program.getConstants());
+    }
+}
+
+void define_variable_order(py::module& m) {
+    m.def("get_variable_order", &getVariableOrder, py::arg("program"), R"doc(
+        Get the order of the variables of a PRISM program as used for the DD variables by the symbolic builder.
+        Global variables come first, followed by the variables of each module with integer variables before Boolean ones.
+
+        :param program: PRISM program.
+        :return: List of variable names.
+        )doc");
+    m.def("compute_variable_order", &computeVariableOrder, py::arg("program"), R"doc(
+        Compute a static variable order for symbolic building from the interaction graph of the program.
+        Variables written by the same (synchronized) command are placed close to each other, and modules are arranged by the interactions between their variables.
+
+        :param program: PRISM program.
+        :return: List of variable names which can be passed to apply_variable_order, stored and reused for other instances of the same model.
+        )doc");
+    m.def("apply_variable_order", &applyVariableOrder, py::arg("program"), py::arg("order"), R"doc(
+        Rearrange the modules and variable declarations of a PRISM program such that symbolic building follows the given variable order as closely as possible.
+        The model is not changed, only the order of declarations.
+
+        :param program: PRISM program.
+        :param order: List of variable names. Variables not in the list are placed behind the listed ones.
+        :return: PRISM program with rearranged declarations.
+        )doc");
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "common.h"
+
+void define_variable_order(py::module& m);
@@ -0,0 +1,478 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <map>
+
+#include "net.h"
+#include "src/parallel.h"
+
+#include "storm/logic/Formulas.h"
+#include "storm/models/sparse/StandardRewardModel.h"
+#include "storm/models/sparse/StateLabeling.h"
+#include "storm/storage/BitVector.h"
+#include "storm/storage/BitVectorHashMap.h"
+#include "storm/storage/SparseMatrix.h"
+#include "storm/storage/expressions/ExpressionEvaluator.h"
+#include "storm/storage/sparse/ModelComponents.h"
+#include "storm/utility/builder.h"
+#include "storm/exceptions/NotSupportedException.h"
+#include "storm/exceptions/OutOfRangeException.h"
+
+/*!
+ * Options for the native GSPN state-space exploration.
+ */
+struct GspnExplorationOptions {
+    // If true, vanishing markings are eliminated on the fly and the result is a CTMC.
+    // Otherwise, vanishing markings are kept as probabilistic states of a Markov automaton.
+    bool eliminateVanishing = true;
+    // Number of threads used to expand a BFS layer (0 = all hardware threads).
+    uint64_t numberOfThreads = 0;
+    // Number of bits reserved for places without a restricted capacity.
+    uint64_t unboundedPlaceBits = 8;
+    // If true, P-invariants are used to bound places and to omit places whose tokens are implied by an invariant.
+    bool useInvariants = false;
+};
+
+/*!
+ * Bit-packed layout of a marking: every place gets as many bits as needed to represent its bound.
+ * Places can be implicit, i.e., their number of tokens is derived from a P-invariant and not stored.
+ */
+class MarkingLayout {
+   public:
+    MarkingLayout(GspnNet const& net, uint64_t unboundedPlaceBits, std::vector<Invariant> const& placeInvariants = {}) {
+        uint64_t numberOfPlaces = net.places.size();
+        offsets.resize(numberOfPlaces);
+        bits.resize(numberOfPlaces);
+        maxTokens.resize(numberOfPlaces);
+        restricted.resize(numberOfPlaces, false);
+        implicit.resize(numberOfPlaces);
+
+        std::vector<boost::optional<uint64_t>> bounds = computePlaceBounds(net, placeInvariants);
+        for (uint64_t id = 0; id < numberOfPlaces; ++id) {
+            restricted[id] = net.places[id].capacity.is_initialized();
+            if (bounds[id]) {
+                maxTokens[id] = *bounds[id];
+                bits[id] = bitsFor(*bounds[id]);
+            } else {
+                STORM_LOG_THROW(unboundedPlaceBits > 0 && unboundedPlaceBits < 64, storm::exceptions::OutOfRangeException, "Invalid number of bits for unbounded places.");
+                maxTokens[id] = (1ull << unboundedPlaceBits) - 1;
+                bits[id] = unboundedPlaceBits;
+            }
+        }
+
+        // Make one place per invariant implicit, as long as its value only depends on explicitly stored places
+        std::vector<bool> referenced(numberOfPlaces, false);
+        for (auto const& invariant : placeInvariants) {
+            uint64_t weightedSum = 0;
+            for (uint64_t p = 0; p < numberOfPlaces; ++p) {
+                weightedSum += invariant[p] * net.places[p].initialTokens;
+            }
+            bool dependsOnImplicit = false;
+            for (uint64_t p = 0; p < numberOfPlaces; ++p) {
+                dependsOnImplicit |= (invariant[p] > 0 && implicit[p]);
+            }
+            if (dependsOnImplicit) {
+                continue;
+            }
+            for (uint64_t p = 0; p < numberOfPlaces; ++p) {
+                if (invariant[p] > 0 && !referenced[p]) {
+                    implicit[p] = ImplicitPlace{invariant, weightedSum};
+                    bits[p] = 0;
+                    for (uint64_t q = 0; q < numberOfPlaces; ++q) {
+                        referenced[q] = referenced[q] || (invariant[q] > 0 && q != p);
+                    }
+                    break;
+                }
+            }
+        }
+
+        for (uint64_t id = 0; id < numberOfPlaces; ++id) {
+            offsets[id] = numberOfBits;
+            numberOfBits += bits[id];
+        }
+        // Avoid zero-length keys in the hash map
+        numberOfBits = std::max<uint64_t>(numberOfBits, 1);
+    }
+
+    uint64_t getNumberOfPlaces() const {
+        return bits.size();
+    }
+
+    uint64_t getNumberOfBits() const {
+        return numberOfBits;
+    }
+
+    uint64_t getNumberOfImplicitPlaces() const {
+        return std::count_if(implicit.begin(), implicit.end(), [](boost::optional<ImplicitPlace> const& place) { return place.is_initialized(); });
+    }
+
+    uint64_t getTokens(storm::storage::BitVector const& marking, uint64_t place) const {
+        if (implicit[place]) {
+            ImplicitPlace const& derived = *implicit[place];
+            int64_t remaining = derived.weightedSum;
+            for (uint64_t q = 0; q < derived.invariant.size(); ++q) {
+                if (q != place && derived.invariant[q] > 0) {
+                    remaining -= derived.invariant[q] * getTokens(marking, q);
+                }
+            }
+            return remaining / derived.invariant[place];
+        }
+        return bits[place] == 0 ? 0 : marking.getAsInt(offsets[place], bits[place]);
+    }
+
+    bool fits(uint64_t place, uint64_t tokens) const {
+        return tokens <= maxTokens[place];
+    }
+
+    bool hasRestrictedCapacity(uint64_t place) const {
+        return restricted[place];
+    }
+
+    void setTokens(storm::storage::BitVector& marking, uint64_t place, uint64_t tokens) const {
+        if (implicit[place]) {
+            // Implied by the other places of the invariant
+            return;
+        }
+        STORM_LOG_THROW(fits(place, tokens), storm::exceptions::OutOfRangeException,
+                        "Place " << place << " exceeds the " << bits[place] << " bits reserved for it. Increase the number of bits for unbounded places.");
+        if (bits[place] > 0) {
+            marking.setFromInt(offsets[place], bits[place], tokens);
+        }
+    }
+
+    storm::storage::BitVector getInitialMarking(GspnNet const& net) const {
+        storm::storage::BitVector marking(numberOfBits);
+        for (uint64_t id = 0; id < net.places.size(); ++id) {
+            setTokens(marking, id, net.places[id].initialTokens);
+        }
+        return marking;
+    }
+
+   private:
+    struct ImplicitPlace {
+        Invariant invariant;
+        uint64_t weightedSum;
+    };
+
+    static uint64_t bitsFor(uint64_t maxValue) {
+        uint64_t result = 0;
+        while (result < 64 && (1ull << result) <= maxValue) {
+            ++result;
+        }
+        return result;
+    }
+
+    std::vector<uint64_t> offsets;
+    std::vector<uint64_t> bits;
+    std::vector<uint64_t> maxTokens;
+    std::vector<bool> restricted;
+    std::vector<boost::optional<ImplicitPlace>> implicit;
+    uint64_t numberOfBits = 0;
+};
+
+/*!
+ * Explores the reachable markings of a GSPN without translating it to JANI first.
+ */
+class GspnExplorer {
+   public:
+    typedef std::vector<std::shared_ptr<storm::logic::Formula const>> Formulas;
+
+    GspnExplorer(GspnNet const& net, GspnExplorationOptions const& options)
+        : net(net), options(options), layout(net, options.unboundedPlaceBits, options.useInvariants ? computePlaceInvariants(net) : std::vector<Invariant>()) {
+        // Intentionally left empty
+    }
+
+    std::shared_ptr<storm::models::sparse::Model<double>> build(Formulas const& formulas = {}) {
+        storm::storage::BitVectorHashMap<uint32_t> markingToId(layout.getNumberOfBits(), 1024);
+        markings.clear();
+        auto findOrAdd = [&](storm::storage::BitVector const& marking) -> uint32_t {
+            uint32_t newId = markings.size();
+            uint32_t id = markingToId.findOrAdd(marking, newId);
+            if (id == newId) {
+                markings.push_back(marking);
+            }
+            return id;
+        };
+
+        // Initial state
+        storm::storage::BitVector initialMarking = layout.getInitialMarking(net);
+        if (options.eliminateVanishing) {
+            std::vector<std::pair<storm::storage::BitVector, double>> initialDistribution;
+            std::vector<storm::storage::BitVector> path;
+            resolveVanishing(initialMarking, 1.0, path, initialDistribution);
+            for (auto const& entry : initialDistribution) {
+                STORM_LOG_THROW(entry.first == initialDistribution.front().first, storm::exceptions::NotSupportedException,
+                                "The initial marking is vanishing and leads to several tangible markings. Disable the elimination of vanishing markings.");
+            }
+            findOrAdd(initialDistribution.front().first);
+        } else {
+            findOrAdd(initialMarking);
+        }
+
+        // Layer-wise exploration: successors of a layer are computed in parallel,
+        // ids are assigned sequentially in the order of the layer to keep the state ordering deterministic.
+        std::vector<std::vector<std::pair<uint32_t, double>>> rows;
+        std::vector<bool> markovian;
+        std::vector<bool> deadlock;
+        uint64_t numberOfEntries = 0;
+        uint64_t layerBegin = 0;
+        while (layerBegin < markings.size()) {
+            uint64_t layerEnd = markings.size();
+            std::vector<Expansion> expansions(layerEnd - layerBegin);
+            parallelFor(layerBegin, layerEnd, options.numberOfThreads, [&](uint64_t state) { expansions[state - layerBegin] = expand(markings[state]); });
+
+            for (uint64_t state = layerBegin; state < layerEnd; ++state) {
+                Expansion& expansion = expansions[state - layerBegin];
+                std::map<uint32_t, double> row;
+                for (auto const& successor : expansion.successors) {
+                    row[findOrAdd(successor.first)] += successor.second;
+                }
+                deadlock.push_back(row.empty());
+                if (row.empty()) {
+                    // Add self-loop for deadlock markings
+                    row[state] = 1.0;
+                }
+                markovian.push_back(expansion.markovian);
+                numberOfEntries += row.size();
+                rows.emplace_back(row.begin(), row.end());
+            }
+            layerBegin = layerEnd;
+        }
+
+        uint64_t numberOfStates = markings.size();
+        bool hasVanishing = std::find(markovian.begin(), markovian.end(), false) != markovian.end();
+        storm::storage::SparseMatrixBuilder<double> builder(numberOfStates, numberOfStates, numberOfEntries, true, hasVanishing, hasVanishing ? numberOfStates : 0);
+        for (uint64_t state = 0; state < numberOfStates; ++state) {
+            if (hasVanishing) {
+                builder.newRowGroup(state);
+            }
+            for (auto const& entry : rows[state]) {
+                builder.addNextValue(state, entry.first, entry.second);
+            }
+        }
+
+        storm::storage::sparse::ModelComponents<double> components(builder.build(), buildLabeling(deadlock, formulas), {}, true);
+        if (hasVanishing) {
+            storm::storage::BitVector markovianStates(numberOfStates);
+            for (uint64_t state = 0; state < numberOfStates; ++state) {
+                markovianStates.set(state, markovian[state]);
+            }
+            components.markovianStates = std::move(markovianStates);
+            return storm::utility::builder::buildModelFromComponents(storm::models::ModelType::MarkovAutomaton, std::move(components));
+        }
+        return storm::utility::builder::buildModelFromComponents(storm::models::ModelType::Ctmc, std::move(components));
+    }
+
+    /*!
+     * Markings of the states of the last built model, indexed by state.
+     */
+    std::vector<storm::storage::BitVector> const& getMarkings() const {
+        return markings;
+    }
+
+    MarkingLayout const& getLayout() const {
+        return layout;
+    }
+
+    bool isEnabled(CompiledTransition const& transition, storm::storage::BitVector const& marking) const {
+        for (auto const& arc : transition.inputs) {
+            if (layout.getTokens(marking, arc.first) < arc.second) {
+                return false;
+            }
+        }
+        for (auto const& arc : transition.inhibitors) {
+            if (layout.getTokens(marking, arc.first) >= arc.second) {
+                return false;
+            }
+        }
+        // Transitions that would exceed a restricted capacity are disabled
+        for (auto const& arc : transition.outputs) {
+            if (layout.hasRestrictedCapacity(arc.first)) {
+                uint64_t tokens = layout.getTokens(marking, arc.first) + arc.second;
+                for (auto const& input : transition.inputs) {
+                    if (input.first == arc.first) {
+                        tokens -= input.second;
+                    }
+                }
+                if (!layout.fits(arc.first, tokens)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /*!
+     * Rate of the timed transition in the given marking, taking the server semantics into account.
+     */
+    double getRate(CompiledTransition const& transition, storm::storage::BitVector const& marking) const {
+        uint64_t degree = std::numeric_limits<uint64_t>::max();
+        for (auto const& arc : transition.inputs) {
+            degree = std::min(degree, layout.getTokens(marking, arc.first) / arc.second);
+        }
+        if (degree == std::numeric_limits<uint64_t>::max()) {
+            degree = 1;
+        }
+        return transition.value * (transition.servers == 0 ? degree : std::min(degree, transition.servers));
+    }
+
+   private:
+    struct Expansion {
+        // True iff the marking is tangible, i.e., the successor values are rates.
+        bool markovian = true;
+        std::vector<std::pair<storm::storage::BitVector, double>> successors;
+    };
+
+    storm::storage::BitVector fire(CompiledTransition const& transition, storm::storage::BitVector const& marking) const {
+        storm::storage::BitVector result(marking);
+        // Compute all new token counts first, as implicit places are derived from the current marking
+        std::vector<std::pair<uint64_t, uint64_t>> changes;
+        for (auto const& arc : transition.inputs) {
+            changes.emplace_back(arc.first, layout.getTokens(marking, arc.first) - arc.second);
+        }
+        for (auto const& arc : transition.outputs) {
+            auto it = std::find_if(changes.begin(), changes.end(), [&arc](std::pair<uint64_t, uint64_t> const& change) { return change.first == arc.first; });
+            if (it != changes.end()) {
+                it->second += arc.second;
+            } else {
+                changes.emplace_back(arc.first, layout.getTokens(marking, arc.first) + arc.second);
+            }
+        }
+        for (auto const& change : changes) {
+            layout.setTokens(result, change.first, change.second);
+        }
+        return result;
+    }
+
+    /*!
+     * Collect the enabled immediate transitions of highest priority together with their normalized probabilities.
+     */
+    std::vector<std::pair<CompiledTransition const*, double>> getEnabledImmediate(storm::storage::BitVector const& marking) const {
+        std::vector<std::pair<CompiledTransition const*, double>> enabled;
+        uint64_t maxPriority = 0;
+        for (auto const& transition : net.immediateTransitions) {
+            if (isEnabled(transition, marking)) {
+                if (enabled.empty() || transition.priority > maxPriority) {
+                    enabled.clear();
+                    maxPriority = transition.priority;
+                }
+                if (transition.priority == maxPriority) {
+                    enabled.emplace_back(&transition, transition.value);
+                }
+            }
+        }
+        double totalWeight = 0;
+        for (auto const& entry : enabled) {
+            totalWeight += entry.second;
+        }
+        for (auto& entry : enabled) {
+            // Without weights, the conflict is resolved uniformly
+            entry.second = totalWeight > 0 ? entry.second / totalWeight : 1.0 / enabled.size();
+        }
+        return enabled;
+    }
+
+    /*!
+     * Follow immediate transitions from the given marking until tangible markings are reached.
+     */
+    void resolveVanishing(storm::storage::BitVector const& marking, double probability, std::vector<storm::storage::BitVector>& path,
+                          std::vector<std::pair<storm::storage::BitVector, double>>& result) const {
+        auto enabled = getEnabledImmediate(marking);
+        if (enabled.empty()) {
+            result.emplace_back(marking, probability);
+            return;
+        }
+        STORM_LOG_THROW(std::find(path.begin(), path.end(), marking) == path.end(), storm::exceptions::NotSupportedException,
+                        "The GSPN contains a cycle of immediate transitions which cannot be eliminated. Disable the elimination of vanishing markings.");
+        path.push_back(marking);
+        for (auto const& entry : enabled) {
+            if (entry.second > 0) {
+                resolveVanishing(fire(*entry.first, marking), probability * entry.second, path, result);
+            }
+        }
+        path.pop_back();
+    }
+
+    Expansion expand(storm::storage::BitVector const& marking) const {
+        Expansion expansion;
+        if (!options.eliminateVanishing) {
+            auto enabled = getEnabledImmediate(marking);
+            if (!enabled.empty()) {
+                expansion.markovian = false;
+                for (auto const& entry : enabled) {
+                    if (entry.second > 0) {
+                        expansion.successors.emplace_back(fire(*entry.first, marking), entry.second);
+                    }
+                }
+                return expansion;
+            }
+        }
+
+        std::vector<storm::storage::BitVector> path;
+        for (auto const& transition : net.timedTransitions) {
+            if (!isEnabled(transition, marking)) {
+                continue;
+            }
+            double rate = getRate(transition, marking);
+            if (options.eliminateVanishing) {
+                resolveVanishing(fire(transition, marking), rate, path, expansion.successors);
+            } else {
+                expansion.successors.emplace_back(fire(transition, marking), rate);
+            }
+        }
+        return expansion;
+    }
+
+    storm::models::sparse::StateLabeling buildLabeling(std::vector<bool> const& deadlock, Formulas const& formulas) const {
+        uint64_t numberOfStates = markings.size();
+        storm::models::sparse::StateLabeling labeling(numberOfStates);
+
+        storm::storage::BitVector initialStates(numberOfStates);
+        initialStates.set(0);
+        labeling.addLabel("init", std::move(initialStates));
+        storm::storage::BitVector deadlockStates(numberOfStates);
+        for (uint64_t state = 0; state < numberOfStates; ++state) {
+            deadlockStates.set(state, deadlock[state]);
+        }
+        labeling.addLabel("deadlock", std::move(deadlockStates));
+
+        // Atomic expressions of the formulas refer to places by their name
+        std::vector<storm::expressions::Expression> expressions;
+        for (auto const& formula : formulas) {
+            for (auto const& atomic : formula->getAtomicExpressionFormulas()) {
+                if (!labeling.containsLabel(atomic->getExpression().toString())) {
+                    expressions.push_back(atomic->getExpression());
+                    labeling.addLabel(atomic->getExpression().toString());
+                }
+            }
+        }
+        if (expressions.empty()) {
+            return labeling;
+        }
+        STORM_LOG_THROW(net.manager, storm::exceptions::NotSupportedException, "Expressions over places require an expression manager.");
+        std::vector<std::pair<uint64_t, storm::expressions::Variable>> placeVariables;
+        for (uint64_t id = 0; id < net.places.size(); ++id) {
+            if (net.manager->hasVariable(net.places[id].name)) {
+                placeVariables.emplace_back(id, net.manager->getVariable(net.places[id].name));
+            }
+        }
+        storm::expressions::ExpressionEvaluator<double> evaluator(*net.manager);
+        for (uint64_t state = 0; state < numberOfStates; ++state) {
+            for (auto const& placeVariable : placeVariables) {
+                evaluator.setIntegerValue(placeVariable.second, layout.getTokens(markings[state], placeVariable.first));
+            }
+            for (auto const& expression : expressions) {
+                if (evaluator.asBool(expression)) {
+                    labeling.addLabelToState(expression.toString(), state);
+                }
+            }
+        }
+        return labeling;
+    }
+
+    GspnNet const& net;
+    GspnExplorationOptions options;
+    MarkingLayout layout;
+    std::vector<storm::storage::BitVector> markings;
+};
@@ -1,5 +1,6 @@
 #include "gspn.h"
 #include "src/helpers.h"
+#include <pybind11/numpy.h>
 #include "storm-gspn/storage/gspn/GSPN.h"
 #include "storm-gspn/storage/gspn/GspnBuilder.h"
 #include "storm/settings/SettingsManager.h"
@@ -14,6 +15,9 @@ using ImmediateTransition = storm::gspn::ImmediateTransition<GSPN::WeightType>;
 using Transition = storm::gspn::Transition;
 using TransitionPartition = storm::gspn::TransitionPartition;
 
+template<typename T>
+using NumpyArray = py::array_t<T, py::array::c_style | py::array::forcecast>;
+
 
 void gspnToFile(GSPN const& gspn, std::string const& filepath, bool toPnpro) {
     std::ofstream fs;
@@ -29,6 +33,122 @@ void gspnToFile(GSPN const& gspn, std::string const& filepath, bool toPnpro) {
 }
 
 
+// Bulk construction from arrays to avoid one Python call per element
+void checkBulkSizes(uint64_t expected, uint64_t actual, std::string const& argument) {
+    if (expected != actual) {
+        throw std::invalid_argument("Argument '" + argument + "' has " + std::to_string(actual) + " entries, expected " + std::to_string(expected) + ".");
+    }
+}
+
+std::string bulkName(std::vector<std::string> const& names, uint64_t index) {
+    return names.empty() ? "" : names[index];
+}
+
+NumpyArray<uint64_t> addPlaces(GSPNBuilder& builder, NumpyArray<int64_t> const& capacities, NumpyArray<uint64_t> const& initialTokens, std::vector<std::string> const& names) {
+    uint64_t size = capacities.size();
+    checkBulkSizes(size, initialTokens.size(), "initial_tokens");
+    if (!names.empty()) {
+        checkBulkSizes(size, names.size(), "names");
+    }
+    NumpyArray<uint64_t> ids(size);
+    auto capacity = capacities.unchecked<1>();
+    auto tokens = initialTokens.unchecked<1>();
+    auto id = ids.mutable_unchecked<1>();
+    {
+        py::gil_scoped_release release;
+        for (uint64_t i = 0; i < size; ++i) {
+            // Negative capacity encodes an unrestricted place
+            boost::optional<uint64_t> placeCapacity;
+            if (capacity(i) >= 0) {
+                placeCapacity = static_cast<uint64_t>(capacity(i));
+            }
+            id(i) = builder.addPlace(placeCapacity, tokens(i), bulkName(names, i));
+        }
+    }
+    return ids;
+}
+
+NumpyArray<uint64_t> addImmediateTransitions(GSPNBuilder& builder, NumpyArray<uint64_t> const& priorities, NumpyArray<double> const& weights, std::vector<std::string> const& names) {
+    uint64_t size = priorities.size();
+    checkBulkSizes(size, weights.size(), "weights");
+    if (!names.empty()) {
+        checkBulkSizes(size, names.size(), "names");
+    }
+    NumpyArray<uint64_t> ids(size);
+    auto priority = priorities.unchecked<1>();
+    auto weight = weights.unchecked<1>();
+    auto id = ids.mutable_unchecked<1>();
+    {
+        py::gil_scoped_release release;
+        for (uint64_t i = 0; i < size; ++i) {
+            id(i) = builder.addImmediateTransition(priority(i), weight(i), bulkName(names, i));
+        }
+    }
+    return ids;
+}
+
+NumpyArray<uint64_t> addTimedTransitions(GSPNBuilder& builder, NumpyArray<uint64_t> const& priorities, NumpyArray<double> const& rates, boost::optional<NumpyArray<int64_t>> const& numServers, std::vector<std::string> const& names) {
+    uint64_t size = priorities.size();
+    checkBulkSizes(size, rates.size(), "rates");
+    if (numServers) {
+        checkBulkSizes(size, numServers->size(), "num_servers");
+    }
+    if (!names.empty()) {
+        checkBulkSizes(size, names.size(), "names");
+    }
+    NumpyArray<uint64_t> ids(size);
+    auto priority = priorities.unchecked<1>();
+    auto rate = rates.unchecked<1>();
+    int64_t const* servers = numServers ? numServers->data() : nullptr;
+    auto id = ids.mutable_unchecked<1>();
+    {
+        py::gil_scoped_release release;
+        for (uint64_t i = 0; i < size; ++i) {
+            if (servers) {
+                // Negative number of servers encodes infinite server semantics
+                boost::optional<uint64_t> transitionServers;
+                if (servers[i] >= 0) {
+                    transitionServers = static_cast<uint64_t>(servers[i]);
+                }
+                id(i) = builder.addTimedTransition(priority(i), rate(i), transitionServers, bulkName(names, i));
+            } else {
+                id(i) = builder.addTimedTransition(priority(i), rate(i), bulkName(names, i));
+            }
+        }
+    }
+    return ids;
+}
+
+enum class BulkArcType { Input, Output, Inhibition };
+
+void addArcs(GSPNBuilder& builder, BulkArcType type, NumpyArray<uint64_t> const& sources, NumpyArray<uint64_t> const& targets, boost::optional<NumpyArray<uint64_t>> const& multiplicities) {
+    uint64_t size = sources.size();
+    checkBulkSizes(size, targets.size(), "to");
+    if (multiplicities) {
+        checkBulkSizes(size, multiplicities->size(), "multiplicities");
+    }
+    auto source = sources.unchecked<1>();
+    auto target = targets.unchecked<1>();
+    uint64_t const* multiplicity = multiplicities ? multiplicities->data() : nullptr;
+    py::gil_scoped_release release;
+    for (uint64_t i = 0; i < size; ++i) {
+        uint_fast64_t from = source(i);
+        uint_fast64_t to = target(i);
+        uint_fast64_t mult = multiplicity ? multiplicity[i] : 1;
+        switch (type) {
+            case BulkArcType::Input:
+                builder.addInputArc(from, to, mult);
+                break;
+            case BulkArcType::Output:
+                builder.addOutputArc(from, to, mult);
+                break;
+            case BulkArcType::Inhibition:
+                builder.addInhibitionArc(from, to, mult);
+                break;
+        }
+    }
+}
+
 void define_gspn(py::module& m) {
 
     // GSPN_Builder class
@@ -94,6 +214,54 @@ void define_gspn(py::module& m) {
             :param uint64_t multiplicity: Multiplicity of the arc, default = 1.
         )doc")
 
+        // Bulk construction
+        .def("add_places", &addPlaces, "capacities"_a, "initial_tokens"_a, "names"_a = std::vector<std::string>(), R"doc(
+             Add several places to the GSPN at once.
+
+            :param numpy.ndarray capacities: The capacity of each place, negative values denote an unrestricted capacity.
+            :param numpy.ndarray initial_tokens: The number of initial tokens of each place.
+            :param list[str] names: The names of the places (optional).
+            :return: The IDs of the new places.
+        )doc")
+        .def("add_immediate_transitions", &addImmediateTransitions, "priorities"_a, "weights"_a, "names"_a = std::vector<std::string>(), R"doc(
+             Add several immediate transitions to the GSPN at once.
+
+            :param numpy.ndarray priorities: The priority of each transition.
+            :param numpy.ndarray weights: The weight of each transition.
+            :param list[str] names: The names of the transitions (optional).
+            :return: The IDs of the new transitions.
+        )doc")
+        .def("add_timed_transitions", &addTimedTransitions, "priorities"_a, "rates"_a, "num_servers"_a = boost::none, "names"_a = std::vector<std::string>(), R"doc(
+             Add several timed transitions to the GSPN at once.
+
+            :param numpy.ndarray priorities: The priority of each transition.
+            :param numpy.ndarray rates: The rate of each transition.
+            :param numpy.ndarray num_servers: The number of servers of each transition, negative values denote infinite server semantics (optional, default is single server semantics).
+            :param list[str] names: The names of the transitions (optional).
+            :return: The IDs of the new transitions.
+        )doc")
+        .def("add_input_arcs", [](GSPNBuilder& b, NumpyArray<uint64_t> const& from, NumpyArray<uint64_t> const& to, boost::optional<NumpyArray<uint64_t>> const& multiplicities) { addArcs(b, BulkArcType::Input, from, to, multiplicities); }, "from"_a, "to"_a, "multiplicities"_a = boost::none, R"doc(
+             Add several input arcs at once.
+
+            :param numpy.ndarray from: The IDs of the places from which the arcs originate.
+            :param numpy.ndarray to: The IDs of the transitions to which the arcs go.
+            :param numpy.ndarray multiplicities: The multiplicities of the arcs (optional, default = 1).
+        )doc")
+        .def("add_output_arcs", [](GSPNBuilder& b, NumpyArray<uint64_t> const& from, NumpyArray<uint64_t> const& to, boost::optional<NumpyArray<uint64_t>> const& multiplicities) { addArcs(b, BulkArcType::Output, from, to, multiplicities); }, "from"_a, "to"_a, "multiplicities"_a = boost::none, R"doc(
+             Add several output arcs at once.
+
+            :param numpy.ndarray from: The IDs of the transitions from which the arcs originate.
+            :param numpy.ndarray to: The IDs of the places to which the arcs go.
+            :param numpy.ndarray multiplicities: The multiplicities of the arcs (optional, default = 1).
+        )doc")
+        .def("add_inhibition_arcs", [](GSPNBuilder& b, NumpyArray<uint64_t> const& from, NumpyArray<uint64_t> const& to, boost::optional<NumpyArray<uint64_t>> const& multiplicities) { addArcs(b, BulkArcType::Inhibition, from, to, multiplicities); }, "from"_a, "to"_a, "multiplicities"_a = boost::none, R"doc(
+             Add several inhibition arcs at once.
+
+            :param numpy.ndarray from: The IDs of the places from which the arcs originate.
+            :param numpy.ndarray to: The IDs of the transitions to which the arcs go.
+            :param numpy.ndarray multiplicities: The multiplicities of the arcs (optional, default = 1).
+        )doc")
+
         .def("build_gspn", &GSPNBuilder::buildGspn, "Construct GSPN", "expression_manager"_a = nullptr, "constants_substitution"_a = std::map<storm::expressions::Variable, storm::expressions::Expression>())
     ;
 
@@ -0,0 +1,51 @@
+#include "gspn_explorer.h"
+#include "explorer.h"
+
+#include "storm-gspn/storage/gspn/GSPN.h"
+#include "storm-parsers/parser/FormulaParser.h"
+#include "storm/storage/expressions/ExpressionManager.h"
+#include "storm/storage/jani/Property.h"
+
+using GSPN = storm::gspn::GSPN;
+using Formulas = GspnExplorer::Formulas;
+
+// Thin wrappers
+std::shared_ptr<storm::models::sparse::Model<double>> buildSparseModelFromGspn(GSPN const& gspn, Formulas const& formulas, GspnExplorationOptions const& options) {
+    GspnNet net(gspn);
+    GspnExplorer explorer(net, options);
+    return explorer.build(formulas);
+}
+
+std::vector<storm::jani::Property> parsePropertiesForGspn(std::string const& formulaString, GSPN const& gspn) {
+    // Make every place accessible as integer variable, in the same way as the JANI translation does
+    auto const& manager = gspn.getExpressionManager();
+    for (auto const& place : gspn.getPlaces()) {
+        if (!place.getName().empty() && !manager->hasVariable(place.getName())) {
+            manager->declareIntegerVariable(place.getName());
+        }
+    }
+    storm::parser::FormulaParser parser(manager);
+    return parser.parseFromString(formulaString);
+}
+
+
+void define_gspn_explorer(py::module& m) {
+
+    py::class_<GspnExplorationOptions>(m, "GSPNExplorationOptions", "Options for the native exploration of GSPNs")
+        .def(py::init<>())
+        .def_readwrite("eliminate_vanishing", &GspnExplorationOptions::eliminateVanishing, "Eliminate vanishing markings on the fly and build a CTMC. Otherwise, a Markov automaton is built if vanishing markings exist.")
+        .def_readwrite("nr_threads", &GspnExplorationOptions::numberOfThreads, "Number of threads used for exploration (0 = all hardware threads)")
+        .def_readwrite("unbounded_place_bits", &GspnExplorationOptions::unboundedPlaceBits, "Number of bits reserved in the marking encoding for places without capacity")
+        .def_readwrite("use_invariants", &GspnExplorationOptions::useInvariants, "Use P-invariants to bound places and to omit places implied by an invariant from the marking encoding")
+    ;
+
+    m.def("_build_sparse_model_from_gspn", &buildSparseModelFromGspn, "Build the model in sparse representation directly from the GSPN", py::arg("gspn"), py::arg("formulas") = Formulas(), py::arg("options") = GspnExplorationOptions(), py::call_guard<py::gil_scoped_release>());
+    m.def("parse_properties_for_gspn", &parsePropertiesForGspn, R"dox(
+
+          Parses properties given in the prism format, allows references to places of the GSPN by their name.
+
+          :param str formula_string: A string of formulas
+          :param GSPN gspn: A GSPN
+          :return: A list of properties
+          )dox", py::arg("formula_string"), py::arg("gspn"));
+}
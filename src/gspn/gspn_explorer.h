@@ -0,0 +1,5 @@
+#pragma once
+
+#include "common.h"
+
+void define_gspn_explorer(py::module& m);
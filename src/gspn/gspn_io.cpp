@@ -2,10 +2,451 @@
 #include "src/helpers.h"
 #include "storm-gspn/storage/gspn/GSPN.h"
 #include "storm-gspn/parser/GspnParser.h"
+#include "storm-gspn/storage/gspn/GspnBuilder.h"
+#include "storm/io/file.h"
+#include "storm/exceptions/WrongFormatException.h"
+
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 
 using GSPN = storm::gspn::GSPN;
 using GSPNParser = storm::parser::GspnParser;
 using GSPNJaniBuilder = storm::builder::JaniGSPNBuilder;
+using GSPNBuilder = storm::gspn::GspnBuilder;
+
+
+/*!
+ * Minimal pull parser for XML which only keeps the current element in memory.
+ * It supports the subset of XML used by PNML and PNPRO files (elements, attributes, text, comments, CDATA).
+ */
+class XmlPullReader {
+   public:
+    enum class Event { StartElement, EndElement, Text, EndOfDocument };
+
+    explicit XmlPullReader(std::istream& stream) : in(stream) {}
+
+    Event next() {
+        if (pendingEnd) {
+            pendingEnd = false;
+            return Event::EndElement;
+        }
+        text.clear();
+        int c;
+        while ((c = in.get()) != EOF) {
+            if (c != '<') {
+                text.push_back(static_cast<char>(c));
+                continue;
+            }
+            if (!boost::algorithm::all(text, boost::algorithm::is_space())) {
+                in.unget();
+                text = decode(boost::algorithm::trim_copy(text));
+                return Event::Text;
+            }
+            text.clear();
+            boost::optional<Event> event = readTag();
+            if (event) {
+                return *event;
+            }
+        }
+        return Event::EndOfDocument;
+    }
+
+    std::string const& getName() const {
+        return name;
+    }
+
+    std::string const& getText() const {
+        return text;
+    }
+
+    std::string getAttribute(std::string const& attribute, std::string const& defaultValue = "") const {
+        for (auto const& entry : attributes) {
+            if (entry.first == attribute) {
+                return entry.second;
+            }
+        }
+        return defaultValue;
+    }
+
+    bool hasAttribute(std::string const& attribute) const {
+        for (auto const& entry : attributes) {
+            if (entry.first == attribute) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+   private:
+    /*!
+     * Read a tag after the opening '<'. Returns none for tags without content (comments, declarations).
+     */
+    boost::optional<Event> readTag() {
+        int c = in.peek();
+        if (c == '!') {
+            in.get();
+            if (consume("--")) {
+                skipUntil("-->");
+            } else if (consume("[CDATA[")) {
+                text = readUntil("]]>");
+                return Event::Text;
+            } else {
+                skipUntil(">");
+            }
+            return boost::none;
+        }
+        if (c == '?') {
+            skipUntil("?>");
+            return boost::none;
+        }
+        if (c == '/') {
+            in.get();
+            name = boost::algorithm::trim_copy(readUntil(">"));
+            return Event::EndElement;
+        }
+
+        name.clear();
+        attributes.clear();
+        while ((c = in.peek()) != EOF && !std::isspace(c) && c != '/' && c != '>') {
+            name.push_back(static_cast<char>(in.get()));
+        }
+        while (true) {
+            skipSpace();
+            c = in.get();
+            STORM_LOG_THROW(c != EOF, storm::exceptions::WrongFormatException, "Unexpected end of XML document in element '" << name << "'.");
+            if (c == '/') {
+                STORM_LOG_THROW(in.get() == '>', storm::exceptions::WrongFormatException, "Malformed XML element '" << name << "'.");
+                pendingEnd = true;
+                return Event::StartElement;
+            }
+            if (c == '>') {
+                return Event::StartElement;
+            }
+            std::string attribute(1, static_cast<char>(c));
+            while ((c = in.peek()) != EOF && !std::isspace(c) && c != '=') {
+                attribute.push_back(static_cast<char>(in.get()));
+            }
+            skipSpace();
+            STORM_LOG_THROW(in.get() == '=', storm::exceptions::WrongFormatException, "Malformed attribute '" << attribute << "' in XML element '" << name << "'.");
+            skipSpace();
+            int quote = in.get();
+            STORM_LOG_THROW(quote == '"' || quote == '\'', storm::exceptions::WrongFormatException, "Malformed attribute '" << attribute << "' in XML element '" << name << "'.");
+            attributes.emplace_back(attribute, decode(readUntil(std::string(1, static_cast<char>(quote)))));
+        }
+    }
+
+    void skipSpace() {
+        while (std::isspace(in.peek())) {
+            in.get();
+        }
+    }
+
+    bool consume(std::string const& expected) {
+        for (uint64_t i = 0; i < expected.size(); ++i) {
+            if (in.peek() != expected[i]) {
+                // Only ever called at the beginning of a declaration, partial matches are treated as generic declarations
+                return false;
+            }
+            in.get();
+        }
+        return true;
+    }
+
+    std::string readUntil(std::string const& terminator) {
+        std::string result;
+        int c;
+        while ((c = in.get()) != EOF) {
+            result.push_back(static_cast<char>(c));
+            if (boost::algorithm::ends_with(result, terminator)) {
+                result.resize(result.size() - terminator.size());
+                return result;
+            }
+        }
+        STORM_LOG_THROW(false, storm::exceptions::WrongFormatException, "Unexpected end of XML document, expected '" << terminator << "'.");
+    }
+
+    void skipUntil(std::string const& terminator) {
+        readUntil(terminator);
+    }
+
+    static std::string decode(std::string const& value) {
+        if (value.find('&') == std::string::npos) {
+            return value;
+        }
+        std::string result = value;
+        boost::algorithm::replace_all(result, "&lt;", "<");
+        boost::algorithm::replace_all(result, "&gt;", ">");
+        boost::algorithm::replace_all(result, "&quot;", "\"");
+        boost::algorithm::replace_all(result, "&apos;", "'");
+        boost::algorithm::replace_all(result, "&amp;", "&");
+        return result;
+    }
+
+    std::istream& in;
+    std::string name;
+    std::string text;
+    std::vector<std::pair<std::string, std::string>> attributes;
+    bool pendingEnd = false;
+};
+
+/*!
+ * Parser for PNML and PNPRO files which streams the XML instead of building a DOM.
+ * Values have to be numbers or references to constants; general expressions are only supported by GSPNParser.
+ */
+class GspnStreamingParser {
+   public:
+    std::shared_ptr<GSPN> parse(std::string const& filename, std::string const& constantDefinitions) {
+        constants.clear();
+        std::vector<std::string> definitions;
+        boost::algorithm::split(definitions, constantDefinitions, boost::is_any_of(","));
+        for (auto const& definition : definitions) {
+            if (boost::algorithm::trim_copy(definition).empty()) {
+                continue;
+            }
+            std::vector<std::string> parts;
+            boost::algorithm::split(parts, definition, boost::is_any_of("="));
+            STORM_LOG_THROW(parts.size() == 2, storm::exceptions::WrongFormatException, "Illegal constant definition '" << definition << "'.");
+            constants[boost::algorithm::trim_copy(parts[0])] = evaluate(parts[1]);
+        }
+        definedConstants = constants;
+
+        std::ifstream stream;
+        storm::utility::openFile(filename, stream);
+        XmlPullReader reader(stream);
+        GSPNBuilder builder;
+        if (boost::algorithm::ends_with(filename, ".pnml")) {
+            parsePnml(reader, builder);
+        } else if (boost::algorithm::ends_with(filename, ".pnpro")) {
+            parsePnpro(reader, builder);
+        } else {
+            STORM_LOG_THROW(false, storm::exceptions::WrongFormatException, "File '" << filename << "' is neither a PNML nor a PNPRO file.");
+        }
+        storm::utility::closeFile(stream);
+        return std::shared_ptr<GSPN>(builder.buildGspn());
+    }
+
+   private:
+    struct PlaceData {
+        std::string name;
+        std::string initialTokens = "0";
+        boost::optional<std::string> capacity;
+        boost::optional<storm::gspn::LayoutInfo> layout;
+    };
+
+    struct TransitionData {
+        std::string name;
+        bool timed = false;
+        std::string rate = "1";
+        std::string priority;
+        std::string servers = "1";
+        boost::optional<storm::gspn::LayoutInfo> layout;
+    };
+
+    struct ArcData {
+        std::string source;
+        std::string target;
+        std::string type;
+        std::string multiplicity = "1";
+    };
+
+    double evaluate(std::string const& value) const {
+        std::string trimmed = boost::algorithm::trim_copy(value);
+        // PNML values are prefixed by the (ignored) color, e.g. 'Default,1'
+        auto comma = trimmed.find(',');
+        if (comma != std::string::npos) {
+            trimmed = boost::algorithm::trim_copy(trimmed.substr(comma + 1));
+        }
+        auto constant = constants.find(trimmed);
+        if (constant != constants.end()) {
+            return constant->second;
+        }
+        try {
+            return boost::lexical_cast<double>(trimmed);
+        } catch (boost::bad_lexical_cast const&) {
+            STORM_LOG_THROW(false, storm::exceptions::WrongFormatException, "Cannot evaluate '" << value << "'. Use GSPNParser for files with general expressions.");
+        }
+    }
+
+    uint64_t evaluateInteger(std::string const& value) const {
+        double result = evaluate(value);
+        STORM_LOG_THROW(result >= 0 && result == std::floor(result), storm::exceptions::WrongFormatException, "Expected a non-negative integer but got '" << value << "'.");
+        return static_cast<uint64_t>(result);
+    }
+
+    static boost::optional<storm::gspn::LayoutInfo> getLayout(XmlPullReader const& reader) {
+        if (reader.hasAttribute("x") && reader.hasAttribute("y")) {
+            return storm::gspn::LayoutInfo(boost::lexical_cast<double>(reader.getAttribute("x")), boost::lexical_cast<double>(reader.getAttribute("y")));
+        }
+        return boost::none;
+    }
+
+    void build(GSPNBuilder& builder, std::vector<PlaceData> const& places, std::vector<TransitionData> const& transitions, std::vector<ArcData> const& arcs,
+               bool isPnml) const {
+        for (auto const& place : places) {
+            boost::optional<uint64_t> capacity;
+            if (place.capacity) {
+                capacity = evaluateInteger(*place.capacity);
+            }
+            uint64_t id = builder.addPlace(capacity, evaluateInteger(place.initialTokens), place.name);
+            if (place.layout) {
+                builder.setPlaceLayoutInfo(id, *place.layout);
+            }
+        }
+        for (auto const& transition : transitions) {
+            uint64_t id;
+            if (transition.timed) {
+                uint64_t priority = transition.priority.empty() ? 0 : evaluateInteger(transition.priority);
+                std::string servers = boost::algorithm::to_lower_copy(boost::algorithm::trim_copy(transition.servers));
+                if (servers == "infinite") {
+                    id = builder.addTimedTransition(priority, evaluate(transition.rate), boost::optional<uint64_t>(), transition.name);
+                } else {
+                    id = builder.addTimedTransition(priority, evaluate(transition.rate), boost::optional<uint64_t>(evaluateInteger(servers)), transition.name);
+                }
+            } else {
+                uint64_t priority = transition.priority.empty() ? 1 : evaluateInteger(transition.priority);
+                id = builder.addImmediateTransition(priority, evaluate(transition.rate), transition.name);
+            }
+            if (transition.layout) {
+                builder.setTransitionLayoutInfo(id, *transition.layout);
+            }
+        }
+        for (auto const& arc : arcs) {
+            uint64_t multiplicity = evaluateInteger(arc.multiplicity);
+            if (isPnml) {
+                if (arc.type == "inhibition") {
+                    builder.addInhibitionArc(arc.source, arc.target, multiplicity);
+                } else {
+                    STORM_LOG_THROW(arc.type.empty() || arc.type == "normal", storm::exceptions::WrongFormatException, "Unknown arc type '" << arc.type << "'.");
+                    builder.addNormalArc(arc.source, arc.target, multiplicity);
+                }
+            } else if (arc.type == "INPUT") {
+                builder.addInputArc(arc.source, arc.target, multiplicity);
+            } else if (arc.type == "OUTPUT") {
+                builder.addOutputArc(arc.source, arc.target, multiplicity);
+            } else if (arc.type == "INHIBITOR") {
+                builder.addInhibitionArc(arc.source, arc.target, multiplicity);
+            } else {
+                STORM_LOG_THROW(false, storm::exceptions::WrongFormatException, "Unknown arc kind '" << arc.type << "'.");
+            }
+        }
+    }
+
+    void parsePnpro(XmlPullReader& reader, GSPNBuilder& builder) {
+        // Constants may be declared after their usage, so nodes are collected before adding them to the builder
+        std::vector<PlaceData> places;
+        std::vector<TransitionData> transitions;
+        std::vector<ArcData> arcs;
+        XmlPullReader::Event event;
+        while ((event = reader.next()) != XmlPullReader::Event::EndOfDocument) {
+            if (event == XmlPullReader::Event::EndElement && reader.getName() == "gspn") {
+                // Only the first GSPN of a project is parsed
+                break;
+            }
+            if (event != XmlPullReader::Event::StartElement) {
+                continue;
+            }
+            std::string const& element = reader.getName();
+            if (element == "gspn") {
+                builder.setGspnName(reader.getAttribute("name"));
+            } else if (element == "place") {
+                PlaceData place;
+                place.name = reader.getAttribute("name");
+                place.initialTokens = reader.getAttribute("marking", "0");
+                place.layout = getLayout(reader);
+                places.push_back(std::move(place));
+            } else if (element == "transition") {
+                TransitionData transition;
+                transition.name = reader.getAttribute("name");
+                std::string type = reader.getAttribute("type");
+                STORM_LOG_THROW(type == "EXP" || type == "IMM", storm::exceptions::WrongFormatException, "Unknown transition type '" << type << "'.");
+                transition.timed = (type == "EXP");
+                transition.rate = transition.timed ? reader.getAttribute("delay", "1") : reader.getAttribute("weight", "1");
+                transition.priority = reader.getAttribute("priority");
+                transition.servers = reader.getAttribute("nservers", "1");
+                transition.layout = getLayout(reader);
+                transitions.push_back(std::move(transition));
+            } else if (element == "constant") {
+                std::string name = reader.getAttribute("name");
+                if (definedConstants.count(name) == 0) {
+                    constants[name] = evaluate(reader.getAttribute("value"));
+                }
+            } else if (element == "arc") {
+                ArcData arc;
+                arc.source = reader.getAttribute("tail");
+                arc.target = reader.getAttribute("head");
+                arc.type = reader.getAttribute("kind");
+                arc.multiplicity = reader.getAttribute("mult", "1");
+                arcs.push_back(std::move(arc));
+            }
+        }
+        build(builder, places, transitions, arcs, false);
+    }
+
+    void parsePnml(XmlPullReader& reader, GSPNBuilder& builder) {
+        std::vector<PlaceData> places;
+        std::vector<TransitionData> transitions;
+        std::vector<ArcData> arcs;
+        // Only the names of the enclosing elements are kept
+        std::vector<std::string> path;
+        XmlPullReader::Event event;
+        while ((event = reader.next()) != XmlPullReader::Event::EndOfDocument) {
+            if (event == XmlPullReader::Event::StartElement) {
+                std::string const& element = reader.getName();
+                if (element == "net") {
+                    builder.setGspnName(reader.getAttribute("id"));
+                } else if (element == "place") {
+                    places.emplace_back();
+                    places.back().name = reader.getAttribute("id");
+                } else if (element == "transition") {
+                    transitions.emplace_back();
+                    transitions.back().name = reader.getAttribute("id");
+                } else if (element == "arc") {
+                    arcs.emplace_back();
+                    arcs.back().source = reader.getAttribute("source");
+                    arcs.back().target = reader.getAttribute("target");
+                } else if (element == "type" && !path.empty() && path.back() == "arc") {
+                    arcs.back().type = reader.getAttribute("value");
+                } else if (element == "position" && path.size() >= 2 && path.back() == "graphics") {
+                    auto layout = getLayout(reader);
+                    if (path[path.size() - 2] == "place") {
+                        places.back().layout = layout;
+                    } else if (path[path.size() - 2] == "transition") {
+                        transitions.back().layout = layout;
+                    }
+                }
+                path.push_back(element);
+            } else if (event == XmlPullReader::Event::EndElement) {
+                STORM_LOG_THROW(!path.empty() && path.back() == reader.getName(), storm::exceptions::WrongFormatException, "Unexpected closing element '" << reader.getName() << "'.");
+                path.pop_back();
+            } else if (event == XmlPullReader::Event::Text && path.size() >= 3 && (path.back() == "value" || path.back() == "text")) {
+                std::string const& property = path[path.size() - 2];
+                std::string const& owner = path[path.size() - 3];
+                std::string const& value = reader.getText();
+                if (owner == "place") {
+                    if (property == "initialMarking") {
+                        places.back().initialTokens = value;
+                    } else if (property == "capacity") {
+                        places.back().capacity = value;
+                    }
+                } else if (owner == "transition") {
+                    if (property == "rate") {
+                        transitions.back().rate = value;
+                    } else if (property == "timed") {
+                        transitions.back().timed = (boost::algorithm::trim_copy(value) == "true");
+                    } else if (property == "priority") {
+                        transitions.back().priority = value;
+                    }
+                } else if (owner == "arc" && property == "inscription") {
+                    arcs.back().multiplicity = value;
+                }
+            }
+        }
+        build(builder, places, transitions, arcs, true);
+    }
+
+    std::map<std::string, double> constants;
+    std::map<std::string, double> definedConstants;
+};
 
 
 void define_gspn_io(py::module& m) {
@@ -16,6 +457,12 @@ void define_gspn_io(py::module& m) {
          .def("parse", [](GSPNParser& p, std::string const& filename, std::string const& constantDefinitions) -> GSPN& {return *(p.parse(filename,constantDefinitions)); }, "filename"_a,  "constant_definitions"_a = "")
     ;
 
+    // Streaming parser
+    py::class_<GspnStreamingParser, std::shared_ptr<GspnStreamingParser>>(m, "GSPNStreamingParser", "Parser for PNML and PNPRO files which streams the XML instead of building a DOM. Values must be numbers or constants.")
+         .def(py::init<>())
+         .def("parse", &GspnStreamingParser::parse, "filename"_a, "constant_definitions"_a = "", py::call_guard<py::gil_scoped_release>())
+    ;
+
     // GspnToJani builder
     py::class_<GSPNJaniBuilder, std::shared_ptr<GSPNJaniBuilder>>(m, "GSPNToJaniBuilder")
          .def(py::init<GSPN const&>(), py::arg("gspn"))
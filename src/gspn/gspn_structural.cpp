@@ -0,0 +1,391 @@
+#include "gspn_structural.h"
+#include "explorer.h"
+
+#include <cmath>
+#include <map>
+#include <numeric>
+
+#include "storm-gspn/storage/gspn/GSPN.h"
+#include "storm/api/storm.h"
+#include "storm/environment/Environment.h"
+#include "storm/modelchecker/results/ExplicitQuantitativeCheckResult.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+
+using GSPN = storm::gspn::GSPN;
+
+/*!
+ * Options for the decomposition-based steady-state analysis.
+ */
+struct GspnDecompositionOptions {
+    // Place ids of each component. If empty, components are derived from the P-invariants.
+    std::vector<std::vector<uint64_t>> components;
+    uint64_t maxIterations = 100;
+    // Relative precision of the throughputs used as convergence criterion.
+    double precision = 1e-6;
+    // Options used for exploring the individual components.
+    GspnExplorationOptions exploration;
+};
+
+struct GspnDecompositionResult {
+    std::vector<std::vector<uint64_t>> components;
+    std::vector<uint64_t> componentStates;
+    std::map<std::string, double> throughputs;
+    std::vector<double> expectedTokens;
+    uint64_t iterations = 0;
+    bool converged = false;
+};
+
+class UnionFind {
+   public:
+    explicit UnionFind(uint64_t size) : parent(size) {
+        std::iota(parent.begin(), parent.end(), 0);
+    }
+
+    uint64_t find(uint64_t element) {
+        while (parent[element] != element) {
+            parent[element] = parent[parent[element]];
+            element = parent[element];
+        }
+        return element;
+    }
+
+    void unite(uint64_t first, uint64_t second) {
+        parent[find(first)] = find(second);
+    }
+
+   private:
+    std::vector<uint64_t> parent;
+};
+
+/*!
+ * Decompose the net into components and compute approximate steady-state measures by a fixed-point iteration.
+ * Each component is analyzed in isolation; a timed transition that depends on places of other components
+ * is slowed down by the probability that these components enable it, which is updated after every round.
+ * Immediate transitions have to be local to one component.
+ */
+class GspnDecomposition {
+   public:
+    GspnDecomposition(GspnNet const& net, GspnDecompositionOptions const& options) : net(net), options(options) {
+        this->options.exploration.eliminateVanishing = true;
+        computeComponents();
+        buildSubnets();
+    }
+
+    GspnDecompositionResult analyze() {
+        GspnDecompositionResult result;
+        result.components = components;
+        result.componentStates.resize(components.size(), 0);
+        result.expectedTokens.resize(net.places.size(), 0);
+
+        uint64_t numberOfTimed = net.timedTransitions.size();
+        // enablingProbability[t][k]: probability that component k enables its part of the timed transition t
+        std::vector<std::vector<double>> enablingProbability(numberOfTimed, std::vector<double>(components.size(), 1.0));
+        std::vector<double> throughputs(numberOfTimed, 0);
+
+        for (result.iterations = 1; result.iterations <= options.maxIterations; ++result.iterations) {
+            std::vector<std::vector<double>> newEnablingProbability = enablingProbability;
+            std::vector<double> throughputSum(numberOfTimed, 0);
+            std::vector<uint64_t> throughputCount(numberOfTimed, 0);
+
+            for (uint64_t k = 0; k < components.size(); ++k) {
+                Subnet& subnet = subnets[k];
+                // Rates are slowed down by the enabling probabilities of all other components
+                for (uint64_t i = 0; i < subnet.timedIndices.size(); ++i) {
+                    uint64_t t = subnet.timedIndices[i];
+                    double factor = 1.0;
+                    for (uint64_t l = 0; l < components.size(); ++l) {
+                        if (l != k && !conditions[t][l].empty()) {
+                            factor *= enablingProbability[t][l];
+                        }
+                    }
+                    subnet.net.timedTransitions[i].value = net.timedTransitions[t].value * factor;
+                }
+
+                GspnExplorer explorer(subnet.net, options.exploration);
+                auto model = explorer.build();
+                std::vector<double> distribution = computeSteadyState(model);
+                auto const& markings = explorer.getMarkings();
+                result.componentStates[k] = markings.size();
+
+                for (uint64_t i = 0; i < subnet.timedIndices.size(); ++i) {
+                    uint64_t t = subnet.timedIndices[i];
+                    CompiledTransition const& local = subnet.net.timedTransitions[i];
+                    double throughput = 0;
+                    double probability = 0;
+                    for (uint64_t state = 0; state < markings.size(); ++state) {
+                        if (explorer.isEnabled(local, markings[state])) {
+                            throughput += distribution[state] * explorer.getRate(local, markings[state]);
+                        }
+                        if (explorer.isEnabled(subnet.conditions[i], markings[state])) {
+                            probability += distribution[state];
+                        }
+                    }
+                    throughputSum[t] += throughput;
+                    ++throughputCount[t];
+                    newEnablingProbability[t][k] = probability;
+                }
+                for (uint64_t local = 0; local < components[k].size(); ++local) {
+                    double expected = 0;
+                    for (uint64_t state = 0; state < markings.size(); ++state) {
+                        expected += distribution[state] * explorer.getLayout().getTokens(markings[state], local);
+                    }
+                    result.expectedTokens[components[k][local]] = expected;
+                }
+            }
+
+            double maxChange = 0;
+            for (uint64_t t = 0; t < numberOfTimed; ++t) {
+                // Transitions without any arcs are always enabled
+                double throughput = throughputCount[t] > 0 ? throughputSum[t] / throughputCount[t] : net.timedTransitions[t].value;
+                maxChange = std::max(maxChange, std::abs(throughput - throughputs[t]) / std::max(1.0, std::abs(throughput)));
+                throughputs[t] = throughput;
+            }
+            enablingProbability = std::move(newEnablingProbability);
+            if (result.iterations > 1 && maxChange <= options.precision) {
+                result.converged = true;
+                break;
+            }
+        }
+        result.iterations = std::min(result.iterations, options.maxIterations);
+
+        for (uint64_t t = 0; t < numberOfTimed; ++t) {
+            result.throughputs[net.timedTransitions[t].name] = throughputs[t];
+        }
+        return result;
+    }
+
+   private:
+    struct Subnet {
+        GspnNet net;
+        // Index of each local timed transition in the original net
+        std::vector<uint64_t> timedIndices;
+        // Local enabling condition (inputs and inhibitors) of each local timed transition
+        std::vector<CompiledTransition> conditions;
+    };
+
+    static std::vector<double> computeSteadyState(std::shared_ptr<storm::models::sparse::Model<double>> const& model) {
+        storm::Environment env;
+        auto result = storm::api::computeSteadyStateDistributionWithSparseEngine<double>(env, model);
+        return result->asExplicitQuantitativeCheckResult<double>().getValueVector();
+    }
+
+    void computeComponents() {
+        uint64_t numberOfPlaces = net.places.size();
+        if (!options.components.empty()) {
+            components = options.components;
+        } else {
+            UnionFind unionFind(numberOfPlaces);
+            for (auto const& invariant : computePlaceInvariants(net)) {
+                boost::optional<uint64_t> first;
+                for (uint64_t p = 0; p < numberOfPlaces; ++p) {
+                    if (invariant[p] > 0) {
+                        if (first) {
+                            unionFind.unite(p, *first);
+                        } else {
+                            first = p;
+                        }
+                    }
+                }
+            }
+            for (auto const& transition : net.immediateTransitions) {
+                uniteArcs(unionFind, transition);
+            }
+            std::map<uint64_t, uint64_t> rootToComponent;
+            for (uint64_t p = 0; p < numberOfPlaces; ++p) {
+                auto it = rootToComponent.emplace(unionFind.find(p), components.size()).first;
+                if (it->second == components.size()) {
+                    components.emplace_back();
+                }
+                components[it->second].push_back(p);
+            }
+        }
+
+        componentOf.assign(numberOfPlaces, std::numeric_limits<uint64_t>::max());
+        for (uint64_t k = 0; k < components.size(); ++k) {
+            for (uint64_t p : components[k]) {
+                STORM_LOG_THROW(p < numberOfPlaces && componentOf[p] == std::numeric_limits<uint64_t>::max(), storm::exceptions::InvalidArgumentException,
+                                "Place " << p << " is invalid or contained in several components.");
+                componentOf[p] = k;
+            }
+        }
+        for (uint64_t p = 0; p < numberOfPlaces; ++p) {
+            STORM_LOG_THROW(componentOf[p] != std::numeric_limits<uint64_t>::max(), storm::exceptions::InvalidArgumentException, "Place " << p << " is not contained in any component.");
+        }
+    }
+
+    static void uniteArcs(UnionFind& unionFind, CompiledTransition const& transition) {
+        boost::optional<uint64_t> first;
+        for (auto const* arcs : {&transition.inputs, &transition.outputs, &transition.inhibitors}) {
+            for (auto const& arc : *arcs) {
+                if (first) {
+                    unionFind.unite(arc.first, *first);
+                } else {
+                    first = arc.first;
+                }
+            }
+        }
+    }
+
+    /*!
+     * Restrict the arcs of the transition to the places of the given component (using local place indices).
+     */
+    CompiledTransition restrict(CompiledTransition const& transition, uint64_t component, bool keepOutputs) const {
+        CompiledTransition result = transition;
+        auto restrictArcs = [&](std::vector<std::pair<uint64_t, uint64_t>>& arcs) {
+            std::vector<std::pair<uint64_t, uint64_t>> restricted;
+            for (auto const& arc : arcs) {
+                if (componentOf[arc.first] == component) {
+                    restricted.emplace_back(localIndex[arc.first], arc.second);
+                }
+            }
+            arcs = std::move(restricted);
+        };
+        restrictArcs(result.inputs);
+        restrictArcs(result.inhibitors);
+        if (keepOutputs) {
+            restrictArcs(result.outputs);
+        } else {
+            result.outputs.clear();
+        }
+        return result;
+    }
+
+    void buildSubnets() {
+        localIndex.resize(net.places.size());
+        for (auto const& component : components) {
+            for (uint64_t i = 0; i < component.size(); ++i) {
+                localIndex[component[i]] = i;
+            }
+        }
+
+        conditions.assign(net.timedTransitions.size(), std::vector<std::vector<uint64_t>>(components.size()));
+        for (uint64_t t = 0; t < net.timedTransitions.size(); ++t) {
+            for (auto const* arcs : {&net.timedTransitions[t].inputs, &net.timedTransitions[t].inhibitors}) {
+                for (auto const& arc : *arcs) {
+                    conditions[t][componentOf[arc.first]].push_back(arc.first);
+                }
+            }
+        }
+
+        subnets.resize(components.size());
+        for (uint64_t k = 0; k < components.size(); ++k) {
+            Subnet& subnet = subnets[k];
+            for (uint64_t p : components[k]) {
+                subnet.net.places.push_back(net.places[p]);
+            }
+            for (uint64_t t = 0; t < net.timedTransitions.size(); ++t) {
+                CompiledTransition local = restrict(net.timedTransitions[t], k, true);
+                if (local.inputs.empty() && local.inhibitors.empty() && local.outputs.empty()) {
+                    continue;
+                }
+                subnet.net.timedTransitions.push_back(std::move(local));
+                subnet.timedIndices.push_back(t);
+                subnet.conditions.push_back(restrict(net.timedTransitions[t], k, false));
+            }
+            for (auto const& transition : net.immediateTransitions) {
+                CompiledTransition local = restrict(transition, k, true);
+                uint64_t numberOfArcs = transition.inputs.size() + transition.outputs.size() + transition.inhibitors.size();
+                uint64_t numberOfLocalArcs = local.inputs.size() + local.outputs.size() + local.inhibitors.size();
+                if (numberOfLocalArcs == 0) {
+                    continue;
+                }
+                STORM_LOG_THROW(numberOfLocalArcs == numberOfArcs, storm::exceptions::InvalidArgumentException,
+                                "Immediate transition '" << transition.name << "' connects several components.");
+                subnet.net.immediateTransitions.push_back(std::move(local));
+            }
+        }
+    }
+
+    GspnNet const& net;
+    GspnDecompositionOptions options;
+    std::vector<std::vector<uint64_t>> components;
+    std::vector<uint64_t> componentOf;
+    std::vector<uint64_t> localIndex;
+    // conditions[t][k]: places of component k in the enabling condition of timed transition t
+    std::vector<std::vector<std::vector<uint64_t>>> conditions;
+    std::vector<Subnet> subnets;
+};
+
+// Thin wrappers
+std::vector<Invariant> computePlaceInvariantsForGspn(GSPN const& gspn, uint64_t maxInvariants) {
+    return computePlaceInvariants(GspnNet(gspn), maxInvariants);
+}
+
+std::vector<std::map<std::string, uint64_t>> computeTransitionInvariantsForGspn(GSPN const& gspn, uint64_t maxInvariants) {
+    GspnNet net(gspn);
+    std::vector<std::map<std::string, uint64_t>> result;
+    for (auto const& invariant : computeTransitionInvariants(net, maxInvariants)) {
+        std::map<std::string, uint64_t> named;
+        for (uint64_t t = 0; t < invariant.size(); ++t) {
+            if (invariant[t] > 0) {
+                named[net.getTransition(t).name] = invariant[t];
+            }
+        }
+        result.push_back(std::move(named));
+    }
+    return result;
+}
+
+std::vector<boost::optional<uint64_t>> computePlaceBoundsForGspn(GSPN const& gspn, uint64_t maxInvariants) {
+    GspnNet net(gspn);
+    return computePlaceBounds(net, computePlaceInvariants(net, maxInvariants));
+}
+
+GspnDecompositionResult analyzeSteadyStateDecomposed(GSPN const& gspn, GspnDecompositionOptions const& options) {
+    GspnNet net(gspn);
+    GspnDecomposition decomposition(net, options);
+    return decomposition.analyze();
+}
+
+
+void define_gspn_structural(py::module& m) {
+
+    m.def("compute_p_invariants", &computePlaceInvariantsForGspn, R"doc(
+             Compute the minimal semi-positive P-invariants of the GSPN.
+
+            :param stormpy.gspn.GSPN gspn: The GSPN.
+            :param int max_invariants: Bound on the number of intermediate vectors of the Farkas algorithm.
+            :return: List of invariants, each given as list of weights indexed by the place ID.
+        )doc", "gspn"_a, "max_invariants"_a = 100000);
+    m.def("compute_t_invariants", &computeTransitionInvariantsForGspn, R"doc(
+             Compute the minimal semi-positive T-invariants of the GSPN.
+
+            :param stormpy.gspn.GSPN gspn: The GSPN.
+            :param int max_invariants: Bound on the number of intermediate vectors of the Farkas algorithm.
+            :return: List of invariants, each given as mapping from transition name to its multiplicity.
+        )doc", "gspn"_a, "max_invariants"_a = 100000);
+    m.def("compute_place_bounds", &computePlaceBoundsForGspn, R"doc(
+             Compute structural bounds of the places from the P-invariants and capacities.
+
+            :param stormpy.gspn.GSPN gspn: The GSPN.
+            :param int max_invariants: Bound on the number of intermediate vectors of the Farkas algorithm.
+            :return: List of bounds indexed by the place ID, None for places without structural bound.
+        )doc", "gspn"_a, "max_invariants"_a = 100000);
+
+    py::class_<GspnDecompositionOptions>(m, "GSPNDecompositionOptions", "Options for the decomposition-based steady-state analysis")
+        .def(py::init<>())
+        .def_readwrite("components", &GspnDecompositionOptions::components, "Place IDs of each component. If empty, components are derived from the P-invariants.")
+        .def_readwrite("max_iterations", &GspnDecompositionOptions::maxIterations, "Maximal number of fixed-point iterations")
+        .def_readwrite("precision", &GspnDecompositionOptions::precision, "Relative precision of the throughputs used for convergence")
+        .def_readwrite("exploration", &GspnDecompositionOptions::exploration, "Options for exploring the individual components")
+    ;
+
+    py::class_<GspnDecompositionResult>(m, "GSPNDecompositionResult", "Result of the decomposition-based steady-state analysis")
+        .def_readonly("components", &GspnDecompositionResult::components, "Place IDs of each component")
+        .def_readonly("component_states", &GspnDecompositionResult::componentStates, "Number of states of each component")
+        .def_readonly("throughputs", &GspnDecompositionResult::throughputs, "Steady-state throughput of each timed transition")
+        .def_readonly("expected_tokens", &GspnDecompositionResult::expectedTokens, "Expected number of tokens in steady state for each place")
+        .def_readonly("iterations", &GspnDecompositionResult::iterations, "Number of fixed-point iterations")
+        .def_readonly("converged", &GspnDecompositionResult::converged, "True iff the fixed-point iteration converged")
+    ;
+
+    m.def("analyze_steady_state_decomposed", &analyzeSteadyStateDecomposed, R"doc(
+             Approximate steady-state measures by decomposing the GSPN into loosely coupled components.
+             Each component is analyzed in isolation and the rates of transitions depending on other components
+             are adjusted by a fixed-point iteration. The result is exact if the components are independent.
+
+            :param stormpy.gspn.GSPN gspn: The GSPN.
+            :param GSPNDecompositionOptions options: Options for the analysis.
+            :rtype: GSPNDecompositionResult
+        )doc", "gspn"_a, "options"_a = GspnDecompositionOptions(), py::call_guard<py::gil_scoped_release>());
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "common.h"
+
+void define_gspn_structural(py::module& m);
@@ -0,0 +1,201 @@
+#include "net.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "storm/exceptions/InvalidModelException.h"
+#include "storm/exceptions/OutOfRangeException.h"
+#include "storm/utility/macros.h"
+
+template<typename TransitionType>
+CompiledTransition compileTransition(TransitionType const& transition) {
+    CompiledTransition result;
+    result.name = transition.getName();
+    result.inputs.assign(transition.getInputPlaces().begin(), transition.getInputPlaces().end());
+    result.outputs.assign(transition.getOutputPlaces().begin(), transition.getOutputPlaces().end());
+    result.inhibitors.assign(transition.getInhibitionPlaces().begin(), transition.getInhibitionPlaces().end());
+    std::sort(result.inputs.begin(), result.inputs.end());
+    std::sort(result.outputs.begin(), result.outputs.end());
+    std::sort(result.inhibitors.begin(), result.inhibitors.end());
+    result.priority = transition.getPriority();
+    return result;
+}
+
+GspnNet::GspnNet(storm::gspn::GSPN const& gspn) : manager(gspn.getExpressionManager()) {
+    places.resize(gspn.getNumberOfPlaces());
+    for (auto const& place : gspn.getPlaces()) {
+        STORM_LOG_THROW(place.getID() < places.size(), storm::exceptions::InvalidModelException, "Place ids are expected to be consecutive.");
+        NetPlace& netPlace = places[place.getID()];
+        netPlace.name = place.getName();
+        netPlace.initialTokens = place.getNumberOfInitialTokens();
+        if (place.hasRestrictedCapacity()) {
+            netPlace.capacity = place.getCapacity();
+        }
+    }
+    for (auto const& transition : gspn.getTimedTransitions()) {
+        CompiledTransition compiled = compileTransition(transition);
+        compiled.value = transition.getRate();
+        if (transition.hasInfiniteServerSemantics()) {
+            compiled.servers = 0;
+        } else if (transition.hasKServerSemantics()) {
+            compiled.servers = transition.getNumberOfServers();
+        }
+        timedTransitions.push_back(std::move(compiled));
+    }
+    for (auto const& transition : gspn.getImmediateTransitions()) {
+        CompiledTransition compiled = compileTransition(transition);
+        compiled.value = transition.noWeightAttached() ? 0 : transition.getWeight();
+        immediateTransitions.push_back(std::move(compiled));
+    }
+}
+
+/*!
+ * Incidence matrix with one row per place and one column per transition.
+ */
+std::vector<std::vector<int64_t>> computeIncidence(GspnNet const& net) {
+    std::vector<std::vector<int64_t>> incidence(net.places.size(), std::vector<int64_t>(net.getNumberOfTransitions(), 0));
+    for (uint64_t t = 0; t < net.getNumberOfTransitions(); ++t) {
+        CompiledTransition const& transition = net.getTransition(t);
+        for (auto const& arc : transition.inputs) {
+            incidence[arc.first][t] -= arc.second;
+        }
+        for (auto const& arc : transition.outputs) {
+            incidence[arc.first][t] += arc.second;
+        }
+    }
+    return incidence;
+}
+
+/*!
+ * Farkas algorithm: compute the minimal semi-positive vectors y with y^T A = 0 for the given matrix A.
+ */
+std::vector<Invariant> farkas(std::vector<std::vector<int64_t>> const& matrix, uint64_t numberOfColumns, uint64_t maxRows) {
+    struct Row {
+        std::vector<int64_t> constraint;
+        std::vector<int64_t> weights;
+    };
+    uint64_t numberOfRows = matrix.size();
+    std::vector<Row> rows;
+    for (uint64_t i = 0; i < numberOfRows; ++i) {
+        Row row{matrix[i], std::vector<int64_t>(numberOfRows, 0)};
+        row.weights[i] = 1;
+        rows.push_back(std::move(row));
+    }
+
+    auto normalize = [](Row& row) {
+        int64_t divisor = 0;
+        for (int64_t value : row.constraint) {
+            divisor = std::gcd(divisor, value);
+        }
+        for (int64_t value : row.weights) {
+            divisor = std::gcd(divisor, value);
+        }
+        if (divisor > 1) {
+            for (int64_t& value : row.constraint) {
+                value /= divisor;
+            }
+            for (int64_t& value : row.weights) {
+                value /= divisor;
+            }
+        }
+    };
+    // Only keep rows with minimal support
+    auto isSubset = [](Row const& smaller, Row const& larger) {
+        for (uint64_t i = 0; i < smaller.weights.size(); ++i) {
+            if (smaller.weights[i] != 0 && larger.weights[i] == 0) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (uint64_t column = 0; column < numberOfColumns; ++column) {
+        std::vector<Row> next;
+        std::vector<Row const*> positive;
+        std::vector<Row const*> negative;
+        for (auto const& row : rows) {
+            if (row.constraint[column] == 0) {
+                next.push_back(row);
+            } else if (row.constraint[column] > 0) {
+                positive.push_back(&row);
+            } else {
+                negative.push_back(&row);
+            }
+        }
+        for (Row const* pos : positive) {
+            for (Row const* neg : negative) {
+                int64_t factorPos = -neg->constraint[column];
+                int64_t factorNeg = pos->constraint[column];
+                Row combined{std::vector<int64_t>(numberOfColumns), std::vector<int64_t>(numberOfRows)};
+                for (uint64_t i = 0; i < numberOfColumns; ++i) {
+                    combined.constraint[i] = factorPos * pos->constraint[i] + factorNeg * neg->constraint[i];
+                }
+                for (uint64_t i = 0; i < numberOfRows; ++i) {
+                    combined.weights[i] = factorPos * pos->weights[i] + factorNeg * neg->weights[i];
+                }
+                normalize(combined);
+                next.push_back(std::move(combined));
+            }
+        }
+
+        std::vector<bool> removed(next.size(), false);
+        for (uint64_t i = 0; i < next.size(); ++i) {
+            for (uint64_t j = 0; j < next.size() && !removed[i]; ++j) {
+                if (i != j && !removed[j] && isSubset(next[j], next[i]) && (!isSubset(next[i], next[j]) || j < i)) {
+                    removed[i] = true;
+                }
+            }
+        }
+        rows.clear();
+        for (uint64_t i = 0; i < next.size(); ++i) {
+            if (!removed[i]) {
+                rows.push_back(std::move(next[i]));
+            }
+        }
+        STORM_LOG_THROW(rows.size() <= maxRows, storm::exceptions::OutOfRangeException, "The computation of invariants exceeds the bound of " << maxRows << " intermediate vectors.");
+    }
+
+    std::vector<Invariant> result;
+    for (auto const& row : rows) {
+        result.emplace_back(row.weights.begin(), row.weights.end());
+    }
+    return result;
+}
+
+std::vector<Invariant> computePlaceInvariants(GspnNet const& net, uint64_t maxInvariants) {
+    return farkas(computeIncidence(net), net.getNumberOfTransitions(), maxInvariants);
+}
+
+std::vector<Invariant> computeTransitionInvariants(GspnNet const& net, uint64_t maxInvariants) {
+    auto incidence = computeIncidence(net);
+    std::vector<std::vector<int64_t>> transposed(net.getNumberOfTransitions(), std::vector<int64_t>(net.places.size(), 0));
+    for (uint64_t p = 0; p < net.places.size(); ++p) {
+        for (uint64_t t = 0; t < net.getNumberOfTransitions(); ++t) {
+            transposed[t][p] = incidence[p][t];
+        }
+    }
+    return farkas(transposed, net.places.size(), maxInvariants);
+}
+
+std::vector<boost::optional<uint64_t>> computePlaceBounds(GspnNet const& net, std::vector<Invariant> const& placeInvariants) {
+    std::vector<boost::optional<uint64_t>> bounds(net.places.size());
+    for (uint64_t p = 0; p < net.places.size(); ++p) {
+        bounds[p] = net.places[p].capacity;
+    }
+    for (auto const& invariant : placeInvariants) {
+        // The weighted token sum is constant in all reachable markings
+        uint64_t weightedSum = 0;
+        for (uint64_t p = 0; p < net.places.size(); ++p) {
+            weightedSum += invariant[p] * net.places[p].initialTokens;
+        }
+        for (uint64_t p = 0; p < net.places.size(); ++p) {
+            if (invariant[p] > 0) {
+                uint64_t bound = weightedSum / invariant[p];
+                if (!bounds[p] || bound < *bounds[p]) {
+                    bounds[p] = bound;
+                }
+            }
+        }
+    }
+    return bounds;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "storm-gspn/storage/gspn/GSPN.h"
+#include "storm/storage/expressions/ExpressionManager.h"
+
+/*!
+ * Flattened view on a GSPN transition, avoiding the hash maps of storm::gspn::Transition during exploration.
+ * Arcs are given as pairs of place index and multiplicity.
+ */
+struct CompiledTransition {
+    std::string name;
+    std::vector<std::pair<uint64_t, uint64_t>> inputs;
+    std::vector<std::pair<uint64_t, uint64_t>> outputs;
+    std::vector<std::pair<uint64_t, uint64_t>> inhibitors;
+    uint64_t priority = 0;
+    // Rate for timed and weight for immediate transitions.
+    double value = 0;
+    // Number of servers for timed transitions, 0 encodes infinite server semantics.
+    uint64_t servers = 1;
+};
+
+struct NetPlace {
+    std::string name;
+    boost::optional<uint64_t> capacity;
+    uint64_t initialTokens = 0;
+};
+
+/*!
+ * Plain representation of a GSPN used by the native exploration and the structural analysis.
+ * Places are indexed by their id.
+ */
+struct GspnNet {
+    GspnNet() = default;
+    explicit GspnNet(storm::gspn::GSPN const& gspn);
+
+    uint64_t getNumberOfTransitions() const {
+        return timedTransitions.size() + immediateTransitions.size();
+    }
+
+    /*!
+     * Transitions are indexed with timed transitions first, followed by immediate transitions.
+     */
+    CompiledTransition const& getTransition(uint64_t index) const {
+        return index < timedTransitions.size() ? timedTransitions[index] : immediateTransitions[index - timedTransitions.size()];
+    }
+
+    std::vector<NetPlace> places;
+    std::vector<CompiledTransition> timedTransitions;
+    std::vector<CompiledTransition> immediateTransitions;
+    // Manager in which places may be declared as integer variables (can be null).
+    std::shared_ptr<storm::expressions::ExpressionManager> manager;
+};
+
+// A P-invariant assigns a weight to every place, a T-invariant to every transition.
+typedef std::vector<uint64_t> Invariant;
+
+/*!
+ * Compute the minimal semi-positive P-invariants (y >= 0, y^T C = 0) with the Farkas algorithm.
+ * @param maxInvariants Bound on the number of intermediate rows to avoid an exponential blow-up.
+ */
+std::vector<Invariant> computePlaceInvariants(GspnNet const& net, uint64_t maxInvariants = 100000);
+
+/*!
+ * Compute the minimal semi-positive T-invariants (x >= 0, C x = 0) with the Farkas algorithm.
+ */
+std::vector<Invariant> computeTransitionInvariants(GspnNet const& net, uint64_t maxInvariants = 100000);
+
+/*!
+ * Compute structural bounds for each place from the given P-invariants and the initial marking.
+ * Places which are not covered by an invariant and have no capacity are unbounded (none).
+ */
+std::vector<boost::optional<uint64_t>> computePlaceBounds(GspnNet const& net, std::vector<Invariant> const& placeInvariants);
@@ -10,6 +10,17 @@
 #include "core/environment.h"
 #include "core/transformation.h"
 #include "core/simulator.h"
+#include "core/onthefly.h"
+#include "core/statistical.h"
+#include "core/symbolic_io.h"
+#include "core/sylvan.h"
+#include "core/variable_order.h"
+#include "core/expression_compiler.h"
+#include "core/action_mask.h"
+#include "core/sweep.h"
+#include "core/template_builder.h"
+#include "core/jani_io.h"
+#include "core/pareto.h"
 
 PYBIND11_MODULE(core, m) {
     m.doc() = "core";
@@ -27,6 +38,9 @@ PYBIND11_MODULE(core, m) {
     define_build(m);
     define_optimality_type(m);
     define_export(m);
+    define_symbolic_io(m);
+    define_sylvan(m);
+    define_variable_order(m);
     define_result(m);
     define_modelchecking(m);
     define_counterexamples(m);
@@ -40,5 +54,13 @@ PYBIND11_MODULE(core, m) {
     define_sparse_model_simulator<double>(m, "Double");
     define_sparse_model_simulator<storm::RationalNumber>(m, "Exact");
     define_prism_program_simulator<double>(m, "Double");
+    define_on_the_fly(m);
+    define_statistical_model_checking(m);
+    define_expression_compiler(m);
+    define_action_masks(m);
+    define_constant_sweep(m);
+    define_template_builder(m);
+    define_jani_io(m);
+    define_pareto_exploration(m);
 
 }
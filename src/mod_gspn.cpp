@@ -2,6 +2,8 @@
 
 #include "gspn/gspn.h"
 #include "gspn/gspn_io.h"
+#include "gspn/gspn_explorer.h"
+#include "gspn/gspn_structural.h"
 
 PYBIND11_MODULE(gspn, m) {
     m.doc() = "Support for GSPNs";
@@ -13,4 +15,6 @@ PYBIND11_MODULE(gspn, m) {
 
     define_gspn(m);
     define_gspn_io(m);
+    define_gspn_explorer(m);
+    define_gspn_structural(m);
 }
@@ -5,6 +5,7 @@
 #include "pomdp/qualitative_analysis.h"
 #include "pomdp/transformations.h"
 #include "pomdp/memory.h"
+#include "pomdp/memory_product.h"
 #include "pomdp/quantitative_analysis.h"
 #include <storm/adapters/RationalFunctionAdapter.h>
 
@@ -23,7 +24,10 @@ PYBIND11_MODULE(pomdp, m) {
     define_transformations_nt(m);
     define_transformations<double>(m, "Double");
     define_transformations<storm::RationalNumber>(m, "Exact");
+    define_memory_product<double>(m, "Double");
+    define_memory_product<storm::RationalNumber>(m, "Exact");
     define_belief_exploration<double>(m, "Double");
 
     define_transformations<storm::RationalFunction>(m, "Rf");
+    define_memory_product<storm::RationalFunction>(m, "Rf");
 }
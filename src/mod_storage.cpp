@@ -10,6 +10,7 @@
 #include "storage/scheduler.h"
 #include "storage/prism.h"
 #include "storage/jani.h"
+#include "storage/jani_flattening.h"
 #include "storage/state.h"
 #include "src/storage/valuation.h"
 #include "storage/choiceorigins.h"
@@ -51,6 +52,7 @@ PYBIND11_MODULE(storage, m) {
     define_prism(m);
     define_jani(m);
     define_jani_transformers(m);
+    define_jani_flattening(m);
     define_labeling(m);
     define_origins(m);
     define_expressions(m);
@@ -73,5 +75,10 @@ PYBIND11_MODULE(storage, m) {
     define_maximal_end_component_decomposition<storm::RationalNumber>(m, "_exact");
     define_maximal_end_component_decomposition<storm::Interval>(m, "_interval");
     define_maximal_end_component_decomposition<storm::RationalFunction>(m, "_ratfunc");
+    define_strongly_connected_components(m);
+    define_strongly_connected_component_decomposition<double>(m, "_double");
+    define_strongly_connected_component_decomposition<storm::RationalNumber>(m, "_exact");
+    define_strongly_connected_component_decomposition<storm::Interval>(m, "_interval");
+    define_strongly_connected_component_decomposition<storm::RationalFunction>(m, "_ratfunc");
 
 }
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <vector>
+
+/**
+ * Resolve a user-provided thread count, where 0 means 'use all hardware threads'.
+ */
+inline uint64_t resolveNumberOfThreads(uint64_t numberOfThreads) {
+    if (numberOfThreads == 0) {
+        numberOfThreads = std::max<uint64_t>(1, std::thread::hardware_concurrency());
+    }
+    return numberOfThreads;
+}
+
+/**
+ * Call f(i) for all i in [begin, end), distributing contiguous chunks over the given number of threads.
+ * The first exception thrown by a worker is rethrown in the calling thread after all workers have joined.
+ * Callers are responsible for not touching Python objects inside f, as the GIL is not held by the workers.
+ */
+template<typename Function>
+void parallelFor(uint64_t begin, uint64_t end, uint64_t numberOfThreads, Function const& f) {
+    if (begin >= end) {
+        return;
+    }
+    uint64_t const size = end - begin;
+    numberOfThreads = std::min(resolveNumberOfThreads(numberOfThreads), size);
+    if (numberOfThreads <= 1) {
+        for (uint64_t i = begin; i < end; ++i) {
+            f(i);
+        }
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(numberOfThreads);
+    std::vector<std::thread> workers;
+    workers.reserve(numberOfThreads);
+    uint64_t const chunk = (size + numberOfThreads - 1) / numberOfThreads;
+    for (uint64_t t = 0; t < numberOfThreads; ++t) {
+        uint64_t const chunkBegin = begin + t * chunk;
+        uint64_t const chunkEnd = std::min(end, chunkBegin + chunk);
+        workers.emplace_back([&f, &errors, t, chunkBegin, chunkEnd]() {
+            try {
+                for (uint64_t i = chunkBegin; i < chunkEnd; ++i) {
+                    f(i);
+                }
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (auto const& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
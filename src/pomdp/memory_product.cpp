@@ -0,0 +1,395 @@
+#include "memory_product.h"
+
+#include <pybind11/numpy.h>
+
+#include <storm-pomdp/storage/PomdpMemory.h>
+#include <storm/adapters/RationalFunctionAdapter.h>
+#include <storm/models/sparse/Dtmc.h>
+#include <storm/models/sparse/Pomdp.h>
+#include <storm/models/sparse/StandardRewardModel.h>
+#include <storm/storage/SparseMatrix.h>
+#include <storm/storage/sparse/ModelComponents.h>
+#include <storm/utility/constants.h>
+#include <storm/exceptions/InvalidArgumentException.h>
+#include <storm/exceptions/NotSupportedException.h>
+
+template<typename ValueType> using Pomdp = storm::models::sparse::Pomdp<ValueType>;
+
+/*!
+ * Product of a POMDP and a memory structure.
+ * The product state (s, n) of POMDP state s and memory node n has for each choice a of s and each memory successor n' of n the choice (a, n'),
+ * which moves to (t, n') with the probability of moving from s to t under a. Its observation is o(s) * |memory| + n.
+ *
+ * The product is never built completely. Only the product states reachable from the initial states are explored,
+ * and the product matrix is written in one pass into preallocated storage.
+ * Alternatively, the Markov chain induced by a finite-state controller on the product is built without building the product POMDP.
+ */
+template<typename ValueType>
+class PomdpMemoryProduct {
+   public:
+    PomdpMemoryProduct(std::shared_ptr<Pomdp<ValueType>> const& pomdp, storm::storage::PomdpMemory const& memory)
+        : pomdp(pomdp), memory(memory), numberOfMemoryStates(memory.getNumberOfStates()) {
+        for (auto const& rewardModel : pomdp->getRewardModels()) {
+            STORM_LOG_THROW(!rewardModel.second.hasTransitionRewards(), storm::exceptions::NotSupportedException, "Memory unfolding does not support transition rewards.");
+        }
+        memorySuccessors.resize(numberOfMemoryStates);
+        for (uint64_t node = 0; node < numberOfMemoryStates; ++node) {
+            for (uint64_t successor = 0; successor < numberOfMemoryStates; ++successor) {
+                if (memory.hasTransition(node, successor)) {
+                    memorySuccessors[node].push_back(successor);
+                }
+            }
+        }
+        maximalNumberOfChoices = 0;
+        for (uint64_t state = 0; state < pomdp->getNumberOfStates(); ++state) {
+            maximalNumberOfChoices = std::max<uint64_t>(maximalNumberOfChoices, pomdp->getNumberOfChoices(state));
+        }
+    }
+
+    /*!
+     * Build the reachable part of the product POMDP.
+     * Product states are ordered by (s, n), i.e., as in the full product restricted to the reachable states.
+     */
+    std::shared_ptr<Pomdp<ValueType>> unfold(bool addMemoryLabels) const {
+        auto const& matrix = pomdp->getTransitionMatrix();
+        auto const& rowGroupIndices = matrix.getRowGroupIndices();
+        storm::storage::BitVector reachable = getReachableProductStates();
+
+        // Index of each reachable product state and the sizes of the product matrix
+        std::vector<uint64_t> productIndex(reachable.size(), 0);
+        uint64_t numberOfStates = 0;
+        uint64_t numberOfRows = 0;
+        uint64_t numberOfEntries = 0;
+        for (uint64_t productState : reachable) {
+            productIndex[productState] = numberOfStates++;
+            uint64_t state = productState / numberOfMemoryStates;
+            uint64_t successors = memorySuccessors[productState % numberOfMemoryStates].size();
+            for (uint64_t choice = rowGroupIndices[state]; choice < rowGroupIndices[state + 1]; ++choice) {
+                numberOfRows += successors;
+                numberOfEntries += matrix.getRow(choice).getNumberOfEntries() * successors;
+            }
+        }
+
+        // Columns are increasing within a row, as the targets (t, n') are ordered by t for a fixed successor n'
+        storm::storage::SparseMatrixBuilder<ValueType> builder(numberOfRows, numberOfStates, numberOfEntries, true, true, numberOfStates);
+        std::vector<uint64_t> originalRow;
+        originalRow.reserve(numberOfRows);
+        std::vector<uint32_t> observations;
+        observations.reserve(numberOfStates);
+        uint64_t row = 0;
+        for (uint64_t productState : reachable) {
+            uint64_t state = productState / numberOfMemoryStates;
+            uint64_t node = productState % numberOfMemoryStates;
+            builder.newRowGroup(row);
+            observations.push_back(pomdp->getObservation(state) * numberOfMemoryStates + node);
+            for (uint64_t choice = rowGroupIndices[state]; choice < rowGroupIndices[state + 1]; ++choice) {
+                for (uint64_t successor : memorySuccessors[node]) {
+                    for (auto const& entry : matrix.getRow(choice)) {
+                        builder.addNextValue(row, productIndex[entry.getColumn() * numberOfMemoryStates + successor], entry.getValue());
+                    }
+                    originalRow.push_back(choice);
+                    ++row;
+                }
+            }
+        }
+
+        storm::models::sparse::StateLabeling labeling(numberOfStates);
+        for (auto const& label : pomdp->getStateLabeling().getLabels()) {
+            storm::storage::BitVector labeledStates(numberOfStates, false);
+            for (uint64_t productState : reachable) {
+                if (pomdp->getStateLabeling().getStateHasLabel(label, productState / numberOfMemoryStates)) {
+                    // Only the initial memory node is initial
+                    if (label != "init" || productState % numberOfMemoryStates == memory.getInitialState()) {
+                        labeledStates.set(productIndex[productState]);
+                    }
+                }
+            }
+            labeling.addLabel(label, std::move(labeledStates));
+        }
+        if (addMemoryLabels) {
+            for (uint64_t node = 0; node < numberOfMemoryStates; ++node) {
+                storm::storage::BitVector labeledStates(numberOfStates, false);
+                for (uint64_t productState : reachable) {
+                    if (productState % numberOfMemoryStates == node) {
+                        labeledStates.set(productIndex[productState]);
+                    }
+                }
+                labeling.addLabel("memstate_" + std::to_string(node), std::move(labeledStates));
+            }
+        }
+
+        std::unordered_map<std::string, storm::models::sparse::StandardRewardModel<ValueType>> rewardModels;
+        for (auto const& rewardModel : pomdp->getRewardModels()) {
+            boost::optional<std::vector<ValueType>> stateRewards;
+            boost::optional<std::vector<ValueType>> stateActionRewards;
+            if (rewardModel.second.hasStateRewards()) {
+                stateRewards = std::vector<ValueType>();
+                stateRewards->reserve(numberOfStates);
+                for (uint64_t productState : reachable) {
+                    stateRewards->push_back(rewardModel.second.getStateReward(productState / numberOfMemoryStates));
+                }
+            }
+            if (rewardModel.second.hasStateActionRewards()) {
+                stateActionRewards = std::vector<ValueType>();
+                stateActionRewards->reserve(numberOfRows);
+                for (uint64_t choice : originalRow) {
+                    stateActionRewards->push_back(rewardModel.second.getStateActionReward(choice));
+                }
+            }
+            rewardModels.emplace(rewardModel.first, storm::models::sparse::StandardRewardModel<ValueType>(std::move(stateRewards), std::move(stateActionRewards)));
+        }
+
+        storm::storage::sparse::ModelComponents<ValueType> components(builder.build(), std::move(labeling), std::move(rewardModels));
+        components.observabilityClasses = std::move(observations);
+        if (pomdp->hasChoiceLabeling()) {
+            storm::models::sparse::ChoiceLabeling choiceLabeling(numberOfRows);
+            for (auto const& label : pomdp->getChoiceLabeling().getLabels()) {
+                storm::storage::BitVector labeledChoices(numberOfRows, false);
+                for (uint64_t productRow = 0; productRow < numberOfRows; ++productRow) {
+                    if (pomdp->getChoiceLabeling().getChoiceHasLabel(label, originalRow[productRow])) {
+                        labeledChoices.set(productRow);
+                    }
+                }
+                choiceLabeling.addLabel(label, std::move(labeledChoices));
+            }
+            components.choiceLabeling = std::move(choiceLabeling);
+        }
+        // For a canonic POMDP, the choices (a, n') of product states with the same observation coincide
+        return std::make_shared<Pomdp<ValueType>>(std::move(components), pomdp->isCanonic());
+    }
+
+    /*!
+     * Build the Markov chain induced by a randomized finite-state controller. Only available for doubles.
+     * @param policy Probability of choosing (a, n') in product states with observation o and memory node n,
+     *               given as dense array of shape (observations, memory nodes, maximal number of choices, memory nodes) in row-major order.
+     * @return The induced Markov chain on the reachable product states and for each of its states the pair (s, n).
+     */
+    std::pair<std::shared_ptr<storm::models::sparse::Dtmc<ValueType>>, std::vector<uint64_t>> inducedDtmc(ValueType const* policy) const {
+        auto const& matrix = pomdp->getTransitionMatrix();
+        auto const& rowGroupIndices = matrix.getRowGroupIndices();
+        uint64_t const nodeStride = numberOfMemoryStates;
+        uint64_t const choiceStride = maximalNumberOfChoices * nodeStride;
+        uint64_t const observationStride = numberOfMemoryStates * choiceStride;
+
+        // Product states in the order of exploration, initial states first
+        std::vector<uint64_t> explored;
+        std::unordered_map<uint64_t, uint64_t> index;
+        auto getIndex = [&](uint64_t productState) {
+            auto it = index.find(productState);
+            if (it != index.end()) {
+                return it->second;
+            }
+            index.emplace(productState, explored.size());
+            explored.push_back(productState);
+            return explored.size() - 1;
+        };
+        for (uint64_t state : pomdp->getInitialStates()) {
+            getIndex(state * numberOfMemoryStates + memory.getInitialState());
+        }
+        uint64_t numberOfInitialStates = explored.size();
+
+        std::vector<std::vector<std::pair<uint64_t, ValueType>>> rows;
+        std::vector<std::pair<uint64_t, ValueType>> distribution;
+        for (uint64_t current = 0; current < explored.size(); ++current) {
+            uint64_t state = explored[current] / numberOfMemoryStates;
+            uint64_t node = explored[current] % numberOfMemoryStates;
+            ValueType const* nodePolicy = policy + pomdp->getObservation(state) * observationStride + node * choiceStride;
+            distribution.clear();
+            ValueType total = storm::utility::zero<ValueType>();
+            for (uint64_t localChoice = 0; localChoice < maximalNumberOfChoices; ++localChoice) {
+                for (uint64_t successor = 0; successor < numberOfMemoryStates; ++successor) {
+                    ValueType probability = nodePolicy[localChoice * nodeStride + successor];
+                    if (storm::utility::isZero(probability)) {
+                        continue;
+                    }
+                    STORM_LOG_THROW(probability > storm::utility::zero<ValueType>(), storm::exceptions::InvalidArgumentException,
+                                    "Negative probability in the policy for state " << state << " and memory node " << node << ".");
+                    STORM_LOG_THROW(rowGroupIndices[state] + localChoice < rowGroupIndices[state + 1] && memory.hasTransition(node, successor),
+                                    storm::exceptions::InvalidArgumentException,
+                                    "The policy selects the unavailable choice (" << localChoice << ", " << successor << ") in state " << state << " and memory node " << node << ".");
+                    total += probability;
+                    for (auto const& entry : matrix.getRow(rowGroupIndices[state] + localChoice)) {
+                        distribution.emplace_back(entry.getColumn() * numberOfMemoryStates + successor, probability * entry.getValue());
+                    }
+                }
+            }
+            STORM_LOG_THROW(std::abs(total - storm::utility::one<ValueType>()) < 1e-6, storm::exceptions::InvalidArgumentException,
+                            "The policy for state " << state << " and memory node " << node << " is not a distribution.");
+
+            // Merge entries with the same target product state
+            std::sort(distribution.begin(), distribution.end(), [](auto const& first, auto const& second) { return first.first < second.first; });
+            std::vector<std::pair<uint64_t, ValueType>> row;
+            for (auto const& entry : distribution) {
+                if (!row.empty() && explored[row.back().first] == entry.first) {
+                    row.back().second += entry.second;
+                } else {
+                    row.emplace_back(getIndex(entry.first), entry.second);
+                }
+            }
+            rows.push_back(std::move(row));
+        }
+
+        uint64_t numberOfStates = explored.size();
+        uint64_t numberOfEntries = 0;
+        for (auto& row : rows) {
+            std::sort(row.begin(), row.end(), [](auto const& first, auto const& second) { return first.first < second.first; });
+            numberOfEntries += row.size();
+        }
+        storm::storage::SparseMatrixBuilder<ValueType> builder(numberOfStates, numberOfStates, numberOfEntries, true);
+        for (uint64_t state = 0; state < numberOfStates; ++state) {
+            for (auto const& entry : rows[state]) {
+                builder.addNextValue(state, entry.first, entry.second);
+            }
+        }
+
+        storm::models::sparse::StateLabeling labeling(numberOfStates);
+        for (auto const& label : pomdp->getStateLabeling().getLabels()) {
+            storm::storage::BitVector labeledStates(numberOfStates, false);
+            if (label == "init") {
+                for (uint64_t state = 0; state < numberOfInitialStates; ++state) {
+                    labeledStates.set(state);
+                }
+            } else {
+                for (uint64_t state = 0; state < numberOfStates; ++state) {
+                    labeledStates.set(state, pomdp->getStateLabeling().getStateHasLabel(label, explored[state] / numberOfMemoryStates));
+                }
+            }
+            labeling.addLabel(label, std::move(labeledStates));
+        }
+
+        // Action rewards are weighted with the probabilities of the policy
+        std::unordered_map<std::string, storm::models::sparse::StandardRewardModel<ValueType>> rewardModels;
+        for (auto const& rewardModel : pomdp->getRewardModels()) {
+            std::vector<ValueType> stateRewards(numberOfStates, storm::utility::zero<ValueType>());
+            for (uint64_t productState = 0; productState < numberOfStates; ++productState) {
+                uint64_t state = explored[productState] / numberOfMemoryStates;
+                uint64_t node = explored[productState] % numberOfMemoryStates;
+                if (rewardModel.second.hasStateRewards()) {
+                    stateRewards[productState] += rewardModel.second.getStateReward(state);
+                }
+                if (rewardModel.second.hasStateActionRewards()) {
+                    ValueType const* nodePolicy = policy + pomdp->getObservation(state) * observationStride + node * choiceStride;
+                    for (uint64_t localChoice = 0; localChoice < rowGroupIndices[state + 1] - rowGroupIndices[state]; ++localChoice) {
+                        ValueType probability = storm::utility::zero<ValueType>();
+                        for (uint64_t successor = 0; successor < numberOfMemoryStates; ++successor) {
+                            probability += nodePolicy[localChoice * nodeStride + successor];
+                        }
+                        stateRewards[productState] += probability * rewardModel.second.getStateActionReward(rowGroupIndices[state] + localChoice);
+                    }
+                }
+            }
+            rewardModels.emplace(rewardModel.first, storm::models::sparse::StandardRewardModel<ValueType>(std::move(stateRewards)));
+        }
+
+        storm::storage::sparse::ModelComponents<ValueType> components(builder.build(), std::move(labeling), std::move(rewardModels));
+        std::vector<uint64_t> productStates;
+        productStates.reserve(2 * numberOfStates);
+        for (uint64_t productState : explored) {
+            productStates.push_back(productState / numberOfMemoryStates);
+            productStates.push_back(productState % numberOfMemoryStates);
+        }
+        return std::make_pair(std::make_shared<storm::models::sparse::Dtmc<ValueType>>(std::move(components)), std::move(productStates));
+    }
+
+    uint64_t getNumberOfMemoryStates() const {
+        return numberOfMemoryStates;
+    }
+
+    uint64_t getMaximalNumberOfChoices() const {
+        return maximalNumberOfChoices;
+    }
+
+    uint64_t getNumberOfObservations() const {
+        return pomdp->getNrObservations();
+    }
+
+   private:
+    storm::storage::BitVector getReachableProductStates() const {
+        auto const& matrix = pomdp->getTransitionMatrix();
+        auto const& rowGroupIndices = matrix.getRowGroupIndices();
+        storm::storage::BitVector reachable(pomdp->getNumberOfStates() * numberOfMemoryStates, false);
+        std::vector<uint64_t> stack;
+        for (uint64_t state : pomdp->getInitialStates()) {
+            uint64_t productState = state * numberOfMemoryStates + memory.getInitialState();
+            reachable.set(productState);
+            stack.push_back(productState);
+        }
+        while (!stack.empty()) {
+            uint64_t productState = stack.back();
+            stack.pop_back();
+            uint64_t state = productState / numberOfMemoryStates;
+            for (uint64_t successor : memorySuccessors[productState % numberOfMemoryStates]) {
+                for (uint64_t choice = rowGroupIndices[state]; choice < rowGroupIndices[state + 1]; ++choice) {
+                    for (auto const& entry : matrix.getRow(choice)) {
+                        uint64_t target = entry.getColumn() * numberOfMemoryStates + successor;
+                        if (!reachable.get(target)) {
+                            reachable.set(target);
+                            stack.push_back(target);
+                        }
+                    }
+                }
+            }
+        }
+        return reachable;
+    }
+
+    std::shared_ptr<Pomdp<ValueType>> pomdp;
+    storm::storage::PomdpMemory memory;
+    uint64_t numberOfMemoryStates;
+    std::vector<std::vector<uint64_t>> memorySuccessors;
+    uint64_t maximalNumberOfChoices;
+};
+
+template<typename ValueType>
+std::shared_ptr<Pomdp<ValueType>> unfoldMemoryDirect(std::shared_ptr<Pomdp<ValueType>> const& pomdp, storm::storage::PomdpMemory const& memory, bool addMemoryLabels) {
+    return PomdpMemoryProduct<ValueType>(pomdp, memory).unfold(addMemoryLabels);
+}
+
+template<typename ValueType>
+void define_memory_product(py::module& m, std::string const& vtSuffix) {
+    m.def(("_unfold_memory_direct_" + vtSuffix).c_str(), &unfoldMemoryDirect<ValueType>, R"doc(
+        Unfold memory into a POMDP by building only the reachable product states.
+        The product matrix is written in one pass into preallocated storage.
+
+        :param pomdp: The POMDP.
+        :param memorystructure: The memory structure.
+        :param memorylabels: Whether a label memstate_i is added for the product states with memory node i.
+        :return: The product POMDP.
+        )doc", py::arg("pomdp"), py::arg("memorystructure"), py::arg("memorylabels") = false, py::call_guard<py::gil_scoped_release>());
+
+    if constexpr (std::is_same_v<ValueType, double>) {
+        py::class_<PomdpMemoryProduct<double>, std::shared_ptr<PomdpMemoryProduct<double>>>(m, ("PomdpMemoryProduct" + vtSuffix).c_str(), R"doc(
+            Product of a POMDP and a memory structure that is not built upfront.
+            The product state (s, n) has for each choice a of s and memory successor n' of n the choice (a, n'). Its observation is o(s) * |memory| + n.
+            )doc")
+            .def(py::init<std::shared_ptr<Pomdp<double>> const&, storm::storage::PomdpMemory const&>(), py::arg("pomdp"), py::arg("memorystructure"))
+            .def_property_readonly("nr_memory_states", &PomdpMemoryProduct<double>::getNumberOfMemoryStates, "Number of memory nodes")
+            .def_property_readonly("max_nr_choices", &PomdpMemoryProduct<double>::getMaximalNumberOfChoices, "Maximal number of choices of a POMDP state")
+            .def_property_readonly("nr_observations", &PomdpMemoryProduct<double>::getNumberOfObservations, "Number of observations of the POMDP")
+            .def("unfold", &PomdpMemoryProduct<double>::unfold, py::arg("memorylabels") = false, py::call_guard<py::gil_scoped_release>(),
+                 "Build the reachable part of the product POMDP")
+            .def("induced_dtmc", [](PomdpMemoryProduct<double> const& product, py::array_t<double, py::array::c_style | py::array::forcecast> const& policy) {
+                    std::vector<py::ssize_t> expectedShape = {static_cast<py::ssize_t>(product.getNumberOfObservations()), static_cast<py::ssize_t>(product.getNumberOfMemoryStates()),
+                                                              static_cast<py::ssize_t>(product.getMaximalNumberOfChoices()), static_cast<py::ssize_t>(product.getNumberOfMemoryStates())};
+                    STORM_LOG_THROW(policy.ndim() == 4 && std::equal(expectedShape.begin(), expectedShape.end(), policy.shape()), storm::exceptions::InvalidArgumentException,
+                                    "Expected a policy of shape (" << expectedShape[0] << ", " << expectedShape[1] << ", " << expectedShape[2] << ", " << expectedShape[3] << ").");
+                    std::pair<std::shared_ptr<storm::models::sparse::Dtmc<double>>, std::vector<uint64_t>> result;
+                    {
+                        py::gil_scoped_release release;
+                        result = product.inducedDtmc(policy.data());
+                    }
+                    py::array_t<uint64_t> productStates(std::vector<py::ssize_t>{static_cast<py::ssize_t>(result.second.size() / 2), 2}, result.second.data());
+                    return py::make_tuple(result.first, productStates);
+                }, py::arg("policy"), R"doc(
+                Build the Markov chain induced by a randomized finite-state controller, exploring only the product states reachable under the controller.
+
+                :param policy: NumPy array of shape (nr_observations, nr_memory_states, max_nr_choices, nr_memory_states) with the probability of choosing the a-th choice and memory successor n' in states with observation o and memory node n.
+                :return: Pair of the induced DTMC and a NumPy array with the POMDP state and memory node of each DTMC state. Action rewards are folded into state rewards.
+                )doc")
+        ;
+    }
+}
+
+template void define_memory_product<double>(py::module& m, std::string const& vtSuffix);
+template void define_memory_product<storm::RationalNumber>(py::module& m, std::string const& vtSuffix);
+template void define_memory_product<storm::RationalFunction>(py::module& m, std::string const& vtSuffix);
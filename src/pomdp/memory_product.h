@@ -0,0 +1,6 @@
+#pragma once
+
+#include "common.h"
+
+template<typename VT>
+void define_memory_product(py::module& m, std::string const& vtSuffix);
@@ -1,11 +1,86 @@
 #include "decomposition.h"
+#include "parallel_mec.h"
+
+#include <pybind11/numpy.h>
 
 #include "storm/storage/MaximalEndComponent.h"
 #include "storm/storage/MaximalEndComponentDecomposition.h"
+#include "storm/storage/StronglyConnectedComponent.h"
+#include "storm/storage/StronglyConnectedComponentDecomposition.h"
+#include "storm/exceptions/InvalidArgumentException.h"
 
 
 using MEC = storm::storage::MaximalEndComponent;
 template<typename ValueType> using MECDecomposition = storm::storage::MaximalEndComponentDecomposition<ValueType>;
+template<typename ValueType> using ParallelMECDecomposition = ParallelMaximalEndComponentDecomposition<ValueType>;
+using SCC = storm::storage::StronglyConnectedComponent;
+template<typename ValueType> using SCCDecomposition = storm::storage::StronglyConnectedComponentDecomposition<ValueType>;
+
+
+// Offsets of the blocks in the flat array of their sorted states, i.e. the states of block i are states[offsets[i]:offsets[i+1]]
+template<typename DecompositionType, typename StatesOf>
+py::tuple blocksToArrays(DecompositionType const& decomposition, StatesOf statesOf) {
+    py::array_t<uint64_t> offsets(decomposition.size() + 1);
+    auto offsetsData = offsets.mutable_unchecked<1>();
+    uint64_t numberOfStates = 0;
+    for (uint64_t block = 0; block < decomposition.size(); ++block) {
+        offsetsData(block) = numberOfStates;
+        numberOfStates += statesOf(decomposition.getBlock(block)).size();
+    }
+    offsetsData(decomposition.size()) = numberOfStates;
+    py::array_t<uint64_t> states(numberOfStates);
+    auto statesData = states.mutable_unchecked<1>();
+    uint64_t index = 0;
+    for (auto const& block : decomposition) {
+        // The state sets are ordered, hence the states of each block are sorted
+        for (auto state : statesOf(block)) {
+            statesData(index++) = state;
+        }
+    }
+    return py::make_tuple(offsets, states);
+}
+
+template<typename DecompositionType, typename StatesOf>
+py::array_t<int64_t> stateToBlock(DecompositionType const& decomposition, uint64_t numberOfStates, StatesOf statesOf) {
+    py::array_t<int64_t> result(numberOfStates);
+    auto data = result.mutable_unchecked<1>();
+    for (uint64_t state = 0; state < numberOfStates; ++state) {
+        data(state) = -1;
+    }
+    for (uint64_t block = 0; block < decomposition.size(); ++block) {
+        for (auto state : statesOf(decomposition.getBlock(block))) {
+            STORM_LOG_THROW(state < numberOfStates, storm::exceptions::InvalidArgumentException, "State " << state << " exceeds the number of states " << numberOfStates << ".");
+            data(state) = block;
+        }
+    }
+    return result;
+}
+
+template<typename ValueType>
+py::array_t<int64_t> choiceToMec(MECDecomposition<ValueType> const& mecs, uint64_t numberOfChoices) {
+    py::array_t<int64_t> result(numberOfChoices);
+    auto data = result.mutable_unchecked<1>();
+    for (uint64_t choice = 0; choice < numberOfChoices; ++choice) {
+        data(choice) = -1;
+    }
+    for (uint64_t index = 0; index < mecs.size(); ++index) {
+        for (auto const& stateChoices : mecs.getBlock(index)) {
+            for (auto choice : stateChoices.second) {
+                STORM_LOG_THROW(choice < numberOfChoices, storm::exceptions::InvalidArgumentException, "Choice " << choice << " exceeds the number of choices " << numberOfChoices << ".");
+                data(choice) = index;
+            }
+        }
+    }
+    return result;
+}
+
+static storm::storage::MaximalEndComponent::set_type mecStates(MEC const& mec) {
+    return mec.getStateSet();
+}
+
+static storm::storage::StateBlock const& sccStates(SCC const& scc) {
+    return scc;
+}
 
 
 void define_maximal_end_components(py::module& m) {
@@ -29,6 +104,129 @@ void define_maximal_end_component_decomposition(py::module& m, std::string const
         .def("__iter__", [](MECDecomposition<ValueType> const& mecs) {
                 return py::make_iterator(mecs.begin(), mecs.end());
             }, py::keep_alive<0, 1>() /* Essential: keep object alive while iterator exists */)
+        .def("state_arrays", [](MECDecomposition<ValueType> const& mecs) {
+                return blocksToArrays(mecs, mecStates);
+            }, R"doc(
+            Get the states of all MECs as flat NumPy arrays.
+
+            :return: Pair (offsets, states) such that states[offsets[i]:offsets[i+1]] are the sorted states of the i-th MEC.
+            )doc")
+        .def("choice_arrays", [](MECDecomposition<ValueType> const& mecs) {
+                std::vector<uint64_t> offsets;
+                std::vector<uint64_t> choices;
+                for (auto const& mec : mecs) {
+                    offsets.push_back(choices.size());
+                    for (auto const& stateChoices : mec) {
+                        choices.insert(choices.end(), stateChoices.second.begin(), stateChoices.second.end());
+                    }
+                }
+                offsets.push_back(choices.size());
+                return py::make_tuple(py::array_t<uint64_t>(offsets.size(), offsets.data()), py::array_t<uint64_t>(choices.size(), choices.data()));
+            }, R"doc(
+            Get the choices of all MECs as flat NumPy arrays.
+
+            :return: Pair (offsets, choices) such that choices[offsets[i]:offsets[i+1]] are the choices of the i-th MEC, ordered by state.
+            )doc")
+        .def("state_to_mec", [](MECDecomposition<ValueType> const& mecs, uint64_t numberOfStates) {
+                return stateToBlock(mecs, numberOfStates, mecStates);
+            }, py::arg("nr_states"), "Get a NumPy array with the index of the MEC of each state, -1 for states in no MEC")
+        .def("choice_to_mec", [](MECDecomposition<ValueType> const& mecs, uint64_t numberOfChoices) {
+                return choiceToMec(mecs, numberOfChoices);
+            }, py::arg("nr_choices"), "Get a NumPy array with the index of the MEC of each choice, -1 for choices in no MEC")
+        .def("choice_mask", [](MECDecomposition<ValueType> const& mecs, uint64_t numberOfChoices) {
+                py::array_t<bool> result(numberOfChoices);
+                auto data = result.mutable_unchecked<1>();
+                for (uint64_t choice = 0; choice < numberOfChoices; ++choice) {
+                    data(choice) = false;
+                }
+                for (auto const& mec : mecs) {
+                    for (auto const& stateChoices : mec) {
+                        for (auto choice : stateChoices.second) {
+                            STORM_LOG_THROW(choice < numberOfChoices, storm::exceptions::InvalidArgumentException, "Choice " << choice << " exceeds the number of choices " << numberOfChoices << ".");
+                            data(choice) = true;
+                        }
+                    }
+                }
+                return result;
+            }, py::arg("nr_choices"), "Get a NumPy array of Booleans indicating which choices are part of a MEC")
+    ;
+
+    py::class_<ParallelMECDecomposition<ValueType>, std::shared_ptr<ParallelMECDecomposition<ValueType>>, MECDecomposition<ValueType>>(m, ("ParallelMaximalEndComponentDecomposition"+vt_suffix).c_str(), R"doc(
+        Decomposition of maximal end components computed by several threads.
+        SCCs that have to be refined are processed independently as tasks. The MECs are ordered by their smallest state.
+        )doc")
+        .def(py::init<storm::models::sparse::NondeterministicModel<ValueType> const&, uint64_t>(), py::arg("model"), py::arg("nr_threads") = 0,
+             py::call_guard<py::gil_scoped_release>(), "Create MECs from model using the given number of threads (0 for the number of cores)")
+        .def(py::init<storm::storage::SparseMatrix<ValueType> const&, storm::storage::BitVector const&, storm::storage::BitVector const&, uint64_t>(), py::arg("matrix"),
+             py::arg("states"), py::arg("choices"), py::arg("nr_threads") = 0, py::call_guard<py::gil_scoped_release>(),
+             "Create MECs of the transition matrix restricted to the given states and choices")
+        // Same signatures as in the base class, but the precomputed mappings are used if they have the requested size
+        .def("state_to_mec", [](ParallelMECDecomposition<ValueType> const& decomposition, uint64_t numberOfStates) {
+                auto const& mapping = decomposition.getStateToMec();
+                if (mapping.size() != numberOfStates) {
+                    return stateToBlock(decomposition, numberOfStates, mecStates);
+                }
+                return py::array_t<int64_t>(mapping.size(), mapping.data());
+            }, py::arg("nr_states"), "Get a NumPy array with the index of the MEC of each state, -1 for states in no MEC")
+        .def("choice_to_mec", [](ParallelMECDecomposition<ValueType> const& decomposition, uint64_t numberOfChoices) {
+                auto const& mapping = decomposition.getChoiceToMec();
+                if (mapping.size() != numberOfChoices) {
+                    return choiceToMec(decomposition, numberOfChoices);
+                }
+                return py::array_t<int64_t>(mapping.size(), mapping.data());
+            }, py::arg("nr_choices"), "Get a NumPy array with the index of the MEC of each choice, -1 for choices in no MEC")
+        .def_property_readonly("nr_tasks", &ParallelMECDecomposition<ValueType>::getNumberOfTasks, "Number of SCCs that were refined")
+    ;
+
+}
+
+void define_strongly_connected_components(py::module& m) {
+
+    py::class_<SCC, std::shared_ptr<SCC>>(m, "StronglyConnectedComponent", "Strongly connected component")
+        .def_property_readonly("size", &SCC::size, "Number of states in SCC")
+        .def_property_readonly("is_trivial", &SCC::isTrivial, "Whether the SCC consists of a single state without self-loop")
+        .def("__iter__", [](SCC const& scc) {
+                return py::make_iterator(scc.begin(), scc.end());
+            }, py::keep_alive<0, 1>() /* Essential: keep object alive while iterator exists */)
+    ;
+
+}
+
+template<typename ValueType>
+std::shared_ptr<SCCDecomposition<ValueType>> createSccDecomposition(storm::storage::SparseMatrix<ValueType> const& matrix, storm::storage::BitVector const* subsystem,
+                                                                    bool onlyBottomSccs, bool dropNaiveSccs, bool topologicalSort) {
+    storm::storage::StronglyConnectedComponentDecompositionOptions options;
+    options.subsystem(subsystem).onlyBottomSccs(onlyBottomSccs).dropNaiveSccs(dropNaiveSccs).forceTopologicalSort(topologicalSort);
+    return std::make_shared<SCCDecomposition<ValueType>>(matrix, options);
+}
+
+template<typename ValueType>
+void define_strongly_connected_component_decomposition(py::module& m, std::string const& vt_suffix) {
+
+    py::class_<SCCDecomposition<ValueType>, std::shared_ptr<SCCDecomposition<ValueType>>>(m, ("StronglyConnectedComponentDecomposition"+vt_suffix).c_str(), R"doc(
+        Decomposition of strongly connected components.
+        If sorted topologically, transitions only lead from an SCC to the SCC itself or to SCCs with a smaller index, i.e., bottom SCCs come first.
+        )doc")
+        .def(py::init([](storm::models::sparse::Model<ValueType> const& model, storm::storage::BitVector const* subsystem, bool onlyBottomSccs, bool dropNaiveSccs, bool topologicalSort) {
+                return createSccDecomposition(model.getTransitionMatrix(), subsystem, onlyBottomSccs, dropNaiveSccs, topologicalSort);
+            }), py::arg("model"), py::arg("subsystem") = nullptr, py::arg("only_bottom_sccs") = false, py::arg("drop_naive_sccs") = false, py::arg("topological_sort") = false,
+            py::call_guard<py::gil_scoped_release>(), "Create SCCs from model, optionally restricted to the states of the subsystem")
+        .def(py::init(&createSccDecomposition<ValueType>), py::arg("matrix"), py::arg("subsystem") = nullptr, py::arg("only_bottom_sccs") = false,
+            py::arg("drop_naive_sccs") = false, py::arg("topological_sort") = false, py::call_guard<py::gil_scoped_release>(), "Create SCCs from transition matrix")
+        .def_property_readonly("size", &SCCDecomposition<ValueType>::size, "Number of SCCs in the decomposition")
+        .def("__iter__", [](SCCDecomposition<ValueType> const& sccs) {
+                return py::make_iterator(sccs.begin(), sccs.end());
+            }, py::keep_alive<0, 1>() /* Essential: keep object alive while iterator exists */)
+        .def("state_arrays", [](SCCDecomposition<ValueType> const& sccs) {
+                return blocksToArrays(sccs, sccStates);
+            }, R"doc(
+            Get the states of all SCCs as flat NumPy arrays.
+
+            :return: Pair (offsets, states) such that states[offsets[i]:offsets[i+1]] are the sorted states of the i-th SCC.
+            )doc")
+        .def("state_to_scc", [](SCCDecomposition<ValueType> const& sccs, uint64_t numberOfStates) {
+                return stateToBlock(sccs, numberOfStates, sccStates);
+            }, py::arg("nr_states"), "Get a NumPy array with the index of the SCC of each state, -1 for states in no SCC")
     ;
 
 }
@@ -38,3 +236,8 @@ template void define_maximal_end_component_decomposition<double>(py::module& m,
 template void define_maximal_end_component_decomposition<storm::RationalNumber>(py::module& m, std::string const& vt_suffix);
 template void define_maximal_end_component_decomposition<storm::Interval>(py::module& m, std::string const& vt_suffix);
 template void define_maximal_end_component_decomposition<storm::RationalFunction>(py::module& m, std::string const& vt_suffix);
+
+template void define_strongly_connected_component_decomposition<double>(py::module& m, std::string const& vt_suffix);
+template void define_strongly_connected_component_decomposition<storm::RationalNumber>(py::module& m, std::string const& vt_suffix);
+template void define_strongly_connected_component_decomposition<storm::Interval>(py::module& m, std::string const& vt_suffix);
+template void define_strongly_connected_component_decomposition<storm::RationalFunction>(py::module& m, std::string const& vt_suffix);
@@ -1,6 +1,9 @@
 #include "geometry.h"
 #include "src/helpers.h"
 #include <storm/storage/geometry/Polytope.h>
+#include <storm/utility/constants.h>
+
+#include <pybind11/numpy.h>
 
 template<typename ValueType>
 void define_geometry(py::module& m, std::string vt_suffix) {
@@ -9,6 +12,18 @@ void define_geometry(py::module& m, std::string vt_suffix) {
     polytope.def_property_readonly("vertices", &Polytope::getVertices);
     polytope.def("create_downward_closure", &Polytope::downwardClosure);
     polytope.def("get_vertices_clockwise", &Polytope::getVerticesInClockwiseOrder);
+    polytope.def_property_readonly("vertices_array", [](Polytope const& p) {
+        auto vertices = p.getVertices();
+        py::ssize_t dimension = vertices.empty() ? 0 : vertices.front().size();
+        py::array_t<double> array(std::vector<py::ssize_t>{static_cast<py::ssize_t>(vertices.size()), dimension});
+        auto view = array.mutable_unchecked<2>();
+        for (py::ssize_t row = 0; row < static_cast<py::ssize_t>(vertices.size()); ++row) {
+            for (py::ssize_t column = 0; column < dimension; ++column) {
+                view(row, column) = storm::utility::convertNumber<double>(vertices[row][column]);
+            }
+        }
+        return array;
+    }, "Vertices as NumPy array of doubles with one row per vertex");
 
 }
 
@@ -0,0 +1,320 @@
+#include "jani_flattening.h"
+#include "src/parallel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <sstream>
+
+#include <boost/container/flat_set.hpp>
+
+#include <storm/storage/jani/Automaton.h>
+#include <storm/storage/jani/AutomatonComposition.h>
+#include <storm/storage/jani/ParallelComposition.h>
+
+namespace {
+    uint64_t saturatingMultiply(uint64_t first, uint64_t second) {
+        if (first != 0 && second > std::numeric_limits<uint64_t>::max() / first) {
+            return std::numeric_limits<uint64_t>::max();
+        }
+        return first * second;
+    }
+
+    uint64_t saturatingAdd(uint64_t first, uint64_t second) {
+        return first > std::numeric_limits<uint64_t>::max() - second ? std::numeric_limits<uint64_t>::max() : first + second;
+    }
+}
+
+JaniEdgePruner::JaniEdgePruner(storm::jani::Model const& model, uint64_t numberOfThreads) : model(model), numberOfThreads(numberOfThreads) {
+    uint64_t numberOfAutomata = model.getNumberOfAutomata();
+    synchronizingActions.resize(numberOfAutomata);
+    outgoingEdges.resize(numberOfAutomata);
+    enabledEdges.resize(numberOfAutomata);
+    reachableLocations.resize(numberOfAutomata);
+    enabledActions.resize(numberOfAutomata);
+    usableActions.resize(numberOfAutomata);
+    for (uint64_t automatonIndex = 0; automatonIndex < numberOfAutomata; ++automatonIndex) {
+        auto const& automaton = model.getAutomata()[automatonIndex];
+        outgoingEdges[automatonIndex].resize(automaton.getNumberOfLocations());
+        auto const& edges = automaton.getEdges();
+        for (uint64_t edgeIndex = 0; edgeIndex < edges.size(); ++edgeIndex) {
+            outgoingEdges[automatonIndex][edges[edgeIndex].getSourceLocationIndex()].push_back(edgeIndex);
+        }
+        enabledEdges[automatonIndex].assign(edges.size(), true);
+        reachableLocations[automatonIndex].assign(automaton.getNumberOfLocations(), true);
+    }
+}
+
+bool JaniEdgePruner::collectComposition() {
+    storm::jani::Composition const& composition = model.getSystemComposition();
+    auto const* parallelComposition = dynamic_cast<storm::jani::ParallelComposition const*>(&composition);
+    if (parallelComposition == nullptr) {
+        // A single automaton does not synchronize
+        return dynamic_cast<storm::jani::AutomatonComposition const*>(&composition) != nullptr;
+    }
+
+    std::vector<uint64_t> automata;
+    std::vector<std::set<std::string>> inputEnabledActions;
+    std::set<uint64_t> seen;
+    for (auto const& subcomposition : parallelComposition->getSubcompositions()) {
+        auto const* automatonComposition = dynamic_cast<storm::jani::AutomatonComposition const*>(subcomposition.get());
+        if (automatonComposition == nullptr) {
+            return false;
+        }
+        uint64_t automatonIndex = model.getAutomatonIndex(automatonComposition->getAutomatonName());
+        if (!seen.insert(automatonIndex).second) {
+            // Multiple instances of the same automaton share its edges
+            return false;
+        }
+        automata.push_back(automatonIndex);
+        inputEnabledActions.push_back(automatonComposition->getInputEnabledActions());
+    }
+
+    for (auto const& vector : parallelComposition->getSynchronizationVectors()) {
+        std::vector<Participant> participants;
+        for (uint64_t position = 0; position < vector.size(); ++position) {
+            std::string const& input = vector.getInput(position);
+            if (storm::jani::SynchronizationVector::isNoActionInput(input)) {
+                continue;
+            }
+            uint64_t action = model.getActionIndex(input);
+            participants.push_back({automata[position], action, inputEnabledActions[position].count(input) > 0});
+            synchronizingActions[automata[position]].insert(action);
+        }
+        vectors.push_back(std::move(participants));
+    }
+    return true;
+}
+
+bool JaniEdgePruner::updateReachability(uint64_t automatonIndex) {
+    auto const& edges = model.getAutomata()[automatonIndex].getEdges();
+    std::vector<bool>& enabled = enabledEdges[automatonIndex];
+    std::vector<bool>& reachable = reachableLocations[automatonIndex];
+    reachable.assign(reachable.size(), false);
+
+    std::vector<uint64_t> stack;
+    for (uint64_t location : model.getAutomata()[automatonIndex].getInitialLocationIndices()) {
+        if (!reachable[location]) {
+            reachable[location] = true;
+            stack.push_back(location);
+        }
+    }
+    while (!stack.empty()) {
+        uint64_t location = stack.back();
+        stack.pop_back();
+        for (uint64_t edgeIndex : outgoingEdges[automatonIndex][location]) {
+            if (!enabled[edgeIndex]) {
+                continue;
+            }
+            for (auto const& destination : edges[edgeIndex].getDestinations()) {
+                if (!reachable[destination.getLocationIndex()]) {
+                    reachable[destination.getLocationIndex()] = true;
+                    stack.push_back(destination.getLocationIndex());
+                }
+            }
+        }
+    }
+
+    bool changed = false;
+    for (uint64_t edgeIndex = 0; edgeIndex < edges.size(); ++edgeIndex) {
+        if (enabled[edgeIndex] && !reachable[edges[edgeIndex].getSourceLocationIndex()]) {
+            enabled[edgeIndex] = false;
+            changed = true;
+        }
+    }
+    countEnabledActions(automatonIndex);
+    return changed;
+}
+
+void JaniEdgePruner::countEnabledActions(uint64_t automatonIndex) {
+    auto const& edges = model.getAutomata()[automatonIndex].getEdges();
+    std::map<uint64_t, uint64_t>& counts = enabledActions[automatonIndex];
+    counts.clear();
+    for (uint64_t edgeIndex = 0; edgeIndex < edges.size(); ++edgeIndex) {
+        if (enabledEdges[automatonIndex][edgeIndex]) {
+            ++counts[edges[edgeIndex].getActionIndex()];
+        }
+    }
+}
+
+void JaniEdgePruner::updateVectors() {
+    parallelFor(0, vectors.size(), numberOfThreads, [&](uint64_t vectorIndex) {
+        bool enabled = true;
+        for (Participant const& participant : vectors[vectorIndex]) {
+            if (!participant.inputEnabled && enabledActions[participant.automaton].count(participant.action) == 0) {
+                enabled = false;
+                break;
+            }
+        }
+        enabledVectors[vectorIndex] = enabled;
+    });
+
+    for (auto& actions : usableActions) {
+        actions.clear();
+    }
+    for (uint64_t vectorIndex = 0; vectorIndex < vectors.size(); ++vectorIndex) {
+        if (enabledVectors[vectorIndex]) {
+            for (Participant const& participant : vectors[vectorIndex]) {
+                usableActions[participant.automaton].insert(participant.action);
+            }
+        }
+    }
+}
+
+bool JaniEdgePruner::updateSynchronizableEdges(uint64_t automatonIndex) {
+    auto const& edges = model.getAutomata()[automatonIndex].getEdges();
+    bool changed = false;
+    for (uint64_t edgeIndex = 0; edgeIndex < edges.size(); ++edgeIndex) {
+        uint64_t action = edges[edgeIndex].getActionIndex();
+        // Actions not used by any vector are left alone
+        if (enabledEdges[automatonIndex][edgeIndex] && synchronizingActions[automatonIndex].count(action) > 0 && usableActions[automatonIndex].count(action) == 0) {
+            enabledEdges[automatonIndex][edgeIndex] = false;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+uint64_t JaniEdgePruner::countCombinations() const {
+    uint64_t combinations = 0;
+    for (uint64_t vectorIndex = 0; vectorIndex < vectors.size(); ++vectorIndex) {
+        if (!enabledVectors[vectorIndex]) {
+            continue;
+        }
+        uint64_t vectorCombinations = 1;
+        for (Participant const& participant : vectors[vectorIndex]) {
+            auto it = enabledActions[participant.automaton].find(participant.action);
+            if (it != enabledActions[participant.automaton].end()) {
+                vectorCombinations = saturatingMultiply(vectorCombinations, it->second);
+            } else if (!participant.inputEnabled) {
+                vectorCombinations = 0;
+            }
+        }
+        combinations = saturatingAdd(combinations, vectorCombinations);
+    }
+    // Edges with actions outside of the vectors are taken on their own
+    for (uint64_t automatonIndex = 0; automatonIndex < enabledActions.size(); ++automatonIndex) {
+        for (auto const& entry : enabledActions[automatonIndex]) {
+            if (synchronizingActions[automatonIndex].count(entry.first) == 0) {
+                combinations = saturatingAdd(combinations, entry.second);
+            }
+        }
+    }
+    return combinations;
+}
+
+storm::jani::Model JaniEdgePruner::prune(JaniFlatteningStatistics& statistics) {
+    uint64_t numberOfAutomata = model.getNumberOfAutomata();
+    statistics.automata = numberOfAutomata;
+    statistics.compositionSupported = collectComposition();
+    statistics.synchronizationVectors = vectors.size();
+    enabledVectors.assign(vectors.size(), true);
+    for (uint64_t automatonIndex = 0; automatonIndex < numberOfAutomata; ++automatonIndex) {
+        statistics.edges += model.getAutomata()[automatonIndex].getNumberOfEdges();
+        countEnabledActions(automatonIndex);
+    }
+    statistics.combinationsBefore = countCombinations();
+
+    // Guards are only decided after substituting the defined constants
+    storm::jani::Model substituted = model.substituteConstants();
+    for (uint64_t automatonIndex = 0; automatonIndex < numberOfAutomata; ++automatonIndex) {
+        auto const& edges = substituted.getAutomata()[automatonIndex].getEdges();
+        for (uint64_t edgeIndex = 0; edgeIndex < edges.size(); ++edgeIndex) {
+            if (edges[edgeIndex].getGuard().simplify().isFalse()) {
+                enabledEdges[automatonIndex][edgeIndex] = false;
+            }
+        }
+    }
+
+    std::vector<uint8_t> changed(numberOfAutomata);
+    do {
+        ++statistics.rounds;
+        parallelFor(0, numberOfAutomata, numberOfThreads, [&](uint64_t automatonIndex) { updateReachability(automatonIndex); });
+        updateVectors();
+        parallelFor(0, numberOfAutomata, numberOfThreads, [&](uint64_t automatonIndex) { changed[automatonIndex] = updateSynchronizableEdges(automatonIndex); });
+    } while (std::find(changed.begin(), changed.end(), 1) != changed.end());
+    // The last round did not disable any edge, hence the action counts are up to date
+
+    boost::container::flat_set<uint_fast64_t> remainingEdges;
+    for (uint64_t automatonIndex = 0; automatonIndex < numberOfAutomata; ++automatonIndex) {
+        for (uint64_t edgeIndex = 0; edgeIndex < enabledEdges[automatonIndex].size(); ++edgeIndex) {
+            if (enabledEdges[automatonIndex][edgeIndex]) {
+                remainingEdges.insert(storm::jani::Model::encodeAutomatonAndEdgeIndices(automatonIndex, edgeIndex));
+            }
+        }
+        statistics.unreachableLocations += std::count(reachableLocations[automatonIndex].begin(), reachableLocations[automatonIndex].end(), false);
+    }
+    statistics.prunedEdges = statistics.edges - remainingEdges.size();
+    statistics.disabledSynchronizationVectors = std::count(enabledVectors.begin(), enabledVectors.end(), false);
+    statistics.combinationsAfter = countCombinations();
+    return model.restrictEdges(remainingEdges);
+}
+
+std::pair<storm::jani::Model, JaniFlatteningStatistics> pruneJaniEdges(storm::jani::Model const& model, uint64_t numberOfThreads) {
+    JaniFlatteningStatistics statistics;
+    auto start = std::chrono::steady_clock::now();
+    storm::jani::Model pruned = JaniEdgePruner(model, numberOfThreads).prune(statistics);
+    statistics.prepassSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return {std::move(pruned), statistics};
+}
+
+std::pair<storm::jani::Model, JaniFlatteningStatistics> flattenJaniComposition(storm::jani::Model const& model, std::shared_ptr<storm::utility::solver::SmtSolverFactory> const& smtSolverFactory, uint64_t numberOfThreads) {
+    auto result = pruneJaniEdges(model, numberOfThreads);
+    auto start = std::chrono::steady_clock::now();
+    storm::jani::Model flattened = result.first.flattenComposition(smtSolverFactory);
+    result.second.flatteningSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (auto const& automaton : flattened.getAutomata()) {
+        result.second.flattenedEdges += automaton.getNumberOfEdges();
+    }
+    result.first = std::move(flattened);
+    return result;
+}
+
+void define_jani_flattening(py::module& m) {
+    py::class_<JaniFlatteningStatistics>(m, "JaniFlatteningStatistics", R"doc(
+        Statistics of pruning and flattening a JANI model.
+        Combinations count the synchronized edges the flattening has to consider: per synchronization vector the product of the numbers of participating edges,
+        plus the edges that are taken on their own.
+        )doc")
+        .def_readonly("nr_automata", &JaniFlatteningStatistics::automata, "Number of automata")
+        .def_readonly("nr_edges", &JaniFlatteningStatistics::edges, "Number of edges before pruning")
+        .def_readonly("nr_pruned_edges", &JaniFlatteningStatistics::prunedEdges, "Number of edges that can never be taken")
+        .def_readonly("nr_unreachable_locations", &JaniFlatteningStatistics::unreachableLocations, "Number of locations unreachable within their automaton")
+        .def_readonly("nr_synchronization_vectors", &JaniFlatteningStatistics::synchronizationVectors, "Number of synchronization vectors")
+        .def_readonly("nr_disabled_synchronization_vectors", &JaniFlatteningStatistics::disabledSynchronizationVectors, "Number of synchronization vectors that can never be taken")
+        .def_readonly("nr_combinations_before", &JaniFlatteningStatistics::combinationsBefore, "Number of edge combinations without pruning")
+        .def_readonly("nr_combinations_after", &JaniFlatteningStatistics::combinationsAfter, "Number of edge combinations after pruning")
+        .def_readonly("nr_flattened_edges", &JaniFlatteningStatistics::flattenedEdges, "Number of edges generated by the flattening, 0 if not flattened")
+        .def_readonly("rounds", &JaniFlatteningStatistics::rounds, "Number of rounds until the pruning reached a fixpoint")
+        .def_readonly("composition_supported", &JaniFlatteningStatistics::compositionSupported, "Whether synchronization was analysed. Otherwise only guards and locations were used for pruning")
+        .def_readonly("prepass_seconds", &JaniFlatteningStatistics::prepassSeconds, "Wall time of the pruning in seconds")
+        .def_readonly("flattening_seconds", &JaniFlatteningStatistics::flatteningSeconds, "Wall time of the flattening in seconds")
+        .def("__str__", [](JaniFlatteningStatistics const& stats) {
+            std::stringstream stream;
+            stream << "Pruned " << stats.prunedEdges << " of " << stats.edges << " edges, " << stats.unreachableLocations << " unreachable locations, "
+                   << stats.disabledSynchronizationVectors << " of " << stats.synchronizationVectors << " synchronization vectors disabled, "
+                   << stats.combinationsAfter << " of " << stats.combinationsBefore << " edge combinations remaining";
+            return stream.str();
+        })
+    ;
+
+    m.def("prune_jani_edges", &pruneJaniEdges, py::arg("model"), py::arg("nr_threads") = 0, py::call_guard<py::gil_scoped_release>(), R"doc(
+        Remove the edges of a JANI model that can never be taken.
+        An edge is removed if its guard is false, its source location is unreachable within its automaton, or its action can never synchronize.
+        The analysis ignores variables and is iterated until no further edge is removed, hence the resulting model is equivalent to the original.
+
+        :param model: The JANI model.
+        :param nr_threads: Number of threads, 0 for the number of cores.
+        :return: Pair of the pruned model and the statistics.
+        )doc");
+    m.def("flatten_jani_composition", &flattenJaniComposition, py::arg("model"), py::arg("smt_solver_factory") = std::make_shared<storm::utility::solver::SmtSolverFactory>(),
+          py::arg("nr_threads") = 0, py::call_guard<py::gil_scoped_release>(), R"doc(
+        Flatten the composition of a JANI model into a single automaton after removing the edges that can never be taken, see prune_jani_edges.
+        Pruning reduces the number of edge combinations the flattening has to enumerate and check for satisfiability.
+
+        :param model: The JANI model.
+        :param smt_solver_factory: Factory for the SMT solver used to discard unsatisfiable combinations.
+        :param nr_threads: Number of threads for the pruning, 0 for the number of cores.
+        :return: Pair of the flattened model and the statistics.
+        )doc");
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "common.h"
+
+#include <map>
+#include <set>
+
+#include <storm/storage/jani/Model.h>
+#include <storm/utility/solver.h>
+
+void define_jani_flattening(py::module& m);
+
+struct JaniFlatteningStatistics {
+    uint64_t automata = 0;
+    uint64_t edges = 0;
+    uint64_t prunedEdges = 0;
+    uint64_t unreachableLocations = 0;
+    uint64_t synchronizationVectors = 0;
+    uint64_t disabledSynchronizationVectors = 0;
+    // Number of edge combinations the flattening has to consider, before and after pruning (saturated at 2^64-1)
+    uint64_t combinationsBefore = 0;
+    uint64_t combinationsAfter = 0;
+    uint64_t flattenedEdges = 0;
+    uint64_t rounds = 0;
+    bool compositionSupported = true;
+    double prepassSeconds = 0;
+    double flatteningSeconds = 0;
+};
+
+/*!
+ * Removes edges of a JANI model that can never be taken, as an abstraction of location reachability over the composition.
+ * An edge is removed if its guard is false, its source location is unreachable within its automaton, or its action can never synchronize,
+ * i.e. every synchronization vector using the action at the position of the automaton requires an action of another automaton without edges.
+ * Removing edges may make further locations unreachable and further vectors impossible, so the analysis is iterated until a fixpoint.
+ * Variables are ignored, hence the result over-approximates the reachable behaviour and the pruned model is equivalent to the original.
+ * Automata are analysed in parallel, synchronization vectors (one per action) are checked in parallel.
+ */
+class JaniEdgePruner {
+   public:
+    JaniEdgePruner(storm::jani::Model const& model, uint64_t numberOfThreads);
+
+    /*!
+     * @return The model restricted to the edges that may be taken. Statistics are filled in accordingly.
+     */
+    storm::jani::Model prune(JaniFlatteningStatistics& statistics);
+
+   private:
+    struct Participant {
+        uint64_t automaton;
+        uint64_t action;
+        bool inputEnabled;
+    };
+
+    bool collectComposition();
+    // Recompute reachable locations and the edges leaving them, returns whether some edge was disabled
+    bool updateReachability(uint64_t automaton);
+    void countEnabledActions(uint64_t automaton);
+    void updateVectors();
+    // Disable edges whose action cannot synchronize, returns whether some edge was disabled
+    bool updateSynchronizableEdges(uint64_t automaton);
+    uint64_t countCombinations() const;
+
+    storm::jani::Model const& model;
+    uint64_t numberOfThreads;
+
+    std::vector<std::vector<Participant>> vectors;
+    // Per automaton: actions appearing at the position of the automaton in some vector
+    std::vector<std::set<uint64_t>> synchronizingActions;
+    // Per automaton and location: indices of the outgoing edges
+    std::vector<std::vector<std::vector<uint64_t>>> outgoingEdges;
+    std::vector<std::vector<bool>> enabledEdges;
+    std::vector<std::vector<bool>> reachableLocations;
+    // Per automaton: number of enabled edges per action index
+    std::vector<std::map<uint64_t, uint64_t>> enabledActions;
+    // Per automaton: actions appearing at the position of the automaton in some enabled vector
+    std::vector<std::set<uint64_t>> usableActions;
+    // Written concurrently, hence no std::vector<bool>
+    std::vector<uint8_t> enabledVectors;
+};
@@ -4,6 +4,45 @@
 #include "storm/models/sparse/ItemLabeling.h"
 #include "storm/models/sparse/StateLabeling.h"
 #include "storm/models/sparse/ChoiceLabeling.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+
+#include <pybind11/numpy.h>
+
+// Convert a Boolean mask of the given size or an array of indices into a bit vector
+storm::storage::BitVector arrayToBitVector(py::array const& items, uint64_t size) {
+    storm::storage::BitVector result(size);
+    if (items.dtype().kind() == 'b') {
+        auto mask = items.cast<py::array_t<bool, py::array::c_style | py::array::forcecast>>();
+        STORM_LOG_THROW(mask.ndim() == 1 && static_cast<uint64_t>(mask.size()) == size, storm::exceptions::InvalidArgumentException, "Mask has length " << mask.size() << " but expected " << size << ".");
+        bool const* data = mask.data();
+        for (uint64_t i = 0; i < size; ++i) {
+            if (data[i]) {
+                result.set(i);
+            }
+        }
+    } else {
+        auto indices = items.cast<py::array_t<int64_t, py::array::c_style | py::array::forcecast>>();
+        STORM_LOG_THROW(indices.ndim() == 1, storm::exceptions::InvalidArgumentException, "Expected a one-dimensional array of indices.");
+        int64_t const* data = indices.data();
+        for (py::ssize_t i = 0; i < indices.size(); ++i) {
+            STORM_LOG_THROW(data[i] >= 0 && static_cast<uint64_t>(data[i]) < size, storm::exceptions::InvalidArgumentException, "Index " << data[i] << " is out of range for " << size << " items.");
+            result.set(data[i]);
+        }
+    }
+    return result;
+}
+
+template<typename Labeling>
+void setItemsFromArrays(Labeling& labeling, py::dict const& labels, uint64_t size, void (Labeling::*setItems)(std::string const&, storm::storage::BitVector&&)) {
+    for (auto const& entry : labels) {
+        std::string label = entry.first.cast<std::string>();
+        storm::storage::BitVector items = arrayToBitVector(entry.second.cast<py::array>(), size);
+        if (!labeling.containsLabel(label)) {
+            labeling.addLabel(label);
+        }
+        (labeling.*setItems)(label, std::move(items));
+    }
+}
 
 // Define python bindings
 void define_labeling(py::module& m) {
@@ -29,6 +68,13 @@ void define_labeling(py::module& m) {
         .def("set_states", [](storm::models::sparse::StateLabeling& labeling, std::string const& label, storm::storage::BitVector const& states) {
                 labeling.setStates(label, states);
             }, "Add a label to the given states", py::arg("label"), py::arg("states"))
+        .def("set_states_from_arrays", [](storm::models::sparse::StateLabeling& labeling, py::dict const& labels) {
+                setItemsFromArrays(labeling, labels, labeling.getNumberOfItems(), &storm::models::sparse::StateLabeling::setStates);
+            }, py::arg("labels"), R"doc(
+            Set the states of several labels at once. Labels which do not exist yet are added.
+
+            :param labels: Dictionary from label to either a Boolean mask over all states or an array of state indices.
+            )doc")
         .def("__str__", &streamToString<storm::models::sparse::StateLabeling>)
     ;
 
@@ -41,6 +87,13 @@ void define_labeling(py::module& m) {
             .def("set_choices", [](storm::models::sparse::ChoiceLabeling& labeling, std::string const& label, storm::storage::BitVector const& choices) {
                 labeling.setChoices(label, choices);
             },  "Add a label to a the given choices", py::arg("label"), py::arg("choices"))
+            .def("set_choices_from_arrays", [](storm::models::sparse::ChoiceLabeling& labeling, py::dict const& labels) {
+                setItemsFromArrays(labeling, labels, labeling.getNumberOfItems(), &storm::models::sparse::ChoiceLabeling::setChoices);
+            }, py::arg("labels"), R"doc(
+            Set the choices of several labels at once. Labels which do not exist yet are added.
+
+            :param labels: Dictionary from label to either a Boolean mask over all choices or an array of choice indices.
+            )doc")
             .def("__str__", &streamToString<storm::models::sparse::ChoiceLabeling>)
     ;
 }
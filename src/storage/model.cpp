@@ -22,6 +22,10 @@
 #include "storm/storage/dd/DdManager.h"
 
 #include "storm/storage/Scheduler.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+#include "storm/exceptions/InvalidOperationException.h"
+
+#include <pybind11/numpy.h>
 
 #include <functional>
 #include <string>
@@ -52,6 +56,32 @@ template<storm::dd::DdType DdType, typename ValueType> using SymbolicRewardModel
 
 
 
+// Zero-copy views
+using NumpyVector = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+std::optional<std::vector<double>> numpyToVector(std::optional<NumpyVector> const& array) {
+    if (!array) {
+        return std::nullopt;
+    }
+    STORM_LOG_THROW(array->ndim() == 1, storm::exceptions::InvalidArgumentException, "Expected a one-dimensional array.");
+    return std::vector<double>(array->data(), array->data() + array->size());
+}
+
+// The returned array refers to the memory of the vector and keeps the owner alive
+py::array_t<double> vectorView(std::vector<double>& vector, py::object const& owner) {
+    return py::array_t<double>({vector.size()}, {sizeof(double)}, vector.data(), owner);
+}
+
+py::array_t<double> matrixValuesView(storm::storage::SparseMatrix<double>& matrix, py::object const& owner) {
+    if (matrix.getEntryCount() == 0) {
+        return py::array_t<double>(0);
+    }
+    // Entries are stored contiguously as (column, value) pairs
+    using Entry = storm::storage::MatrixEntry<storm::storage::SparseMatrix<double>::index_type, double>;
+    double* firstValue = const_cast<double*>(&matrix.begin()->getValue());
+    return py::array_t<double>({static_cast<size_t>(matrix.getEntryCount())}, {sizeof(Entry)}, firstValue, owner);
+}
+
 // Thin wrappers
 template<typename ValueType>
 std::vector<storm::storage::sparse::state_type> getSparseInitialStates(SparseModel<ValueType> const& model) {
@@ -290,7 +320,8 @@ void define_sparse_model(py::module& m, std::string const& vtSuffix) {
         .def("get_player_of_state", &SparseSmg<ValueType>::getPlayerOfState, py::arg("state"), "Get player for the given state")
     ;
 
-    py::class_<SparseRewardModel<ValueType>>(m, ("Sparse" + vtSuffix + "RewardModel").c_str(), "Reward structure for sparse models")
+    py::class_<SparseRewardModel<ValueType>> rewardModel(m, ("Sparse" + vtSuffix + "RewardModel").c_str(), "Reward structure for sparse models");
+    rewardModel
         .def(py::init<std::optional<std::vector<ValueType>> const&, std::optional<std::vector<ValueType>> const&,
                 std::optional<storm::storage::SparseMatrix<ValueType>> const&>(), py::arg("optional_state_reward_vector") = std::nullopt,
                 py::arg("optional_state_action_reward_vector") = std::nullopt,  py::arg("optional_transition_reward_matrix") = std::nullopt)
@@ -307,6 +338,30 @@ void define_sparse_model(py::module& m, std::string const& vtSuffix) {
         .def("reduce_to_state_based_rewards", [](SparseRewardModel<ValueType>& rewardModel, storm::storage::SparseMatrix<ValueType> const& transitions, bool onlyStateRewards){return rewardModel.reduceToStateBasedRewards(transitions, onlyStateRewards);},  py::arg("transition_matrix"), py::arg("only_state_rewards"), "Reduce to state-based rewards")
     ;
 
+    if constexpr (std::is_same_v<ValueType, double>) {
+        // Zero-copy access via NumPy is only possible for native value types
+        rewardModel
+            .def(py::init([](std::optional<NumpyVector> const& stateRewards, std::optional<NumpyVector> const& stateActionRewards, std::optional<storm::storage::SparseMatrix<double>> const& transitionRewards) {
+                    return SparseRewardModel<double>(numpyToVector(stateRewards), numpyToVector(stateActionRewards), transitionRewards);
+                }), py::kw_only(), py::arg("state_rewards") = std::nullopt, py::arg("state_action_rewards") = std::nullopt, py::arg("transition_rewards") = std::nullopt,
+                "Construct the reward model from NumPy arrays. The arrays are copied once into the reward model.")
+            .def_property_readonly("state_rewards_array", [](py::object self) {
+                    auto& rewards = self.cast<SparseRewardModel<double>&>();
+                    STORM_LOG_THROW(rewards.hasStateRewards(), storm::exceptions::InvalidOperationException, "The reward model has no state rewards.");
+                    return vectorView(rewards.getStateRewardVector(), self);
+                }, "Writable NumPy view on the state rewards. The view is only valid as long as the reward model is not modified otherwise.")
+            .def_property_readonly("state_action_rewards_array", [](py::object self) {
+                    auto& rewards = self.cast<SparseRewardModel<double>&>();
+                    STORM_LOG_THROW(rewards.hasStateActionRewards(), storm::exceptions::InvalidOperationException, "The reward model has no state-action rewards.");
+                    return vectorView(rewards.getStateActionRewardVector(), self);
+                }, "Writable NumPy view on the state-action rewards. The view is only valid as long as the reward model is not modified otherwise.")
+            .def_property_readonly("transition_rewards_array", [](py::object self) {
+                    auto& rewards = self.cast<SparseRewardModel<double>&>();
+                    STORM_LOG_THROW(rewards.hasTransitionRewards(), storm::exceptions::InvalidOperationException, "The reward model has no transition rewards.");
+                    return matrixValuesView(rewards.getTransitionRewardMatrix(), self);
+                }, "Writable NumPy view on the values of the transition reward matrix in the order of its entries. The view is only valid as long as the reward model is not modified otherwise.")
+        ;
+    }
 }
 
 void define_sparse_parametric_model(py::module& m) {
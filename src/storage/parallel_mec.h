@@ -0,0 +1,388 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
+
+#include "src/parallel.h"
+
+#include "storm/models/sparse/NondeterministicModel.h"
+#include "storm/storage/BitVector.h"
+#include "storm/storage/MaximalEndComponent.h"
+#include "storm/storage/MaximalEndComponentDecomposition.h"
+#include "storm/storage/SparseMatrix.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+
+/*!
+ * Computation of maximal end components by several threads.
+ * The classical algorithm alternates between an SCC decomposition and the removal of choices leaving their SCC.
+ * As the SCCs obtained in one step are refined independently of each other, they are distributed over the threads as tasks.
+ * Within a task, the choices leaving the SCC and the states without remaining choices are removed until a fixpoint is reached.
+ * If nothing was removed, the SCC is a MEC. Otherwise the remaining states are decomposed into SCCs (Tarjan), which yields new tasks.
+ * Tasks are owned by a single thread, hence the per-state data of a task is only written by this thread.
+ */
+template<typename ValueType>
+class ParallelMaximalEndComponentComputation {
+   public:
+    ParallelMaximalEndComponentComputation(storm::storage::SparseMatrix<ValueType> const& matrix, storm::storage::BitVector const& states, storm::storage::BitVector const& choices)
+        : matrix(matrix), rowGroupIndices(matrix.getRowGroupIndices()) {
+        uint64_t numberOfStates = matrix.getRowGroupCount();
+        STORM_LOG_THROW(states.size() == numberOfStates, storm::exceptions::InvalidArgumentException, "Expected " << numberOfStates << " states, got " << states.size() << ".");
+        STORM_LOG_THROW(choices.size() == matrix.getRowCount(), storm::exceptions::InvalidArgumentException, "Expected " << matrix.getRowCount() << " choices, got " << choices.size() << ".");
+
+        componentOfState = std::vector<std::atomic<uint64_t>>(numberOfStates);
+        for (uint64_t state = 0; state < numberOfStates; ++state) {
+            componentOfState[state].store(states.get(state) ? 0 : Removed, std::memory_order_relaxed);
+        }
+        allowedChoices.resize(matrix.getRowCount());
+        for (uint64_t row = 0; row < matrix.getRowCount(); ++row) {
+            allowedChoices[row] = choices.get(row);
+        }
+        tarjanIndex.assign(numberOfStates, Unvisited);
+        lowLink.assign(numberOfStates, 0);
+        onStack.assign(numberOfStates, false);
+        initialStates = std::vector<uint64_t>(states.begin(), states.end());
+    }
+
+    /*!
+     * @return The states of each MEC in ascending order, the MECs are ordered by their smallest state.
+     */
+    std::vector<std::vector<uint64_t>> compute(uint64_t numberOfThreads);
+
+    /*!
+     * @return Whether the choice remains in its MEC. Only valid after compute() and for states in a MEC.
+     */
+    bool isChoiceAllowed(uint64_t row) const {
+        return allowedChoices[row];
+    }
+
+    /*!
+     * @return The number of SCCs that were refined.
+     */
+    uint64_t getNumberOfTasks() const {
+        return numberOfTasks;
+    }
+
+   private:
+    static const uint64_t Removed = std::numeric_limits<uint64_t>::max();
+    static const uint64_t Unvisited = std::numeric_limits<uint64_t>::max();
+    // Smaller tasks are processed by the thread that created them
+    static const uint64_t LocalTaskSize = 1024;
+
+    struct Task {
+        uint64_t component;
+        std::vector<uint64_t> states;
+    };
+
+    bool isInComponent(uint64_t state, uint64_t component) const {
+        return componentOfState[state].load(std::memory_order_relaxed) == component;
+    }
+
+    bool leavesComponent(uint64_t row, uint64_t component) const {
+        for (auto const& entry : matrix.getRow(row)) {
+            if (!isInComponent(entry.getColumn(), component)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*!
+     * Remove choices leaving the SCC of the task and states without choices until a fixpoint is reached.
+     * Stores the task as MEC if nothing was removed, otherwise returns the SCCs of the remaining states.
+     */
+    std::vector<Task> refine(Task const& task, std::vector<std::vector<uint64_t>>& mecs) {
+        bool changed = false;
+        bool removedState;
+        do {
+            removedState = false;
+            for (uint64_t state : task.states) {
+                if (!isInComponent(state, task.component)) {
+                    continue;
+                }
+                bool hasChoice = false;
+                for (uint64_t row = rowGroupIndices[state]; row < rowGroupIndices[state + 1]; ++row) {
+                    if (!allowedChoices[row]) {
+                        continue;
+                    }
+                    if (leavesComponent(row, task.component)) {
+                        allowedChoices[row] = false;
+                        changed = true;
+                    } else {
+                        hasChoice = true;
+                    }
+                }
+                if (!hasChoice) {
+                    componentOfState[state].store(Removed, std::memory_order_relaxed);
+                    removedState = true;
+                    changed = true;
+                }
+            }
+        } while (removedState);
+
+        std::vector<uint64_t> remaining;
+        for (uint64_t state : task.states) {
+            if (isInComponent(state, task.component)) {
+                remaining.push_back(state);
+            }
+        }
+        if (!changed) {
+            if (!remaining.empty()) {
+                mecs.push_back(std::move(remaining));
+            }
+            return {};
+        }
+        return computeSccs(remaining, task.component);
+    }
+
+    /*!
+     * Tarjan's algorithm on the given states of a component, using the allowed choices. Each SCC is assigned a new component.
+     */
+    std::vector<Task> computeSccs(std::vector<uint64_t> const& states, uint64_t component) {
+        struct Frame {
+            uint64_t state;
+            uint64_t row;
+            typename storm::storage::SparseMatrix<ValueType>::const_iterator entry;
+        };
+
+        std::vector<Task> result;
+        std::vector<uint64_t> stack;
+        std::vector<Frame> frames;
+        uint64_t counter = 0;
+        for (uint64_t state : states) {
+            tarjanIndex[state] = Unvisited;
+        }
+
+        auto visit = [&](uint64_t state) {
+            tarjanIndex[state] = lowLink[state] = counter++;
+            stack.push_back(state);
+            onStack[state] = true;
+            uint64_t row = rowGroupIndices[state];
+            frames.push_back({state, row, matrix.begin(row)});
+        };
+
+        for (uint64_t root : states) {
+            if (tarjanIndex[root] != Unvisited) {
+                continue;
+            }
+            visit(root);
+            while (!frames.empty()) {
+                uint64_t state = frames.back().state;
+                uint64_t successor = Unvisited;
+                uint64_t rowEnd = rowGroupIndices[state + 1];
+                while (frames.back().row < rowEnd) {
+                    Frame& frame = frames.back();
+                    if (!allowedChoices[frame.row] || frame.entry == matrix.end(frame.row)) {
+                        ++frame.row;
+                        if (frame.row < rowEnd) {
+                            frame.entry = matrix.begin(frame.row);
+                        }
+                        continue;
+                    }
+                    uint64_t target = frame.entry->getColumn();
+                    ++frame.entry;
+                    if (!isInComponent(target, component)) {
+                        continue;
+                    }
+                    if (tarjanIndex[target] == Unvisited) {
+                        successor = target;
+                        break;
+                    } else if (onStack[target]) {
+                        lowLink[state] = std::min(lowLink[state], tarjanIndex[target]);
+                    }
+                }
+                if (successor != Unvisited) {
+                    visit(successor);
+                    continue;
+                }
+
+                frames.pop_back();
+                if (!frames.empty()) {
+                    uint64_t parent = frames.back().state;
+                    lowLink[parent] = std::min(lowLink[parent], lowLink[state]);
+                }
+                if (lowLink[state] == tarjanIndex[state]) {
+                    Task scc{nextComponent++, {}};
+                    uint64_t member;
+                    do {
+                        member = stack.back();
+                        stack.pop_back();
+                        onStack[member] = false;
+                        scc.states.push_back(member);
+                    } while (member != state);
+                    result.push_back(std::move(scc));
+                }
+            }
+        }
+        // Assign the new components only now, as membership in the old component is checked during the search
+        for (Task const& scc : result) {
+            for (uint64_t state : scc.states) {
+                componentOfState[state].store(scc.component, std::memory_order_relaxed);
+            }
+        }
+        return result;
+    }
+
+    storm::storage::SparseMatrix<ValueType> const& matrix;
+    std::vector<uint64_t> const& rowGroupIndices;
+    // Component each state currently belongs to, only written by the thread owning the component
+    std::vector<std::atomic<uint64_t>> componentOfState;
+    std::atomic<uint64_t> nextComponent{1};
+    // Written concurrently for different states, hence no std::vector<bool>
+    std::vector<uint8_t> allowedChoices;
+    std::vector<uint64_t> tarjanIndex;
+    std::vector<uint64_t> lowLink;
+    std::vector<uint8_t> onStack;
+    std::vector<uint64_t> initialStates;
+    uint64_t numberOfTasks = 0;
+};
+
+template<typename ValueType>
+std::vector<std::vector<uint64_t>> ParallelMaximalEndComponentComputation<ValueType>::compute(uint64_t numberOfThreads) {
+    numberOfThreads = resolveNumberOfThreads(numberOfThreads);
+    std::mutex mutex;
+    std::condition_variable condition;
+    // The initial SCC decomposition yields the first tasks
+    std::deque<Task> queue;
+    for (auto& task : computeSccs(initialStates, 0)) {
+        queue.push_back(std::move(task));
+    }
+    // Tasks queued or being processed
+    uint64_t pendingTasks = queue.size();
+    bool aborted = false;
+    std::exception_ptr error;
+    std::vector<std::vector<std::vector<uint64_t>>> mecsPerThread(numberOfThreads);
+    std::atomic<uint64_t> tasks(0);
+
+    parallelFor(0, numberOfThreads, numberOfThreads, [&](uint64_t thread) {
+        while (true) {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&]() { return !queue.empty() || pendingTasks == 0 || aborted; });
+                if (queue.empty() || aborted) {
+                    return;
+                }
+                task = std::move(queue.front());
+                queue.pop_front();
+            }
+            std::vector<Task> newTasks;
+            try {
+                std::vector<Task> localTasks;
+                localTasks.push_back(std::move(task));
+                while (!localTasks.empty()) {
+                    Task current = std::move(localTasks.back());
+                    localTasks.pop_back();
+                    ++tasks;
+                    for (auto& subtask : refine(current, mecsPerThread[thread])) {
+                        (subtask.states.size() < LocalTaskSize ? localTasks : newTasks).push_back(std::move(subtask));
+                    }
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                aborted = true;
+                condition.notify_all();
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            pendingTasks += newTasks.size();
+            --pendingTasks;
+            for (auto& newTask : newTasks) {
+                queue.push_back(std::move(newTask));
+            }
+            condition.notify_all();
+        }
+    });
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    numberOfTasks = tasks.load();
+
+    std::vector<std::vector<uint64_t>> mecs;
+    for (auto& threadMecs : mecsPerThread) {
+        for (auto& mec : threadMecs) {
+            std::sort(mec.begin(), mec.end());
+            mecs.push_back(std::move(mec));
+        }
+    }
+    std::sort(mecs.begin(), mecs.end(), [](auto const& first, auto const& second) { return first.front() < second.front(); });
+    return mecs;
+}
+
+/*!
+ * Decomposition into maximal end components computed by several threads, see ParallelMaximalEndComponentComputation.
+ * The MECs are ordered by their smallest state, which makes the result independent of the number of threads.
+ */
+template<typename ValueType>
+class ParallelMaximalEndComponentDecomposition : public storm::storage::MaximalEndComponentDecomposition<ValueType> {
+   public:
+    ParallelMaximalEndComponentDecomposition(storm::models::sparse::NondeterministicModel<ValueType> const& model, uint64_t numberOfThreads)
+        : ParallelMaximalEndComponentDecomposition(model.getTransitionMatrix(), storm::storage::BitVector(model.getNumberOfStates(), true),
+                                                   storm::storage::BitVector(model.getTransitionMatrix().getRowCount(), true), numberOfThreads) {
+    }
+
+    /*!
+     * @param matrix The transition matrix.
+     * @param states The states that may be part of a MEC.
+     * @param choices The choices that may be part of a MEC.
+     * @param numberOfThreads The number of threads, 0 for the number of cores.
+     */
+    ParallelMaximalEndComponentDecomposition(storm::storage::SparseMatrix<ValueType> const& matrix, storm::storage::BitVector const& states,
+                                             storm::storage::BitVector const& choices, uint64_t numberOfThreads) {
+        ParallelMaximalEndComponentComputation<ValueType> computation(matrix, states, choices);
+        std::vector<std::vector<uint64_t>> mecs = computation.compute(numberOfThreads);
+        numberOfTasks = computation.getNumberOfTasks();
+
+        auto const& rowGroupIndices = matrix.getRowGroupIndices();
+        stateToMec.assign(matrix.getRowGroupCount(), -1);
+        choiceToMec.assign(matrix.getRowCount(), -1);
+        for (uint64_t mecIndex = 0; mecIndex < mecs.size(); ++mecIndex) {
+            storm::storage::MaximalEndComponent mec;
+            for (uint64_t state : mecs[mecIndex]) {
+                stateToMec[state] = mecIndex;
+                storm::storage::MaximalEndComponent::set_type stateChoices;
+                for (uint64_t row = rowGroupIndices[state]; row < rowGroupIndices[state + 1]; ++row) {
+                    if (computation.isChoiceAllowed(row)) {
+                        choiceToMec[row] = mecIndex;
+                        stateChoices.insert(row);
+                    }
+                }
+                mec.addState(state, std::move(stateChoices));
+            }
+            this->blocks.push_back(std::move(mec));
+        }
+    }
+
+    /*!
+     * @return For each state the index of its MEC, -1 if it is not part of a MEC.
+     */
+    std::vector<int64_t> const& getStateToMec() const {
+        return stateToMec;
+    }
+
+    /*!
+     * @return For each choice the index of the MEC it belongs to, -1 if it is not part of a MEC.
+     */
+    std::vector<int64_t> const& getChoiceToMec() const {
+        return choiceToMec;
+    }
+
+    /*!
+     * @return The number of SCCs that were refined.
+     */
+    uint64_t getNumberOfTasks() const {
+        return numberOfTasks;
+    }
+
+   private:
+    std::vector<int64_t> stateToMec;
+    std::vector<int64_t> choiceToMec;
+    uint64_t numberOfTasks = 0;
+};
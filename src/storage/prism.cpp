@@ -1,8 +1,8 @@
 #include "prism.h"
+#include <pybind11/numpy.h>
 #include <storm/storage/prism/Program.h>
 #include <boost/variant.hpp>
 #include <boost/algorithm/string/join.hpp>
-#include <random>
 #include <optional>
 #include "src/helpers.h"
 #include <storm/storage/expressions/ExpressionManager.h>
@@ -64,6 +64,7 @@ void define_prism(py::module& m) {
             .def_property_readonly("expression_manager", &Program::getManager, "Get the expression manager for expressions in this program")
             .def("get_synchronizing_action_indices", &Program::getSynchronizingActionIndices, "Get the synchronizing action indices")
             .def("get_action_name", &Program::getActionName, py::arg("action_index"), "Get the action name for a given action index")
+            .def("get_action_index", &Program::getActionIndex, py::arg("action_name"), "Get the action index for a given action name")
             .def("get_module_indices_by_action_index", &Program::getModuleIndicesByActionIndex, py::arg("action_index"), "get all modules that have a particular action index")
             .def_property_readonly("number_of_unlabeled_commands", &Program::getNumberOfUnlabeledCommands, "Gets the number of commands that are not labelled")
             .def("flatten", &Program::flattenModules, "Put program into a single module", py::arg("smt_factory")=std::shared_ptr<storm::utility::solver::SmtSolverFactory>(new storm::utility::solver::SmtSolverFactory()))
@@ -164,7 +165,7 @@ void define_prism(py::module& m) {
     py::class_<RewardModel, std::shared_ptr<RewardModel>> rewardModel(m, "PrismRewardModel", "Reward declaration in prism");
     rewardModel.def_property_readonly("name", &RewardModel::getName, "get name of the reward model");
 
-    //define_stateGeneration<uint32_t, storm::RationalNumber>(m);
+    define_stateGeneration<uint32_t, double>(m);
 
     py::class_<OverlappingGuardAnalyser> oga(m, "OverlappingGuardAnalyser", "An SMT driven analysis for overlapping guards");
     oga.def(py::init<Program const&, std::shared_ptr<storm::utility::solver::SmtSolverFactory>&>(), py::arg("program"), py::arg("smt solver factory"));
@@ -227,8 +228,7 @@ class GeneratorChoice {
     origins_type origins;
     distribution_type distribution;
 
-    private:
-    static origins_type getOriginsVector(storm::generator::Choice<ValueType, StateType> &choice) {
+    static origins_type getOriginsVector(storm::generator::Choice<ValueType, StateType> const& choice) {
         auto originsSet = boost::any_cast<storm::storage::FlatSet<uint_fast64_t>>(&choice.getOriginData());
         if (originsSet != nullptr) {
           return origins_type(originsSet->begin(), originsSet->end());
@@ -240,14 +240,63 @@ class GeneratorChoice {
         }
     }
 
+    GeneratorChoice(storm::generator::Choice<ValueType, StateType> const& choice) : origins(getOriginsVector(choice)), distribution(choice.begin(), choice.end()) {}
+};
+
+/*!
+ * Compact storage of explored states, indexed by their id.
+ * Each state occupies a fixed number of 64-bit words, avoiding one allocation per state.
+ */
+class StateArena {
     public:
-    GeneratorChoice(storm::generator::Choice<ValueType, StateType> &choice) : origins(getOriginsVector(choice)), distribution(choice.begin(), choice.end()) {}
+        StateArena(uint64_t bitsPerState) : bitsPerState(bitsPerState), wordsPerState(std::max<uint64_t>(1, (bitsPerState + 63) / 64)) {}
+
+        uint64_t size() const {
+            return words.size() / wordsPerState;
+        }
+
+        void push_back(storm::generator::CompressedState const& state) {
+            for (uint64_t word = 0; word < wordsPerState; ++word) {
+                uint64_t bitIndex = word * 64;
+                words.push_back(bitIndex < bitsPerState ? state.getAsInt(bitIndex, std::min<uint64_t>(64, bitsPerState - bitIndex)) : 0);
+            }
+        }
+
+        storm::generator::CompressedState get(uint64_t index) const {
+            storm::generator::CompressedState state(bitsPerState);
+            for (uint64_t word = 0; word < wordsPerState; ++word) {
+                uint64_t bitIndex = word * 64;
+                if (bitIndex < bitsPerState) {
+                    state.setFromInt(bitIndex, std::min<uint64_t>(64, bitsPerState - bitIndex), words[index * wordsPerState + word]);
+                }
+            }
+            return state;
+        }
+
+    private:
+        uint64_t bitsPerState;
+        uint64_t wordsPerState;
+        std::vector<uint64_t> words;
+};
+
+/*!
+ * Result of expanding several states at once, in compressed sparse row format.
+ * The choices of the i-th expanded state are [stateOffsets[i], stateOffsets[i+1]),
+ * the transitions of choice c are [choiceOffsets[c], choiceOffsets[c+1]) and its origins are [originOffsets[c], originOffsets[c+1]).
+ */
+template <typename StateType, typename ValueType>
+struct FrontierExpansion {
+    std::vector<uint64_t> stateOffsets{0};
+    std::vector<uint64_t> choiceOffsets{0};
+    std::vector<StateType> successors;
+    std::vector<ValueType> probabilities;
+    std::vector<uint64_t> originOffsets{0};
+    std::vector<uint64_t> origins;
 };
 
 template <typename StateType, typename ValueType>
 class StateGenerator {
     public:
-    typedef std::unordered_map<StateType, storm::generator::CompressedState> IdToStateMap;
     typedef std::vector<GeneratorChoice<StateType, ValueType>> choice_list_type;
 
     private:
@@ -259,8 +308,11 @@ class StateGenerator {
     // #justcppthings
     storm::storage::sparse::StateStorage<StateType> stateStorage;
     bool hasComputedInitialStates = false;
-    IdToStateMap stateMap;
+    // States by their id; the hash map in the state storage only maps states to ids
+    StateArena states;
     boost::optional<StateType> currentStateIndex;
+    // The generator keeps a reference to the loaded state, the arena only hands out copies
+    storm::generator::CompressedState currentState;
 
     static storm::generator::NextStateGeneratorOptions makeNextStateGeneratorOptions() {
         storm::generator::NextStateGeneratorOptions options;
@@ -268,38 +320,49 @@ class StateGenerator {
         return options;
     }
 
+    void computeInitialStates() {
+        if (!hasComputedInitialStates) {
+            stateStorage.initialStateIndices = generator.getInitialStates(stateToIdCallback);
+            hasComputedInitialStates = true;
+        }
+    }
+
     public:
-        StateGenerator(storm::prism::Program const& program_) : program(program_), generator(program_, StateGenerator<StateType, ValueType>::makeNextStateGeneratorOptions()), stateStorage(generator.getStateSize()) {
+        StateGenerator(storm::prism::Program const& program_) : program(program_), generator(program_, StateGenerator<StateType, ValueType>::makeNextStateGeneratorOptions()), stateStorage(generator.getStateSize()), states(generator.getStateSize()) {
             stateToIdCallback = [this] (storm::generator::CompressedState const& state) -> StateType {
                 StateType newIndex = stateStorage.getNumberOfStates();
-                std::pair<StateType, std::size_t> indexBucketPair = stateStorage.stateToId.findOrAddAndGetBucket(state, newIndex);
-                StateType index = indexBucketPair.first;
-                stateMap[index] = state;
+                StateType index = stateStorage.stateToId.findOrAdd(state, newIndex);
+                if (index == newIndex) {
+                    states.push_back(state);
+                }
                 return index;
             };
         }
 
         StateType loadInitialState() {
-            if (!hasComputedInitialStates) {
-                stateStorage.initialStateIndices = generator.getInitialStates(stateToIdCallback);
-                hasComputedInitialStates = true;
-            }
+            computeInitialStates();
             STORM_LOG_THROW(stateStorage.initialStateIndices.size() == 1, storm::exceptions::NotSupportedException, "Currently only models with one initial state are supported.");
             StateType initialStateIndex = stateStorage.initialStateIndices.front();
             load(initialStateIndex);
             return initialStateIndex;
         }
 
+        std::vector<StateType> getInitialStates() {
+            computeInitialStates();
+            return stateStorage.initialStateIndices;
+        }
+
+        uint64_t getNumberOfStates() const {
+            return states.size();
+        }
+
         void load(StateType stateIndex) {
             if (currentStateIndex && *currentStateIndex == stateIndex) {
                 return;
             }
-            auto search = stateMap.find(stateIndex);
-            if (search == stateMap.end()) {
-                STORM_LOG_THROW(false, storm::exceptions::InvalidAccessException,
-                        "state id not found");
-            }
-            generator.load(search->second);
+            STORM_LOG_THROW(stateIndex < states.size(), storm::exceptions::InvalidAccessException, "state id not found");
+            currentState = states.get(stateIndex);
+            generator.load(currentState);
             currentStateIndex = stateIndex;
         }
 
@@ -308,7 +371,7 @@ class StateGenerator {
                 STORM_LOG_THROW(false, storm::exceptions::InvalidStateException,
                         "Initial state not initialized");
             }
-            auto valuation = generator.toValuation(stateMap[*currentStateIndex]);
+            auto valuation = generator.toValuation(states.get(*currentStateIndex));
             return ValuationMapping(program, valuation);
         }
 
@@ -334,6 +397,42 @@ class StateGenerator {
             return choices_result;
         }
 
+        /*!
+         * Expand all given states. Newly discovered successors get consecutive ids starting at the previous number of states.
+         */
+        FrontierExpansion<StateType, ValueType> expandFrontier(std::vector<StateType> const& stateIndices) {
+            FrontierExpansion<StateType, ValueType> result;
+            for (StateType stateIndex : stateIndices) {
+                load(stateIndex);
+                auto behavior = expandBehavior();
+                for (auto const& choice : behavior.getChoices()) {
+                    for (auto const& entry : choice) {
+                        result.successors.push_back(entry.first);
+                        result.probabilities.push_back(entry.second);
+                    }
+                    result.choiceOffsets.push_back(result.successors.size());
+                    auto origins = GeneratorChoice<StateType, ValueType>::getOriginsVector(choice);
+                    result.origins.insert(result.origins.end(), origins.begin(), origins.end());
+                    result.originOffsets.push_back(result.origins.size());
+                }
+                result.stateOffsets.push_back(result.choiceOffsets.size() - 1);
+            }
+            return result;
+        }
+
+        /*!
+         * Evaluate the expression in all given states.
+         */
+        std::vector<bool> satisfiesStates(storm::expressions::Expression const& expression, std::vector<StateType> const& stateIndices) {
+            std::vector<bool> result;
+            result.reserve(stateIndices.size());
+            for (StateType stateIndex : stateIndices) {
+                load(stateIndex);
+                result.push_back(generator.satisfies(expression));
+            }
+            return result;
+        }
+
         bool isTerminal() {
             if (!hasComputedInitialStates) {
                 STORM_LOG_THROW(false, storm::exceptions::InvalidStateException,
@@ -346,123 +445,114 @@ class StateGenerator {
 
 };
 
-std::map<uint32_t, std::pair<storm::RationalNumber, storm::RationalNumber>> simulate(storm::prism::Program const& program, uint64_t totalSamples, uint64_t maxSteps) {
-    using StateType = uint32_t;
-    using ValueType = double;
-
-    StateGenerator<StateType, ValueType> generator(program);
-    std::map<StateType, std::pair<storm::RationalNumber, storm::RationalNumber>> result;
-    std::set<StateType> visited;
-    auto goal = program.getLabelExpression("goal");
-
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dis(0.0, 1.0);
-
-    const auto addSample = [&result](StateType state, bool isGoal) {
-        auto hitsVisits = result.count(state) != 0 ? result[state] : std::make_pair(0, 0);
-        if (isGoal) hitsVisits.first++;
-        hitsVisits.second++;
-        result[state] = hitsVisits;
-    };
-
-    const auto sampleBehavior = [&gen, &dis](std::vector<storm::generator::Choice<ValueType, StateType>> const& choices) -> StateType {
-        ValueType rnd = dis(gen);
-        STORM_LOG_THROW(choices.size() == 1, storm::exceptions::InvalidStateException, "nondeterminism");
-        auto choice = choices[0];
-        for (auto entry : choice) {
-            if (rnd <= entry.second) {
-                return entry.first;
+template <typename T>
+py::array_t<T> vectorToNumpy(std::vector<T> const& values) {
+    return py::array_t<T>(values.size(), values.data());
+}
+
+template <typename StateType, typename ValueType>
+void define_stateGeneration(py::module& m) {
+    py::class_<ValuationMapping, std::shared_ptr<ValuationMapping>> valuation_mapping(m, "ValuationMapping", "A valuation mapping for a state consists of a mapping from variable to value for each of the three types.");
+    valuation_mapping
+        .def_readonly("boolean_values", &ValuationMapping::booleanValues)
+        .def_readonly("integer_values", &ValuationMapping::integerValues)
+        .def_readonly("rational_values", &ValuationMapping::rationalValues)
+        .def("__str__", &ValuationMapping::toString);
+
+    py::class_<GeneratorChoice<StateType, ValueType>,
+              std::shared_ptr<GeneratorChoice<StateType, ValueType>>>
+        generator_choice(m, "GeneratorChoice", R"doc(
+            Representation of a choice taken by the generator.
+
+            :ivar origins: A list of command ids that generated this choice.
+            :vartype origins: List[int]
+            :ivar distribution: The probability distribution of this choice.
+            :vartype distribution: List[Pair[StateId, Probability]]
+    )doc");
+    generator_choice
+        .def_readonly("origins", &GeneratorChoice<StateType, ValueType>::origins)
+        .def_readonly("distribution", &GeneratorChoice<StateType, ValueType>::distribution);
+
+    py::class_<StateGenerator<StateType, ValueType>, std::shared_ptr<StateGenerator<StateType, ValueType>>> state_generator(m, "StateGenerator", R"doc(
+        Interactively explore states using Storm's PrismNextStateGenerator.
+        States are identified by consecutive ids in the order of their discovery.
+
+        :ivar program: A PRISM program.
+    )doc");
+    state_generator
+        .def(py::init<storm::prism::Program const&>(), py::arg("program"), py::keep_alive<1, 2>())
+        .def("load_initial_state", &StateGenerator<StateType, ValueType>::loadInitialState, R"doc(
+            Loads the (unique) initial state.
+            Multiple initial states are not supported.
+
+            :rtype: the ID of the initial state.
+        )doc")
+        .def("initial_states", &StateGenerator<StateType, ValueType>::getInitialStates, "Get the IDs of all initial states")
+        .def_property_readonly("nr_states", &StateGenerator<StateType, ValueType>::getNumberOfStates, "Number of states discovered so far")
+        .def("load", &StateGenerator<StateType, ValueType>::load, R"doc(
+            :param state_id: The ID of the state to load.
+        )doc", py::arg("state_id"))
+        .def("current_state_to_valuation", &StateGenerator<StateType, ValueType>::currentStateToValuation, R"doc(
+            Return a valuation for the currently loaded state.
+
+            :rtype: stormpy.ValuationMapping
+        )doc")
+        .def("current_state_satisfies", &StateGenerator<StateType, ValueType>::satisfies, R"doc(
+            Check if the currently loaded state satisfies the given expression.
+
+            :param stormpy.Expression expression: The expression to check against.
+            :rtype: bool
+        )doc", py::arg("expression"))
+        .def("expand", &StateGenerator<StateType, ValueType>::expand, R"doc(
+            Expand the currently loaded state and return its successors.
+
+            :rtype: [GeneratorChoice]
+        )doc")
+        .def("expand_frontier", [](StateGenerator<StateType, ValueType>& generator, py::array_t<StateType, py::array::c_style | py::array::forcecast> const& stateIds) {
+            std::vector<StateType> states(stateIds.data(), stateIds.data() + stateIds.size());
+            FrontierExpansion<StateType, ValueType> expansion;
+            {
+                py::gil_scoped_release release;
+                expansion = generator.expandFrontier(states);
             }
-            rnd -= entry.second;
-        }
-        STORM_LOG_THROW(false, storm::exceptions::InvalidStateException, "unreachable");
-    };
-
-    for (unsigned int i = 0; i <= totalSamples; i++) {
-        StateType state = generator.loadInitialState();
-        uint64_t steps = 0;
-        bool hitGoal = false;
-        visited.clear();
-
-        while (steps <= maxSteps) {
-            steps++;
-            visited.insert(state);
-
-            if (generator.satisfies(goal)) {
-                addSample(state, true);
-                break;
+            py::dict result;
+            result["state_offsets"] = vectorToNumpy(expansion.stateOffsets);
+            result["choice_offsets"] = vectorToNumpy(expansion.choiceOffsets);
+            result["successors"] = vectorToNumpy(expansion.successors);
+            result["probabilities"] = vectorToNumpy(expansion.probabilities);
+            result["origin_offsets"] = vectorToNumpy(expansion.originOffsets);
+            result["origins"] = vectorToNumpy(expansion.origins);
+            return result;
+        }, R"doc(
+            Expand all given states in one call and return the result as flat NumPy arrays in compressed sparse row format.
+            The choices of the i-th state are the range [state_offsets[i], state_offsets[i+1]),
+            the transitions of choice c are [choice_offsets[c], choice_offsets[c+1]) in successors and probabilities,
+            and the ids of the commands generating choice c are [origin_offsets[c], origin_offsets[c+1]) in origins.
+            Newly discovered states get consecutive ids, starting from the number of states before the call.
+
+            :param numpy.ndarray state_ids: The IDs of the states to expand.
+            :return: Dictionary with the arrays state_offsets, choice_offsets, successors, probabilities, origin_offsets and origins.
+            :rtype: dict
+        )doc", py::arg("state_ids"))
+        .def("satisfies_states", [](StateGenerator<StateType, ValueType>& generator, storm::expressions::Expression const& expression, py::array_t<StateType, py::array::c_style | py::array::forcecast> const& stateIds) {
+            std::vector<StateType> states(stateIds.data(), stateIds.data() + stateIds.size());
+            std::vector<bool> satisfied;
+            {
+                py::gil_scoped_release release;
+                satisfied = generator.satisfiesStates(expression, states);
             }
-
-            auto behavior = generator.expandBehavior();
-            auto choices = behavior.getChoices();
-            if (choices.empty()) {
-                addSample(state, false);
-                break;
+            py::array_t<bool> result(satisfied.size());
+            auto data = result.mutable_unchecked<1>();
+            for (uint64_t i = 0; i < satisfied.size(); ++i) {
+                data(i) = satisfied[i];
             }
+            return result;
+        }, R"doc(
+            Check which of the given states satisfy the expression.
 
-            state = sampleBehavior(choices);
-        }
-    }
-
-    return result;
-}
+            :param stormpy.Expression expression: The expression to check against.
+            :param numpy.ndarray state_ids: The IDs of the states.
+            :rtype: numpy.ndarray
+        )doc", py::arg("expression"), py::arg("state_ids"));
 
-template <typename StateType, typename ValueType>
-void define_stateGeneration(py::module& m) {
-//    py::class_<ValuationMapping, std::shared_ptr<ValuationMapping>> valuation_mapping(m, "ValuationMapping", "A valuation mapping for a state consists of a mapping from variable to value for each of the three types.");
-//    valuation_mapping
-//        .def_readonly("boolean_values", &ValuationMapping::booleanValues)
-//        .def_readonly("integer_values", &ValuationMapping::integerValues)
-//        .def_readonly("rational_values", &ValuationMapping::rationalValues)
-//        .def("__str__", &ValuationMapping::toString);
-//
-//    py::class_<GeneratorChoice<StateType, ValueType>,
-//              std::shared_ptr<GeneratorChoice<StateType, ValueType>>>
-//        generator_choice(m, "GeneratorChoice", R"doc(
-//            Representation of a choice taken by the generator.
-//
-//            :ivar origins: A list of command ids that generated this choice.
-//            :vartype origins: List[int]
-//            :ivar distribution: The probability distribution of this choice.
-//            :vartype distribution: List[Pair[StateId, Probability]]
-//    )doc");
-//    generator_choice
-//        .def_readonly("origins", &GeneratorChoice<StateType, ValueType>::origins)
-//        .def_readonly("distribution", &GeneratorChoice<StateType, ValueType>::distribution);
-//
-//    py::class_<StateGenerator<StateType, ValueType>, std::shared_ptr<StateGenerator<StateType, ValueType>>> state_generator(m, "StateGenerator", R"doc(
-//        Interactively explore states using Storm's PrismNextStateGenerator.
-//
-//        :ivar program: A PRISM program.
-//    )doc");
-//    state_generator
-//        .def(py::init<storm::prism::Program const&>())
-//        .def("load_initial_state", &StateGenerator<StateType, ValueType>::loadInitialState, R"doc(
-//            Loads the (unique) initial state.
-//            Multiple initial states are not supported.
-//
-//            :rtype: the ID of the initial state.
-//        )doc")
-//        .def("load", &StateGenerator<StateType, ValueType>::load, R"doc(
-//            :param state_id: The ID of the state to load.
-//        )doc")
-//        .def("current_state_to_valuation", &StateGenerator<StateType, ValueType>::currentStateToValuation, R"doc(
-//            Return a valuation for the currently loaded state.
-//
-//            :rtype: stormpy.ValuationMapping
-//        )doc")
-//        .def("current_state_satisfies", &StateGenerator<StateType, ValueType>::satisfies, R"doc(
-//            Check if the currently loaded state satisfies the given expression.
-//
-//            :param stormpy.Expression expression: The expression to check against.
-//            :rtype: bool
-//        )doc")
-//        .def("expand", &StateGenerator<StateType, ValueType>::expand, R"doc(
-//            Expand the currently loaded state and return its successors.
-//
-//            :rtype: [GeneratorChoice]
-//        )doc");
-//
-//    m.def("simulate", &simulate);
 }
@@ -7,6 +7,12 @@
 #include "storm/storage/expressions/SimpleValuation.h"
 #include "storm/storage/expressions/Variable.h"
 #include "storm/storage/sparse/StateValuations.h"
+#include "storm/utility/constants.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+#include "storm/exceptions/NotSupportedException.h"
+
+#include <pybind11/numpy.h>
+#include <boost/functional/hash.hpp>
 
 // Thin wrappers
 storm::json<storm::RationalNumber> toJson(storm::storage::sparse::StateValuations const& valuations, storm::storage::sparse::state_type const& stateIndex, boost::optional<std::set<storm::expressions::Variable>> const& selectedVariables) {
@@ -17,6 +23,160 @@ void add_state(storm::storage::sparse::StateValuationsBuilder& builder, storm::s
     return builder.addState(state, std::move(booleanValues), std::move(integerValues), std::move(rationalValues));
 }
 
+// Variables in the order of the valuation, taken from the first state
+std::vector<storm::expressions::Variable> getVariables(storm::storage::sparse::StateValuations const& valuations) {
+    std::vector<storm::expressions::Variable> variables;
+    if (valuations.getNumberOfStates() == 0) {
+        return variables;
+    }
+    auto range = valuations.at(0);
+    for (auto it = range.begin(); it != range.end(); ++it) {
+        if (it.isVariableAssignment()) {
+            variables.push_back(it.getVariable());
+        }
+    }
+    return variables;
+}
+
+std::vector<storm::expressions::Variable> selectVariables(storm::storage::sparse::StateValuations const& valuations, boost::optional<std::vector<storm::expressions::Variable>> const& selectedVariables) {
+    return selectedVariables ? selectedVariables.get() : getVariables(valuations);
+}
+
+// Export the valuations of all states as one typed column per variable
+py::dict toNumpy(storm::storage::sparse::StateValuations const& valuations, boost::optional<std::vector<storm::expressions::Variable>> const& selectedVariables) {
+    uint64_t nrStates = valuations.getNumberOfStates();
+    py::dict result;
+    for (auto const& variable : selectVariables(valuations, selectedVariables)) {
+        if (variable.hasBooleanType()) {
+            py::array_t<bool> column(nrStates);
+            auto data = column.mutable_unchecked<1>();
+            for (uint64_t state = 0; state < nrStates; ++state) {
+                data(state) = valuations.getBooleanValue(state, variable);
+            }
+            result[py::str(variable.getName())] = column;
+        } else if (variable.hasIntegerType()) {
+            py::array_t<int64_t> column(nrStates);
+            auto data = column.mutable_unchecked<1>();
+            for (uint64_t state = 0; state < nrStates; ++state) {
+                data(state) = valuations.getIntegerValue(state, variable);
+            }
+            result[py::str(variable.getName())] = column;
+        } else {
+            STORM_LOG_THROW(variable.hasRationalType(), storm::exceptions::NotSupportedException, "Variable " << variable.getName() << " has unsupported type.");
+            py::array_t<double> column(nrStates);
+            auto data = column.mutable_unchecked<1>();
+            for (uint64_t state = 0; state < nrStates; ++state) {
+                data(state) = storm::utility::convertNumber<double>(valuations.getRationalValue(state, variable));
+            }
+            result[py::str(variable.getName())] = column;
+        }
+    }
+    return result;
+}
+
+// Build valuations from one column per variable, the inverse of toNumpy
+std::shared_ptr<storm::storage::sparse::StateValuations> fromNumpy(std::vector<storm::expressions::Variable> const& variables, py::dict const& columns) {
+    std::vector<py::array_t<bool, py::array::c_style | py::array::forcecast>> booleanColumns;
+    std::vector<py::array_t<int64_t, py::array::c_style | py::array::forcecast>> integerColumns;
+    std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>> rationalColumns;
+    boost::optional<uint64_t> nrStates;
+
+    storm::storage::sparse::StateValuationsBuilder builder;
+    for (auto const& variable : variables) {
+        STORM_LOG_THROW(columns.contains(variable.getName()), storm::exceptions::InvalidArgumentException, "No column given for variable " << variable.getName() << ".");
+        py::object column = columns[py::str(variable.getName())];
+        uint64_t length;
+        if (variable.hasBooleanType()) {
+            booleanColumns.push_back(column.cast<py::array_t<bool, py::array::c_style | py::array::forcecast>>());
+            length = booleanColumns.back().size();
+        } else if (variable.hasIntegerType()) {
+            integerColumns.push_back(column.cast<py::array_t<int64_t, py::array::c_style | py::array::forcecast>>());
+            length = integerColumns.back().size();
+        } else {
+            STORM_LOG_THROW(variable.hasRationalType(), storm::exceptions::NotSupportedException, "Variable " << variable.getName() << " has unsupported type.");
+            rationalColumns.push_back(column.cast<py::array_t<double, py::array::c_style | py::array::forcecast>>());
+            length = rationalColumns.back().size();
+        }
+        STORM_LOG_THROW(!nrStates || nrStates.get() == length, storm::exceptions::InvalidArgumentException, "Column of variable " << variable.getName() << " has length " << length << " but expected " << nrStates.get() << ".");
+        nrStates = length;
+        builder.addVariable(variable);
+    }
+
+    for (uint64_t state = 0; state < nrStates.get_value_or(0); ++state) {
+        std::vector<bool> booleanValues;
+        booleanValues.reserve(booleanColumns.size());
+        for (auto const& column : booleanColumns) {
+            booleanValues.push_back(column.data()[state]);
+        }
+        std::vector<int64_t> integerValues;
+        integerValues.reserve(integerColumns.size());
+        for (auto const& column : integerColumns) {
+            integerValues.push_back(column.data()[state]);
+        }
+        std::vector<storm::RationalNumber> rationalValues;
+        rationalValues.reserve(rationalColumns.size());
+        for (auto const& column : rationalColumns) {
+            rationalValues.push_back(storm::utility::convertNumber<storm::RationalNumber>(column.data()[state]));
+        }
+        builder.addState(state, std::move(booleanValues), std::move(integerValues), std::move(rationalValues));
+    }
+    return std::make_shared<storm::storage::sparse::StateValuations>(builder.build());
+}
+
+/*!
+ * Reverse index from the values of Boolean and integer variables to the state id.
+ * If several states share the same values, the smallest state id is stored.
+ */
+class StateValuationIndex {
+public:
+    StateValuationIndex(storm::storage::sparse::StateValuations const& valuations, std::vector<storm::expressions::Variable> const& variables) : variables(variables) {
+        for (auto const& variable : variables) {
+            STORM_LOG_THROW(variable.hasBooleanType() || variable.hasIntegerType(), storm::exceptions::NotSupportedException, "Only Boolean and integer variables can be indexed, but " << variable.getName() << " is not.");
+        }
+        uint64_t nrStates = valuations.getNumberOfStates();
+        index.reserve(nrStates);
+        std::vector<int64_t> key(variables.size());
+        for (uint64_t state = 0; state < nrStates; ++state) {
+            for (uint64_t i = 0; i < variables.size(); ++i) {
+                key[i] = variables[i].hasBooleanType() ? static_cast<int64_t>(valuations.getBooleanValue(state, variables[i])) : valuations.getIntegerValue(state, variables[i]);
+            }
+            index.emplace(key, state);
+        }
+    }
+
+    boost::optional<uint64_t> getState(std::vector<int64_t> const& values) const {
+        STORM_LOG_THROW(values.size() == variables.size(), storm::exceptions::InvalidArgumentException, "Expected " << variables.size() << " values but got " << values.size() << ".");
+        auto it = index.find(values);
+        if (it == index.end()) {
+            return boost::none;
+        }
+        return it->second;
+    }
+
+    std::vector<int64_t> getStates(int64_t const* values, uint64_t nrRows) const {
+        std::vector<int64_t> result(nrRows);
+        std::vector<int64_t> key(variables.size());
+        for (uint64_t row = 0; row < nrRows; ++row) {
+            std::copy(values + row * variables.size(), values + (row + 1) * variables.size(), key.begin());
+            auto it = index.find(key);
+            result[row] = it == index.end() ? -1 : static_cast<int64_t>(it->second);
+        }
+        return result;
+    }
+
+    std::vector<storm::expressions::Variable> const& getVariables() const {
+        return variables;
+    }
+
+    uint64_t size() const {
+        return index.size();
+    }
+
+private:
+    std::vector<storm::expressions::Variable> variables;
+    std::unordered_map<std::vector<int64_t>, uint64_t, boost::hash<std::vector<int64_t>>> index;
+};
+
 
 // Define python bindings
 void define_statevaluation(py::module& m) {
@@ -27,7 +187,58 @@ void define_statevaluation(py::module& m) {
         .def("get_rational_value", &storm::storage::sparse::StateValuations::getRationalValue, py::arg("state"), py::arg("variable"))
         .def("get_string", &storm::storage::sparse::StateValuations::toString, py::arg("state"), py::arg("pretty")=true, py::arg("selected_variables")=boost::none)
         .def("get_json", &toJson, py::arg("state"), py::arg("selected_variables")=boost::none)
-        .def("get_nr_of_states", &storm::storage::sparse::StateValuations::getNumberOfStates);
+        .def("get_nr_of_states", &storm::storage::sparse::StateValuations::getNumberOfStates)
+        .def_property_readonly("variables", &getVariables, "Variables of the valuations")
+        .def("to_numpy", &toNumpy, py::arg("variables")=boost::none, R"doc(
+            Export the valuations of all states column-wise.
+            Each variable is mapped by name to an array holding its value for every state:
+            bool for Boolean variables, int64 for integer variables and float64 for rational variables.
+            The result can directly be passed to pandas.DataFrame or pyarrow.table.
+
+            :param variables: Variables to export. All variables if None.
+            :return: Dictionary from variable name to NumPy array.
+            )doc")
+        .def_static("from_numpy", &fromNumpy, py::arg("variables"), py::arg("columns"), R"doc(
+            Build valuations for all states from one column per variable, as returned by to_numpy.
+
+            :param variables: Variables in the order of the valuation.
+            :param columns: Dictionary from variable name to an array holding the value of the variable for every state.
+            :return: State valuations.
+            )doc")
+        .def("build_index", [](storm::storage::sparse::StateValuations const& valuations, boost::optional<std::vector<storm::expressions::Variable>> const& variables) {
+            return StateValuationIndex(valuations, selectVariables(valuations, variables));
+        }, py::arg("variables")=boost::none, R"doc(
+            Build a reverse index from valuations to state ids.
+
+            :param variables: Boolean or integer variables forming the key. All variables if None.
+            :return: Index to look up states.
+            )doc")
+    ;
+
+    py::class_<StateValuationIndex>(m, "StateValuationIndex", "Reverse index from valuations to state ids")
+        .def_property_readonly("variables", &StateValuationIndex::getVariables, "Variables forming the key, in order")
+        .def("__len__", &StateValuationIndex::size)
+        .def("get_state", &StateValuationIndex::getState, py::arg("values"), R"doc(
+            Get the state with the given values.
+            If several states share these values, the smallest state id is returned.
+
+            :param values: Values of the variables in the order of the index (Booleans as 0 or 1).
+            :return: State id or None if no state has these values.
+            )doc")
+        .def("get_states", [](StateValuationIndex const& index, py::array_t<int64_t, py::array::c_style | py::array::forcecast> const& values) {
+            STORM_LOG_THROW(values.ndim() == 2 && static_cast<uint64_t>(values.shape(1)) == index.getVariables().size(), storm::exceptions::InvalidArgumentException, "Expected an array of shape (n, " << index.getVariables().size() << ").");
+            std::vector<int64_t> states;
+            {
+                py::gil_scoped_release release;
+                states = index.getStates(values.data(), values.shape(0));
+            }
+            return py::array_t<int64_t>(states.size(), states.data());
+        }, py::arg("values"), R"doc(
+            Get the states for many valuations at once.
+
+            :param values: Array of shape (n, nr_variables) with one valuation per row (Booleans as 0 or 1).
+            :return: Array of n state ids, with -1 for valuations without a state.
+            )doc")
     ;
 
 
@@ -1,7 +1,9 @@
 import stormpy
 from helpers.helper import get_example_path
+from configurations import numpy_avail
 
 import math
+import pytest
 
 
 class TestBisimulation:
@@ -30,6 +32,103 @@ class TestBisimulation:
         assert initial_state_bisim == 34
         assert math.isclose(result.at(initial_state), result_bisim.at(initial_state_bisim), rel_tol=1e-4)
 
+    def test_signature_bisimulation(self):
+        program = stormpy.parse_prism_program(get_example_path("dtmc", "crowds5_5.pm"))
+        prop = "P=? [F \"observe0Greater1\"]"
+        properties = stormpy.parse_properties_for_prism_program(prop, program)
+        model = stormpy.build_model(program, properties)
+        result = stormpy.model_checking(model, properties[0])
+        model_bisim = stormpy.perform_sparse_bisimulation(model, properties, stormpy.BisimulationType.STRONG, nr_threads=2)
+        assert model_bisim.nr_states == 64
+        assert model_bisim.nr_transitions == 104
+        assert model_bisim.model_type == stormpy.ModelType.DTMC
+        assert len(model_bisim.initial_states) == 1
+        result_bisim = stormpy.model_checking(model_bisim, properties[0])
+        assert math.isclose(result.at(model.initial_states[0]), result_bisim.at(model_bisim.initial_states[0]), rel_tol=1e-4)
+
+    @numpy_avail
+    def test_signature_bisimulation_result(self):
+        program = stormpy.parse_prism_program(get_example_path("dtmc", "crowds5_5.pm"))
+        prop = "P=? [F \"observe0Greater1\"]"
+        properties = stormpy.parse_properties_for_prism_program(prop, program)
+        model = stormpy.build_model(program, properties)
+        result = stormpy.perform_signature_bisimulation(model, properties, nr_threads=4)
+        assert result.quotient.nr_states == 64
+        assert len(result.state_to_block) == 7403
+        assert result.state_to_block.max() == 63
+        assert result.state_to_block[model.initial_states[0]] == result.quotient.initial_states[0]
+        assert len(result.rounds) > 1
+        assert result.rounds[-1].blocks == 64
+        assert result.rounds[-2].blocks == 64
+        sequential = stormpy.perform_signature_bisimulation(model, properties, nr_threads=1)
+        assert (sequential.state_to_block == result.state_to_block).all()
+
+    @numpy_avail
+    def test_incremental_signature_bisimulation(self):
+        program = stormpy.parse_prism_program(get_example_path("pdtmc", "brp16_2.pm"))
+        prop = "P=? [F s=5]"
+        manager = program.expression_manager
+        previous = None
+        for pL, pK in [(0.8, 0.9), (0.7, 0.95)]:
+            constants = {program.get_constant("pL").expression_variable: manager.create_rational(stormpy.Rational(pL)),
+                         program.get_constant("pK").expression_variable: manager.create_rational(stormpy.Rational(pK)),
+                         program.get_constant("TOMsg").expression_variable: manager.create_rational(stormpy.Rational(1)),
+                         program.get_constant("TOAck").expression_variable: manager.create_rational(stormpy.Rational(1))}
+            instance = program.define_constants(constants)
+            properties = stormpy.parse_properties_for_prism_program(prop, instance)
+            model = stormpy.build_model(instance, properties)
+            assert model.nr_states == 613
+            result = stormpy.perform_signature_bisimulation(model, properties)
+            if previous is not None:
+                incremental = stormpy.perform_signature_bisimulation(model, properties, initial_partition=previous.state_to_block)
+                assert len(incremental.rounds) == 1
+                assert (incremental.state_to_block == result.state_to_block).all()
+                check = stormpy.model_checking(incremental.quotient, properties[0])
+                expected = stormpy.model_checking(model, properties[0])
+                assert math.isclose(check.at(incremental.quotient.initial_states[0]), expected.at(model.initial_states[0]), rel_tol=1e-6)
+            previous = result
+
+    @numpy_avail
+    def test_signature_bisimulation_invalid_partition(self):
+        import numpy as np
+        program = stormpy.parse_prism_program(get_example_path("dtmc", "die.pm"))
+        model = stormpy.build_model(program)
+        with pytest.raises(RuntimeError):
+            stormpy.perform_signature_bisimulation(model, [], initial_partition=np.zeros(model.nr_states + 1, dtype=np.uint64))
+
+    def test_signature_bisimulation_mdp(self):
+        program = stormpy.parse_prism_program(get_example_path("mdp", "two_dice.nm"))
+        formulas = "Pmin=? [F \"two\"]; Rmax=? [F \"done\"]"
+        properties = stormpy.parse_properties_for_prism_program(formulas, program)
+        model = stormpy.build_model(program, properties)
+        model_storm = stormpy.perform_bisimulation(model, properties, stormpy.BisimulationType.STRONG)
+        model_bisim = stormpy.perform_sparse_bisimulation(model, properties, stormpy.BisimulationType.STRONG, nr_threads=0)
+        assert model_bisim.model_type == stormpy.ModelType.MDP
+        assert model_bisim.nr_states == model_storm.nr_states
+        assert model_bisim.nr_states < model.nr_states
+        for prop in properties:
+            result = stormpy.model_checking(model, prop)
+            result_bisim = stormpy.model_checking(model_bisim, prop)
+            assert math.isclose(result.at(model.initial_states[0]), result_bisim.at(model_bisim.initial_states[0]), rel_tol=1e-6)
+
+    def test_signature_bisimulation_ctmc(self):
+        program = stormpy.parse_prism_program(get_example_path("ctmc", "polling2.sm"))
+        prop = "T=? [F \"target\"]"
+        properties = stormpy.parse_properties_for_prism_program(prop, program)
+        model = stormpy.build_model(program, properties)
+        model_bisim = stormpy.perform_sparse_bisimulation(model, properties, stormpy.BisimulationType.STRONG, nr_threads=2)
+        assert model_bisim.model_type == stormpy.ModelType.CTMC
+        assert model_bisim.nr_states < model.nr_states
+        result = stormpy.model_checking(model, properties[0])
+        result_bisim = stormpy.model_checking(model_bisim, properties[0])
+        assert math.isclose(result.at(model.initial_states[0]), result_bisim.at(model_bisim.initial_states[0]), rel_tol=1e-6)
+
+    def test_signature_bisimulation_weak(self):
+        program = stormpy.parse_prism_program(get_example_path("dtmc", "die.pm"))
+        model = stormpy.build_model(program)
+        with pytest.raises(stormpy.StormError):
+            stormpy.perform_sparse_bisimulation(model, [], stormpy.BisimulationType.WEAK, nr_threads=2)
+
     def test_symbolic_bisimulation(self):
         program = stormpy.parse_prism_program(get_example_path("dtmc", "crowds5_5.pm"))
         prop = "P=? [F \"observe0Greater1\"]"
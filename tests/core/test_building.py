@@ -1,6 +1,7 @@
 import stormpy
 import stormpy.examples
 import stormpy.examples.files
+from helpers.helper import get_example_path
 
 class TestBuilding:
     def test_explicit_builder(self):
@@ -34,3 +35,112 @@ class TestBuilding:
         assert model.state_valuations.get_integer_value(id, s_var) == 7
         assert model.state_valuations.get_integer_value(id, d_var) == 3
 
+
+    def _assert_same_model(self, model, expected):
+        assert model.model_type == expected.model_type
+        assert model.nr_states == expected.nr_states
+        assert model.nr_transitions == expected.nr_transitions
+        assert model.nr_choices == expected.nr_choices
+        assert list(model.initial_states) == list(expected.initial_states)
+        assert model.labeling.get_labels() == expected.labeling.get_labels()
+        for label in expected.labeling.get_labels():
+            assert model.labeling.get_states(label) == expected.labeling.get_states(label)
+        for state in range(expected.nr_states):
+            for row in range(expected.transition_matrix.get_row_group_start(state), expected.transition_matrix.get_row_group_end(state)):
+                entries = [(entry.column, entry.value()) for entry in model.transition_matrix.get_row(row)]
+                expected_entries = [(entry.column, entry.value()) for entry in expected.transition_matrix.get_row(row)]
+                assert entries == expected_entries
+        assert model.reward_models.keys() == expected.reward_models.keys()
+
+    def test_parallel_builder_dtmc(self):
+        program = stormpy.parse_prism_program(stormpy.examples.files.prism_dtmc_brp)
+        options = stormpy.BuilderOptions()
+        expected = stormpy.build_sparse_model_with_options(program, options)
+        options.set_exploration_threads(4)
+        assert options.exploration_threads == 4
+        model = stormpy.build_sparse_model_with_options(program, options)
+        self._assert_same_model(model, expected)
+
+    def test_parallel_builder_mdp(self):
+        program = stormpy.parse_prism_program(stormpy.examples.files.prism_mdp_coin_2_2)
+        options = stormpy.BuilderOptions()
+        options.set_build_choice_labels()
+        options.set_build_state_valuations()
+        expected = stormpy.build_sparse_model_with_options(program, options)
+        options.set_exploration_threads(3)
+        model = stormpy.build_sparse_model_with_options(program, options)
+        self._assert_same_model(model, expected)
+        for choice in range(expected.nr_choices):
+            assert model.choice_labeling.get_labels_of_choice(choice) == expected.choice_labeling.get_labels_of_choice(choice)
+        for state in range(expected.nr_states):
+            assert model.state_valuations.get_string(state) == expected.state_valuations.get_string(state)
+
+    def test_parallel_builder_pomdp_fallback(self):
+        # Observations are not built by the parallel exploration, hence the sequential builder is used
+        program = stormpy.parse_prism_program(get_example_path("pomdp", "maze_2.prism"))
+        options = stormpy.BuilderOptions()
+        expected = stormpy.build_sparse_model_with_options(program, options)
+        options.set_exploration_threads(4)
+        model = stormpy.build_sparse_model_with_options(program, options)
+        assert model.model_type == stormpy.ModelType.POMDP
+        self._assert_same_model(model, expected)
+        assert model.nr_observations == expected.nr_observations
+        assert list(model.observations) == list(expected.observations)
+
+    def test_builder_options_type(self):
+        program = stormpy.parse_prism_program(stormpy.examples.files.prism_dtmc_die)
+        options = stormpy.BuilderOptions()
+        options.set_exploration_threads(2)
+        # Setters return the options themselves, including the number of threads
+        chained = options.set_build_state_valuations().set_build_choice_labels()
+        assert isinstance(chained, stormpy.BuilderOptions)
+        assert chained.exploration_threads == 2
+        model = stormpy.build_sparse_model_with_options(program, chained)
+        assert model.has_state_valuations()
+        # The same options are accepted by the other builders
+        builder = stormpy.make_sparse_model_builder(program, options)
+        assert builder.build().nr_states == model.nr_states
+        exact_model = stormpy.build_sparse_exact_model_with_options(program, options)
+        assert exact_model.nr_states == model.nr_states
+
+    def test_parallel_builder_jani(self):
+        jani_model, _ = stormpy.parse_jani_model(stormpy.examples.files.jani_dtmc_die)
+        options = stormpy.BuilderOptions()
+        expected = stormpy.build_sparse_model_with_options(jani_model, options)
+        options.set_exploration_threads(0)
+        model = stormpy.build_sparse_model_with_options(jani_model, options)
+        self._assert_same_model(model, expected)
+
+    def test_expression_action_mask(self):
+        program = stormpy.parse_prism_program(get_example_path("mdp", "die_selection.nm"))
+        options = stormpy.BuilderOptions()
+        s = program.get_module("die").get_integer_variable("s").expression_variable
+        manager = program.expression_manager
+        guards = {program.get_action_index("ufair1"): stormpy.Expression.Eq(s.get_expression(), manager.create_integer(0)),
+                  program.get_action_index("ufair2"): manager.create_boolean(False)}
+        mask = stormpy.ExpressionActionMaskDouble(guards)
+        model = stormpy.build_sparse_model_with_options(program, options, mask)
+        assert model.nr_states == 13
+        assert model.nr_choices == 14
+
+        def python_mask(valuation, action_index):
+            name = program.get_action_name(action_index)
+            return name not in ["ufair1", "ufair2"] or (name == "ufair1" and valuation.get_integer_value(s) == 0)
+
+        expected = stormpy.make_sparse_model_builder(program, options, stormpy.StateValuationFunctionActionMaskDouble(python_mask)).build()
+        self._assert_same_model(model, expected)
+        options.set_exploration_threads(2)
+        model = stormpy.build_sparse_model_with_options(program, options, mask)
+        self._assert_same_model(model, expected)
+
+    def test_valuation_table_action_mask(self):
+        program = stormpy.parse_prism_program(get_example_path("mdp", "die_selection.nm"))
+        options = stormpy.BuilderOptions()
+        s = program.get_module("die").get_integer_variable("s").expression_variable
+        fair = program.get_action_index("fair")
+        table = {(state,): {fair} for state in range(7)}
+        mask = stormpy.ValuationTableActionMaskDouble([s], table)
+        options.set_exploration_threads(2)
+        model = stormpy.build_sparse_model_with_options(program, options, mask)
+        assert model.nr_states == 13
+        assert model.nr_choices == 13
@@ -0,0 +1,88 @@
+import stormpy
+from helpers.helper import get_example_path
+from configurations import numpy_avail
+
+import pytest
+
+
+class TestCompiledExpression:
+    def _parse(self, manager, string):
+        variables = {v.name: v.get_expression() for v in manager.get_variables()}
+        parser = stormpy.ExpressionParser(manager)
+        parser.set_identifier_mapping(variables)
+        return parser.parse(string)
+
+    def test_evaluate(self):
+        manager = stormpy.ExpressionManager()
+        x = manager.create_integer_variable("x")
+        y = manager.create_integer_variable("y")
+        b = manager.create_boolean_variable("b")
+        expression = self._parse(manager, "b & (x + 2 * y > 7)")
+        compiled = stormpy.CompiledExpression(expression, [x, y, b])
+        assert compiled.evaluate([1, 4, 1]) is True
+        assert compiled.evaluate([1, 3, 1]) is False
+        assert compiled.evaluate([5, 4, 0]) is False
+
+        numerical = self._parse(manager, "b ? max(x, y) : x - y")
+        compiled = stormpy.CompiledExpression(numerical)
+        assert [v.name for v in compiled.variables] == ["b", "x", "y"]
+        assert compiled.evaluate([1, 3, 4]) == 4
+        assert compiled.evaluate([0, 3, 4]) == -1
+
+    def test_constant_folding(self):
+        manager = stormpy.ExpressionManager()
+        x = manager.create_integer_variable("x")
+        expression = self._parse(manager, "x + (2 * 3 + 1)")
+        compiled = stormpy.CompiledExpression(expression, [x])
+        assert compiled.nr_instructions == 1
+        assert not compiled.is_constant
+        assert compiled.evaluate([3]) == 10
+        constant = stormpy.CompiledExpression(self._parse(manager, "2 * 3 > 5"), [])
+        assert constant.is_constant
+        assert constant.nr_instructions == 0
+        assert constant.evaluate([]) is True
+
+    def test_missing_variable(self):
+        manager = stormpy.ExpressionManager()
+        x = manager.create_integer_variable("x")
+        manager.create_integer_variable("y")
+        with pytest.raises(RuntimeError):
+            stormpy.CompiledExpression(self._parse(manager, "x + y"), [x])
+
+    def test_agrees_with_storm(self):
+        program = stormpy.parse_prism_program(get_example_path("dtmc", "die.pm"))
+        options = stormpy.BuilderOptions()
+        options.set_build_state_valuations()
+        model = stormpy.build_sparse_model_with_options(program, options)
+        s = program.get_module("die").get_integer_variable("s").expression_variable
+        d = program.get_module("die").get_integer_variable("d").expression_variable
+        expression = self._parse(program.expression_manager, "s * 7 + d > 20 | d = 3")
+        compiled = stormpy.CompiledExpression(expression, [s, d])
+        for state in range(model.nr_states):
+            valuation = model.state_valuations
+            values = [valuation.get_integer_value(state, s), valuation.get_integer_value(state, d)]
+            substituted = expression.substitute({s: program.expression_manager.create_integer(values[0]), d: program.expression_manager.create_integer(values[1])})
+            assert compiled.evaluate(values) == substituted.evaluate_as_bool()
+
+    @numpy_avail
+    def test_evaluate_batch(self):
+        import numpy as np
+        manager = stormpy.ExpressionManager()
+        x = manager.create_integer_variable("x")
+        y = manager.create_rational_variable("y")
+        compiled = stormpy.CompiledExpression(self._parse(manager, "x * 0.5 + y"), [x, y])
+        values = np.array([[1, 0.5], [4, 0.25], [-3, 0.0]])
+        result = compiled.evaluate_batch(values)
+        assert result.dtype == np.float64
+        assert np.allclose(result, [1.0, 2.25, -1.5])
+
+        integer = stormpy.CompiledExpression(self._parse(manager, "x * x"), [x])
+        xs = np.arange(1000)
+        result = integer.evaluate_batch({"x": xs}, nr_threads=4)
+        assert result.dtype == np.int64
+        assert (result == xs * xs).all()
+
+        boolean = stormpy.CompiledExpression(self._parse(manager, "x >= 500"), [x])
+        result = boolean.evaluate_batch({"x": xs})
+        assert result.dtype == np.bool_
+        assert result.sum() == 500
@@ -0,0 +1,58 @@
+import os
+
+import stormpy
+from helpers.helper import get_example_path
+
+import pytest
+
+
+class TestJaniIO:
+    def _instantiate(self, jani_model):
+        description = stormpy.SymbolicModelDescription(jani_model)
+        constant_definitions = description.parse_constant_definitions("N=16, MAX=2")
+        return description.instantiate_constants(constant_definitions).as_jani_model()
+
+    def test_parse_streaming(self):
+        jani_model, properties = stormpy.parse_jani_model_streaming(get_example_path("dtmc", "die.jani"))
+        assert jani_model.name == "die.jani"
+        assert jani_model.model_type == stormpy.JaniModelType.DTMC
+        assert len(properties) == 2
+        model = stormpy.build_model(jani_model, properties)
+        assert model.nr_states == 13
+        assert model.nr_transitions == 20
+
+        reference, _ = stormpy.parse_jani_model(get_example_path("dtmc", "brp.jani"))
+        streamed, _ = stormpy.parse_jani_model_streaming(get_example_path("dtmc", "brp.jani"))
+        assert stormpy.collect_information(streamed).nr_edges == stormpy.collect_information(reference).nr_edges
+        assert stormpy.build_model(self._instantiate(streamed)).nr_states == stormpy.build_model(self._instantiate(reference)).nr_states
+
+    def test_parse_comments(self):
+        with open(get_example_path("dtmc", "die.jani"), 'r') as file:
+            json_string = file.read()
+        # Comments on the model are dropped, including structured ones
+        json_string = json_string.replace('"jani-version"', '"comment": {"nested": ["a", 1.5, {"comment": null}]},\n  "jani-version"', 1)
+        jani_model, properties = stormpy.parse_jani_model_from_string_streaming(json_string)
+        assert jani_model.name == "die.jani"
+        assert len(properties) == 2
+        assert stormpy.build_model(jani_model).nr_states == 13
+
+    def test_parse_invalid(self):
+        with pytest.raises(RuntimeError):
+            stormpy.parse_jani_model_from_string_streaming('{"jani-version": 1,')
+
+    def test_export_streaming(self, tmpdir):
+        jani_model, properties = stormpy.parse_jani_model(get_example_path("dtmc", "die.jani"))
+        export_file = os.path.join(str(tmpdir), "die.jani")
+        stormpy.export_jani_model_streaming(jani_model, export_file, properties)
+        exported_model, exported_properties = stormpy.parse_jani_model(export_file)
+        assert exported_model.name == "die.jani"
+        assert len(exported_properties) == 2
+        model = stormpy.build_model(exported_model)
+        assert model.nr_states == 13
+        assert model.nr_transitions == 20
+
+        brp = self._instantiate(stormpy.parse_jani_model(get_example_path("dtmc", "brp.jani"))[0])
+        json_string = stormpy.jani_model_to_string_streaming(brp, comment_expressions=False)
+        streamed, _ = stormpy.parse_jani_model_from_string(json_string)
+        assert stormpy.collect_information(streamed).nr_edges == 31
+        assert stormpy.build_model(streamed).nr_states == 677
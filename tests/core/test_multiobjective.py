@@ -3,6 +3,8 @@ from helpers.helper import get_example_path
 
 from configurations import plotting, numpy_avail
 
+import pytest
+
 class TestModelChecking:
     def naive_api_double_no_plotting_test(self):
         program = stormpy.parse_prism_program(get_example_path("mdp", "multiobjective1.nm"))
@@ -37,3 +39,51 @@ class TestModelChecking:
         ax.set_xlabel(formula.subformulas[0])
         ax.set_ylabel(formula.subformulas[1])
         #plt.show()
+
+
+class TestParetoExploration:
+    expected_vertices = [[124 / 125, 248 / 2125], [97 / 100, 5456 / 425], [91 / 100, 248 / 17]]
+
+    def _build(self):
+        program = stormpy.parse_prism_program(get_example_path("mdp", "multiobjective1.nm"))
+        properties = stormpy.parse_properties_for_prism_program("multi(Pmax=? [ F<=3 s=2 ],R{\"rew\"}max=? [ F s=2 ])", program)
+        return stormpy.build_model(program, properties), properties
+
+    def _close_to_expected(self, point):
+        return min([max([abs(pi - vi) for pi, vi in zip(point, v)]) for v in self.expected_vertices]) <= 1e-4
+
+    @numpy_avail
+    def test_explore(self):
+        model, properties = self._build()
+        result = stormpy.explore_pareto_curve(model, properties[0], nr_threads=2)
+        assert result.converged
+        assert result.gap <= 1e-4
+        assert result.nr_queries >= 3
+        assert result.points.shape == (result.nr_queries, 2)
+        assert result.weight_vectors.shape == (result.nr_queries, 2)
+        assert all(abs(sum(w) - 1) < 1e-9 for w in result.weight_vectors)
+        for p in result.points:
+            assert self._close_to_expected(p)
+        vertices = result.under_approximation.vertices_array
+        assert vertices.shape[0] >= 3
+        for p in vertices:
+            assert self._close_to_expected(p)
+        for p in result.over_approximation.vertices_array:
+            assert self._close_to_expected(p)
+
+    @numpy_avail
+    def test_budget(self):
+        model, properties = self._build()
+        result = stormpy.explore_pareto_curve(model, properties[0], nr_threads=1, max_queries=2)
+        assert result.nr_queries == 2
+        assert result.rounds == 1
+        assert not result.converged
+
+    def test_invalid_property(self):
+        model, _ = self._build()
+        properties = stormpy.parse_properties("Pmax=? [ F<=3 s=2 ]", stormpy.parse_prism_program(get_example_path("mdp", "multiobjective1.nm")))
+        with pytest.raises(stormpy.StormError):
+            stormpy.explore_pareto_curve(model, properties[0])
+        quantitative = stormpy.parse_properties_for_prism_program("multi(Pmax=? [ F<=3 s=2 ],R{\"rew\"}>=1 [ F s=2 ])", stormpy.parse_prism_program(get_example_path("mdp", "multiobjective1.nm")))
+        with pytest.raises(RuntimeError):
+            stormpy.explore_pareto_curve(model, quantitative[0])
@@ -0,0 +1,89 @@
+import pytest
+
+import stormpy
+import stormpy.examples
+import stormpy.examples.files
+
+
+class TestOnTheFly:
+    def _check(self, path, formula, options=None):
+        program = stormpy.parse_prism_program(path)
+        properties = stormpy.parse_properties_for_prism_program(formula, program)
+        return program, stormpy.check_on_the_fly(program, properties[0], options)
+
+    def test_exists_path(self):
+        program, result = self._check(stormpy.examples.files.prism_dtmc_die, "P>0 [F \"two\"]")
+        assert result.decided
+        assert result.result
+        assert not result.complete
+        assert result.explored_states < 13
+        s = program.modules[0].get_integer_variable("s").expression_variable
+        d = program.modules[0].get_integer_variable("d").expression_variable
+        assert len(result.trace) == 4
+        assert result.trace[0].get_integer_value(s) == 0
+        assert result.trace[-1].get_integer_value(s) == 7
+        assert result.trace[-1].get_integer_value(d) == 2
+
+    def test_no_path(self):
+        _, result = self._check(stormpy.examples.files.prism_dtmc_die, "P<=0 [F s=7 & d=0]")
+        assert result.decided
+        assert result.result
+        assert result.complete
+        assert result.exact
+        assert result.explored_states == 13
+        assert len(result.trace) == 0
+
+    def test_almost_sure(self):
+        _, result = self._check(stormpy.examples.files.prism_dtmc_die, "P>=1 [F s=7]")
+        assert result.decided
+        assert result.result
+        assert result.complete
+
+        options = stormpy.OnTheFlyOptions()
+        options.graph_check_interval = 1
+        _, result = self._check(stormpy.examples.files.prism_dtmc_die, "P>=1 [F \"two\"]", options)
+        assert result.decided
+        assert not result.result
+        assert not result.complete
+
+    def test_globally(self):
+        _, result = self._check(stormpy.examples.files.prism_dtmc_die, "P>=1 [G d<=6]")
+        assert result.decided
+        assert result.result
+        _, result = self._check(stormpy.examples.files.prism_dtmc_die, "P>=1 [G s<7]")
+        assert result.decided
+        assert not result.result
+
+    def test_globally_positive(self):
+        # Not rolling a two has probability 5/6
+        _, result = self._check(stormpy.examples.files.prism_dtmc_die, "P>0 [G !\"two\"]")
+        assert result.decided
+        assert result.result
+        # The die almost surely terminates
+        _, result = self._check(stormpy.examples.files.prism_dtmc_die, "P>0 [G s<7]")
+        assert result.decided
+        assert not result.result
+
+    def test_bounded_memory(self):
+        options = stormpy.OnTheFlyOptions()
+        options.hash_compaction = True
+        _, result = self._check(stormpy.examples.files.prism_dtmc_die, "P>0 [F \"two\"]", options)
+        assert result.decided
+        assert result.result
+        assert result.exact
+        _, result = self._check(stormpy.examples.files.prism_dtmc_die, "P<=0 [F s=7 & d=0]", options)
+        assert result.decided
+        assert not result.exact
+
+        options = stormpy.OnTheFlyOptions()
+        options.max_states = 2
+        _, result = self._check(stormpy.examples.files.prism_dtmc_die, "P>=1 [F s=7]", options)
+        assert not result.decided
+        assert result.explored_states == 2
+
+    def test_mdp(self):
+        _, result = self._check(stormpy.examples.files.prism_mdp_coin_2_2, "Pmax>0 [F \"finished\"]")
+        assert result.decided
+        assert result.result
+        with pytest.raises(RuntimeError):
+            self._check(stormpy.examples.files.prism_mdp_coin_2_2, "P>=1 [F \"finished\"]")
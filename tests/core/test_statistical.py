@@ -0,0 +1,123 @@
+import math
+
+import pytest
+
+import stormpy
+import stormpy.examples
+import stormpy.examples.files
+
+
+class TestStatisticalModelChecking:
+    def _check(self, path, formula, options):
+        program = stormpy.parse_prism_program(path)
+        properties = stormpy.parse_properties_for_prism_program(formula, program)
+        return stormpy.check_statistically(program, properties[0], options)
+
+    def test_chernoff(self):
+        options = stormpy.StatisticalModelCheckingOptions()
+        options.epsilon = 0.02
+        options.delta = 0.01
+        options.seed = 42
+        result = self._check(stormpy.examples.files.prism_dtmc_die, "P=? [F \"two\"]", options)
+        assert result.converged
+        assert result.samples == math.ceil(math.log(2 / 0.01) / (2 * 0.02 ** 2))
+        assert result.lower_bound <= result.estimate <= result.upper_bound
+        assert abs(result.estimate - 1 / 6) < 0.02
+        assert result.decision is None
+
+    def test_reproducible(self):
+        options = stormpy.StatisticalModelCheckingOptions()
+        options.stopping_rule = stormpy.SmcStoppingRule.FIXED
+        options.samples = 5000
+        options.seed = 7
+        options.batch_size = 100
+        options.nr_threads = 1
+        first = self._check(stormpy.examples.files.prism_dtmc_die, "P=? [F \"two\"]", options)
+        options.nr_threads = 4
+        second = self._check(stormpy.examples.files.prism_dtmc_die, "P=? [F \"two\"]", options)
+        assert first.samples == second.samples == 5000
+        assert first.estimate == second.estimate
+
+    def test_sequential_intervals(self):
+        for rule in [stormpy.SmcStoppingRule.WALD, stormpy.SmcStoppingRule.CLOPPER_PEARSON]:
+            options = stormpy.StatisticalModelCheckingOptions()
+            options.stopping_rule = rule
+            options.epsilon = 0.02
+            options.seed = 3
+            result = self._check(stormpy.examples.files.prism_dtmc_die, "P=? [F s=7 & d<=3]", options)
+            assert result.converged
+            assert result.upper_bound - result.lower_bound <= 0.04 + 1e-9
+            assert abs(result.estimate - 0.5) < 0.03
+
+    def test_sprt(self):
+        options = stormpy.StatisticalModelCheckingOptions()
+        options.stopping_rule = stormpy.SmcStoppingRule.SPRT
+        options.seed = 1
+        result = self._check(stormpy.examples.files.prism_dtmc_die, "P>=0.1 [F \"two\"]", options)
+        assert result.converged
+        assert result.decision
+        result = self._check(stormpy.examples.files.prism_dtmc_die, "P>=0.3 [F \"two\"]", options)
+        assert result.converged
+        assert not result.decision
+        with pytest.raises(RuntimeError):
+            self._check(stormpy.examples.files.prism_dtmc_die, "P=? [F \"two\"]", options)
+
+    def test_bounded_and_rewards(self):
+        options = stormpy.StatisticalModelCheckingOptions()
+        options.stopping_rule = stormpy.SmcStoppingRule.WALD
+        options.epsilon = 0.05
+        options.seed = 5
+        # Two coin flips are not enough to reach s=7
+        result = self._check(stormpy.examples.files.prism_dtmc_die, "P=? [F<=2 s=7]", options)
+        assert result.estimate == 0
+        # The expected number of coin flips is 11/3
+        result = self._check(stormpy.examples.files.prism_dtmc_die, "R=? [F s=7]", options)
+        assert result.converged
+        assert abs(result.estimate - 11 / 3) < 0.1
+        result = self._check(stormpy.examples.files.prism_dtmc_die, "R=? [C<=2]", options)
+        assert result.estimate == 2
+
+    def test_scheduler(self):
+        options = stormpy.StatisticalModelCheckingOptions()
+        options.stopping_rule = stormpy.SmcStoppingRule.FIXED
+        options.samples = 1000
+        options.seed = 11
+        options.scheduler = lambda valuation, nr_choices: 0
+        result = self._check(stormpy.examples.files.prism_mdp_coin_2_2, "P=? [F \"finished\"]", options)
+        assert result.samples == 1000
+        assert 0 <= result.estimate <= 1
+
+    def test_unbounded_globally(self):
+        # The die loops forever in its final states, hence no path of G ends in a deadlock
+        options = stormpy.StatisticalModelCheckingOptions()
+        options.epsilon = 0.02
+        options.seed = 13
+        options.max_steps = 100
+        result = self._check(stormpy.examples.files.prism_dtmc_die, "P=? [G !\"two\"]", options)
+        assert result.converged
+        assert result.undecided == 0
+        assert abs(result.estimate - 5 / 6) < 0.02
+
+    def test_undecided_paths(self):
+        options = stormpy.StatisticalModelCheckingOptions()
+        options.stopping_rule = stormpy.SmcStoppingRule.FIXED
+        options.samples = 2000
+        options.seed = 17
+        # Paths looping between the coin flips do not reach s=7 within three steps
+        options.max_steps = 3
+        result = self._check(stormpy.examples.files.prism_dtmc_die, "P=? [F s=7]", options)
+        assert result.samples == 2000
+        assert result.undecided > 0
+        # Every decided path reaches s=7
+        assert result.estimate == 1
+
+    def test_interval_of_few_samples(self):
+        options = stormpy.StatisticalModelCheckingOptions()
+        options.stopping_rule = stormpy.SmcStoppingRule.FIXED
+        options.samples = 50
+        options.batch_size = 1000
+        options.seed = 19
+        result = self._check(stormpy.examples.files.prism_dtmc_die, "R=? [F s=7]", options)
+        assert result.samples == 50
+        assert math.isfinite(result.lower_bound) and math.isfinite(result.upper_bound)
+        assert result.lower_bound <= result.estimate <= result.upper_bound
@@ -0,0 +1,57 @@
+import stormpy
+from helpers.helper import get_example_path
+
+import math
+
+
+class TestConstantSweep:
+    def test_sweep_structure(self):
+        program = stormpy.parse_prism_program(get_example_path("dtmc", "brp.pm"))
+        properties = stormpy.parse_properties_for_prism_program("P=? [F \"target\"]", program)
+        valuations = ["N=16,MAX=2", {"N": 32, "MAX": 3}, "N=64,MAX=5"]
+        instances = stormpy.sweep_constants(program, properties, valuations, nr_threads=2)
+        assert len(instances) == 3
+        assert instances[1].constants == "N=32,MAX=3"
+        for valuation, instance in zip(["N=16,MAX=2", "N=32,MAX=3", "N=64,MAX=5"], instances):
+            description, instantiated = stormpy.preprocess_symbolic_input(program, properties, valuation)
+            model = stormpy.build_model(description, instantiated)
+            assert instance.nr_states == model.nr_states
+            assert instance.nr_transitions == model.nr_transitions
+            assert instance.model is None
+            result = stormpy.model_checking(model, instantiated[0])
+            assert math.isclose(instance.results[0], result.at(model.initial_states[0]), rel_tol=1e-6)
+            assert not instance.description.as_prism_program().has_undefined_constants
+
+    def test_sweep_parameters(self):
+        program = stormpy.parse_prism_program(get_example_path("pdtmc", "brp16_2.pm"))
+        properties = stormpy.parse_properties_for_prism_program("P=? [F s=5]; P>0.5 [F s=5]", program)
+        valuations = [{"pL": p, "pK": 0.9, "TOMsg": 1, "TOAck": 1} for p in [0.5, 0.7, 0.9]]
+        instances = stormpy.sweep_constants(program, properties, valuations, flatten=True, keep_models=True)
+        assert [instance.nr_states for instance in instances] == [613, 613, 613]
+        assert instances[0].description.as_prism_program().nr_modules == 1
+        assert instances[0].model.nr_states == 613
+        probabilities = [instance.results[0] for instance in instances]
+        assert probabilities == sorted(probabilities)
+        for instance in instances:
+            assert instance.results[1] == (1 if instance.results[0] > 0.5 else 0)
+
+    def test_sweep_without_building(self):
+        program = stormpy.parse_prism_program(get_example_path("dtmc", "brp.pm"))
+        instances = stormpy.sweep_constants(program, [], ["N=16,MAX=2"], build=False)
+        assert instances[0].nr_states == 0
+        assert instances[0].results == []
+
+    def test_sweep_threads(self):
+        program = stormpy.parse_prism_program(get_example_path("pdtmc", "brp16_2.pm"))
+        properties = stormpy.parse_properties_for_prism_program("P=? [F s=5]", program)
+        valuations = [{"pL": pL, "pK": pK, "TOMsg": 1, "TOAck": 1} for pL in [0.6, 0.7, 0.8, 0.9] for pK in [0.8, 0.9, 0.99]]
+        sequential = stormpy.sweep_constants(program, properties, valuations, flatten=True, nr_threads=1)
+        parallel = stormpy.sweep_constants(program, properties, valuations, flatten=True, nr_threads=4)
+        assert len(parallel) == len(valuations)
+        for expected, instance in zip(sequential, parallel):
+            assert instance.constants == expected.constants
+            assert instance.description.as_prism_program().nr_modules == 1
+            assert not instance.description.as_prism_program().has_undefined_constants
+            assert instance.nr_states == expected.nr_states
+            assert instance.nr_transitions == expected.nr_transitions
+            assert math.isclose(instance.results[0], expected.results[0], rel_tol=1e-9)
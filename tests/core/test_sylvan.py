@@ -0,0 +1,55 @@
+import math
+
+import stormpy
+import stormpy.examples
+import stormpy.examples.files
+
+
+class TestSylvan:
+    def test_options(self):
+        previous = stormpy.get_sylvan_options()
+        assert previous.max_memory > 0
+        options = stormpy.get_sylvan_options()
+        options.max_memory = 2048
+        options.nr_threads = 2
+        try:
+            stormpy.set_sylvan_options(options)
+            current = stormpy.get_sylvan_options()
+            assert current.max_memory == 2048
+            assert current.nr_threads == 2
+        finally:
+            # The options are global, later tests must run with the previous settings
+            stormpy.set_sylvan_options(previous)
+        assert stormpy.get_sylvan_options().nr_threads == previous.nr_threads
+
+    def test_restore_all_cores(self):
+        previous = stormpy.get_sylvan_options()
+        options = stormpy.get_sylvan_options()
+        try:
+            options.nr_threads = 2
+            stormpy.set_sylvan_options(options)
+            options.nr_threads = 0
+            stormpy.set_sylvan_options(options)
+            assert stormpy.get_sylvan_options().nr_threads == 0
+        finally:
+            stormpy.set_sylvan_options(previous)
+
+    def test_statistics(self):
+        stormpy.reset_sylvan_statistics()
+        program = stormpy.parse_prism_program(stormpy.examples.files.prism_dtmc_die)
+        formulas = stormpy.parse_properties_for_prism_program("P=? [ F \"one\" ]", program)
+        model = stormpy.build_symbolic_model(program, formulas)
+        result = stormpy.check_model_dd(model, formulas[0])
+        result.filter(stormpy.create_filter_initial_states_symbolic(model))
+        assert math.isclose(result.min, 1 / 6, rel_tol=1e-6)
+
+        statistics = stormpy.get_sylvan_statistics()
+        assert statistics.operations["build"].calls == 1
+        assert statistics.operations["check_dd"].calls == 1
+        assert statistics.operations["build"].seconds >= 0
+        assert statistics.peak_nodes >= model.reachable_states.node_count
+        assert statistics.table_size >= statistics.used_nodes > 0
+        assert "build" in str(statistics)
+
+        stormpy.reset_sylvan_statistics()
+        assert len(stormpy.get_sylvan_statistics().operations) == 0
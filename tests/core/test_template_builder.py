@@ -0,0 +1,49 @@
+import stormpy
+from helpers.helper import get_example_path
+
+import math
+import pytest
+
+
+class TestTemplateModelBuilder:
+    def test_instantiate_dtmc(self):
+        program = stormpy.parse_prism_program(get_example_path("pdtmc", "brp16_2.pm"))
+        properties = stormpy.parse_properties_for_prism_program("P=? [F s=5]", program)
+        builder = stormpy.make_template_model_builder(program, properties)
+        assert sorted(builder.parameters) == ["pK", "pL"]
+        assert builder.template_model.nr_states == 613
+        assert builder.nr_functions < builder.template_model.nr_transitions
+        for pL, pK in [(0.8, 0.9), (0.5, 0.99)]:
+            model = builder.instantiate({"pL": pL, "pK": pK})
+            assert model.nr_states == 613
+            assert model.nr_transitions == 803
+            description, instantiated = stormpy.preprocess_symbolic_input(program, properties, "pL={},pK={},TOMsg=1,TOAck=1".format(pL, pK))
+            expected_model = stormpy.build_model(description, instantiated)
+            result = stormpy.model_checking(model, properties[0])
+            expected = stormpy.model_checking(expected_model, instantiated[0])
+            assert math.isclose(result.at(model.initial_states[0]), expected.at(expected_model.initial_states[0]), rel_tol=1e-6)
+
+    def test_missing_parameter(self):
+        program = stormpy.parse_prism_program(get_example_path("pdtmc", "brp16_2.pm"))
+        properties = stormpy.parse_properties_for_prism_program("P=? [F s=5]", program)
+        builder = stormpy.make_template_model_builder(program, properties)
+        with pytest.raises(RuntimeError):
+            builder.instantiate({"pL": 0.5})
+        with pytest.raises(RuntimeError):
+            builder.instantiate({"pL": 0.5, "pK": 0.5, "unknown": 1.0})
+
+    def test_irrelevant_constants(self):
+        program = stormpy.parse_prism_program(get_example_path("pdtmc", "brp16_2.pm"))
+        properties = stormpy.parse_properties_for_prism_program("P=? [F s=5]", program)
+        builder = stormpy.make_template_model_builder(program, properties)
+        assert "TOMsg" not in builder.parameters
+        model = builder.instantiate({"pL": 0.8, "pK": 0.9})
+        swept = builder.instantiate({"pL": 0.8, "pK": 0.9, "TOMsg": 0.5, "TOAck": 0.5})
+        result = stormpy.model_checking(model, properties[0])
+        swept_result = stormpy.model_checking(swept, properties[0])
+        assert math.isclose(result.at(model.initial_states[0]), swept_result.at(swept.initial_states[0]))
+
+    def test_not_graph_preserving(self):
+        program = stormpy.parse_prism_program(get_example_path("dtmc", "brp.pm"))
+        with pytest.raises(stormpy.StormError):
+            stormpy.make_template_model_builder(program)
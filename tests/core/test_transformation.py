@@ -144,6 +144,17 @@ class TestECElimination:
         assert ec_elimination_result.new_to_old_row_mapping[200] == 245
         assert ec_elimination_result.sink_rows.number_of_set_bits() == 36
 
+    def test_parallel_elimination_on_two_dice(self):
+        program = stormpy.parse_prism_program(get_example_path("mdp", "two_dice.nm"))
+        model = stormpy.build_model(program)
+        subsystem = stormpy.BitVector(model.nr_states, True)
+        possible_ec_rows = stormpy.BitVector(model.nr_choices, True)
+        result = stormpy.eliminate_ECs(model.transition_matrix, subsystem, possible_ec_rows, subsystem, True, nr_threads=4)
+        assert result.matrix.nr_rows == 218
+        assert result.matrix.nr_columns == model.nr_states
+        assert result.old_to_new_state_mapping[23] == 23
+        assert result.sink_rows.number_of_set_bits() == 36
+
 class TestSubsystemCreation:
     def test_for_ctmc(self):
         program = stormpy.parse_prism_program(get_example_path("ctmc", "polling2.sm"), True)
@@ -0,0 +1,40 @@
+import math
+
+import stormpy
+import stormpy.examples
+import stormpy.examples.files
+
+
+class TestVariableOrder:
+    def test_get_variable_order(self):
+        program = stormpy.parse_prism_program(stormpy.examples.files.prism_mdp_coin_2_2)
+        assert stormpy.get_variable_order(program) == ["counter", "pc1", "coin1", "pc2", "coin2"]
+
+    def test_compute_variable_order(self):
+        program = stormpy.parse_prism_program(stormpy.examples.files.prism_mdp_coin_2_2)
+        order = stormpy.compute_variable_order(program)
+        assert sorted(order) == sorted(stormpy.get_variable_order(program))
+        # Global variables always come first
+        assert order[0] == "counter"
+
+    def test_apply_variable_order(self):
+        program = stormpy.parse_prism_program(stormpy.examples.files.prism_mdp_coin_2_2)
+        reordered = stormpy.apply_variable_order(program, ["coin2", "pc2", "pc1"])
+        assert stormpy.get_variable_order(reordered) == ["counter", "coin2", "pc2", "pc1", "coin1"]
+        assert [m.name for m in reordered.modules] == ["process2", "process1"]
+        # The original program is not changed
+        assert stormpy.get_variable_order(program) == ["counter", "pc1", "coin1", "pc2", "coin2"]
+
+    def test_build_with_variable_order(self):
+        program = stormpy.parse_prism_program(stormpy.examples.files.prism_mdp_coin_2_2)
+        formulas = stormpy.parse_properties_for_prism_program("Pmin=? [ F \"finished\" & \"all_coins_equal_1\" ]", program)
+        expected = stormpy.build_symbolic_model(program, formulas)
+        expected_result = stormpy.check_model_dd(expected, formulas[0])
+        expected_result.filter(stormpy.create_filter_initial_states_symbolic(expected))
+        for order in ["static", ["coin2", "coin1", "pc2", "pc1"]]:
+            model = stormpy.build_symbolic_model(program, formulas, variable_order=order)
+            assert model.nr_states == expected.nr_states
+            assert model.nr_transitions == expected.nr_transitions
+            result = stormpy.check_model_dd(model, formulas[0])
+            result.filter(stormpy.create_filter_initial_states_symbolic(model))
+            assert math.isclose(result.min, expected_result.min, rel_tol=1e-6)
@@ -1,8 +1,10 @@
 import os
 
+import pytest
+
 import stormpy
 
-from configurations import gspn, xml
+from configurations import gspn, xml, numpy_avail
 
 
 @gspn
@@ -170,6 +172,40 @@ class TestGSPNBuilder:
         gspn.set_name(gspn_new_name)
         assert gspn.get_name() == gspn_new_name
 
+    @numpy_avail
+    def test_build_gspn_bulk(self):
+        import numpy as np
+        builder = stormpy.gspn.GSPNBuilder()
+        builder.set_name("gspn_bulk")
+
+        place_ids = builder.add_places(np.array([1, -1, 2]), np.array([1, 0, 0]), ["p_0", "p_1", "p_2"])
+        assert list(place_ids) == [0, 1, 2]
+        ti_ids = builder.add_immediate_transitions(np.array([1, 2]), np.array([0.5, 1.5]), ["ti_0", "ti_1"])
+        tt_ids = builder.add_timed_transitions(np.array([0]), np.array([0.4]), num_servers=np.array([-1]), names=["tt_0"])
+
+        builder.add_input_arcs(place_ids[[0, 1]], ti_ids, multiplicities=np.array([1, 2]))
+        builder.add_output_arcs(ti_ids, place_ids[[1, 2]])
+        builder.add_inhibition_arcs(place_ids[[2]], tt_ids)
+        gspn = builder.build_gspn()
+
+        assert gspn.is_valid()
+        assert gspn.get_number_of_places() == 3
+        assert gspn.get_number_of_immediate_transitions() == 2
+        assert gspn.get_number_of_timed_transitions() == 1
+        assert not gspn.get_place("p_1").has_restricted_capacity()
+        assert gspn.get_place("p_2").get_capacity() == 2
+        ti_1 = gspn.get_immediate_transition("ti_1")
+        assert ti_1.get_weight() == 1.5
+        assert ti_1.get_priority() == 2
+        assert ti_1.get_input_arc_multiplicity(gspn.get_place("p_1")) == 2
+        assert gspn.get_timed_transition("tt_0").has_infinite_server_semantics()
+
+    @numpy_avail
+    def test_build_gspn_bulk_size_mismatch(self):
+        builder = stormpy.gspn.GSPNBuilder()
+        with pytest.raises(ValueError):
+            builder.add_places([1, 1], [0])
+
     @xml
     def test_export_to_pnpro(self, tmpdir):
         builder = stormpy.gspn.GSPNBuilder()
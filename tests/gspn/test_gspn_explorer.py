@@ -0,0 +1,63 @@
+import math
+
+import stormpy
+
+from helpers.helper import get_example_path
+from configurations import gspn, xml
+
+
+def _build_simple_gspn():
+    builder = stormpy.gspn.GSPNBuilder()
+    builder.set_name("simple")
+    p_idle = builder.add_place(capacity=1, initial_tokens=1, name="idle")
+    p_decide = builder.add_place(capacity=1, initial_tokens=0, name="decide")
+    p_left = builder.add_place(capacity=1, initial_tokens=0, name="left")
+    p_right = builder.add_place(capacity=1, initial_tokens=0, name="right")
+    t_start = builder.add_timed_transition(0, 2.0, "start")
+    builder.add_input_arc(p_idle, t_start)
+    builder.add_output_arc(t_start, p_decide)
+    t_left = builder.add_immediate_transition(1, 1.0, "go_left")
+    builder.add_input_arc(p_decide, t_left)
+    builder.add_output_arc(t_left, p_left)
+    t_right = builder.add_immediate_transition(1, 3.0, "go_right")
+    builder.add_input_arc(p_decide, t_right)
+    builder.add_output_arc(t_right, p_right)
+    t_back = builder.add_timed_transition(0, 1.0, "back")
+    builder.add_input_arc(p_left, t_back)
+    builder.add_output_arc(t_back, p_idle)
+    return builder.build_gspn()
+
+
+@gspn
+class TestGSPNExplorer:
+    def test_eliminate_vanishing(self):
+        gspn = _build_simple_gspn()
+        properties = stormpy.gspn.parse_properties_for_gspn("P=? [F right=1]", gspn)
+        model = stormpy.gspn.build_model(gspn, properties)
+        assert model.model_type == stormpy.ModelType.CTMC
+        # The vanishing marking 'decide' is removed
+        assert model.nr_states == 3
+        assert "deadlock" in model.labeling.get_labels()
+        result = stormpy.model_checking(model, properties[0])
+        assert math.isclose(result.at(model.initial_states[0]), 1.0)
+
+    def test_keep_vanishing(self):
+        gspn = _build_simple_gspn()
+        properties = stormpy.gspn.parse_properties_for_gspn("Pmax=? [F<=1 left=1]", gspn)
+        options = stormpy.gspn.GSPNExplorationOptions()
+        options.eliminate_vanishing = False
+        options.nr_threads = 2
+        model = stormpy.gspn.build_model(gspn, properties, options)
+        assert model.model_type == stormpy.ModelType.MA
+        assert model.nr_states == 4
+        assert model.nr_transitions == 5
+
+    @xml
+    def test_philosophers(self):
+        gspn_parser = stormpy.gspn.GSPNParser()
+        gspn = gspn_parser.parse(get_example_path("gspn", "philosophers_4.pnpro"))
+        properties = stormpy.gspn.parse_properties_for_gspn("P=? [F<=10 eating1=1]", gspn)
+        model = stormpy.gspn.build_model(gspn, properties)
+        assert model.model_type == stormpy.ModelType.CTMC
+        result = stormpy.model_checking(model, properties[0])
+        assert math.isclose(result.at(model.initial_states[0]), 0.4372171069840004)
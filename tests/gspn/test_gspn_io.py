@@ -68,3 +68,42 @@ class TestGSPNJani:
         assert math.isclose(result.at(initial_state), 0.09123940783)
         result = stormpy.model_checking(model, properties[2])
         assert math.isclose(result.at(initial_state), 5.445544554455446)
+
+
+@gspn
+class TestGSPNStreamingParser:
+    def test_parse_pnpro(self):
+        parser = stormpy.gspn.GSPNStreamingParser()
+        gspn = parser.parse(get_example_path("gspn", "gspn_simple.pnpro"))
+        assert gspn.get_name() == "my_gspn"
+        assert gspn.get_number_of_places() == 2
+        assert gspn.get_number_of_timed_transitions() == 1
+        assert gspn.get_number_of_immediate_transitions() == 1
+        tt_1 = gspn.get_timed_transition("tt_1")
+        assert math.isclose(tt_1.get_rate(), 0.4)
+        assert tt_1.exists_input_arc(gspn.get_place("place_1"))
+        assert tt_1.exists_output_arc(gspn.get_place("place_2"))
+        it_1 = gspn.get_immediate_transition("it_1")
+        assert it_1.exists_inhibition_arc(gspn.get_place("place_1"))
+
+    def test_parse_pnml(self):
+        parser = stormpy.gspn.GSPNStreamingParser()
+        gspn = parser.parse(get_example_path("gspn", "gspn_simple.pnml"))
+        assert gspn.get_name() == "simple_gspn"
+        assert gspn.get_number_of_places() == 4
+        assert gspn.get_number_of_timed_transitions() == 2
+        assert gspn.get_number_of_immediate_transitions() == 3
+        place_1 = gspn.get_place("place_1")
+        assert place_1.get_number_of_initial_tokens() == 1
+        assert place_1.get_capacity() == 1
+        assert gspn.get_immediate_transition("it_1").exists_inhibition_arc(place_1)
+        assert gspn.get_timed_transition("tt_1").exists_input_arc(place_1)
+
+    def test_parse_constants(self):
+        parser = stormpy.gspn.GSPNStreamingParser()
+        gspn = parser.parse(get_example_path("gspn", "philosophers_4.pnpro"), "lambda=2")
+        assert gspn.get_name() == "Philosophers4"
+        assert gspn.get_number_of_timed_transitions() == 12
+        assert gspn.get_number_of_places() == 16
+        assert math.isclose(gspn.get_timed_transition("T0").get_rate(), 2)
+        assert math.isclose(gspn.get_timed_transition("T4").get_rate(), 1)
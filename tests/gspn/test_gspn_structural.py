@@ -0,0 +1,51 @@
+import math
+
+import stormpy
+
+from configurations import gspn
+
+
+def _build_two_cycles():
+    # Two independent cycles a1 -> a2 -> a1 and b1 -> b2 -> b1 with one token each
+    builder = stormpy.gspn.GSPNBuilder()
+    builder.set_name("cycles")
+    places = {}
+    for name, tokens in [("a1", 1), ("a2", 0), ("b1", 1), ("b2", 0)]:
+        places[name] = builder.add_place(initial_tokens=tokens, name=name)
+    for name, rate, source, target in [("t1", 1.0, "a1", "a2"), ("t2", 2.0, "a2", "a1"), ("t3", 3.0, "b1", "b2"), ("t4", 1.0, "b2", "b1")]:
+        transition = builder.add_timed_transition(0, rate, name)
+        builder.add_input_arc(places[source], transition)
+        builder.add_output_arc(transition, places[target])
+    return builder.build_gspn()
+
+
+@gspn
+class TestGSPNStructural:
+    def test_invariants(self):
+        gspn = _build_two_cycles()
+        p_invariants = stormpy.gspn.compute_p_invariants(gspn)
+        assert sorted(p_invariants) == [[0, 0, 1, 1], [1, 1, 0, 0]]
+        t_invariants = stormpy.gspn.compute_t_invariants(gspn)
+        assert len(t_invariants) == 2
+        assert {"t1": 1, "t2": 1} in t_invariants
+        assert {"t3": 1, "t4": 1} in t_invariants
+        assert stormpy.gspn.compute_place_bounds(gspn) == [1, 1, 1, 1]
+
+    def test_build_with_invariants(self):
+        gspn = _build_two_cycles()
+        options = stormpy.gspn.GSPNExplorationOptions()
+        options.use_invariants = True
+        model = stormpy.gspn.build_model(gspn, options=options)
+        assert model.nr_states == 4
+        assert model.nr_transitions == 8
+
+    def test_decomposition(self):
+        gspn = _build_two_cycles()
+        result = stormpy.gspn.analyze_steady_state_decomposed(gspn)
+        assert result.converged
+        assert len(result.components) == 2
+        assert result.component_states == [2, 2]
+        assert math.isclose(result.throughputs["t1"], 2 / 3)
+        assert math.isclose(result.throughputs["t3"], 3 / 4)
+        assert math.isclose(result.expected_tokens[0], 2 / 3)
+        assert math.isclose(result.expected_tokens[3], 3 / 4)
@@ -0,0 +1,81 @@
+import stormpy
+
+from configurations import pomdp, numpy_avail
+
+from helpers.helper import get_example_path
+
+import math
+import pytest
+
+
+def build_maze():
+    program = stormpy.parse_prism_program(get_example_path("pomdp", "maze_2.prism"))
+    formulas = stormpy.parse_properties_for_prism_program("Pmax=? [ !\"bad\" U \"goal\" ]; Pmin=? [ !\"bad\" U \"goal\" ]", program)
+    model = stormpy.build_model(program, formulas)
+    return stormpy.pomdp.make_canonic(model), formulas
+
+
+def initial_value(model, formula):
+    result = stormpy.model_checking(model, formula)
+    return result.at(model.initial_states[0])
+
+
+@pomdp
+class TestPomdpMemoryProduct:
+    def test_direct_unfolding(self):
+        model, formulas = build_maze()
+        memory = stormpy.pomdp.PomdpMemoryBuilder().build(stormpy.pomdp.PomdpMemoryPattern.selective_counter, 3)
+        unfolded = stormpy.pomdp.unfold_memory(model, memory)
+        direct = stormpy.pomdp.unfold_memory(model, memory, direct=True)
+        assert direct.nr_states == unfolded.nr_states
+        assert direct.nr_choices == unfolded.nr_choices
+        assert direct.nr_transitions == unfolded.nr_transitions
+        assert direct.nr_observations == unfolded.nr_observations
+        assert len(direct.initial_states) == 1
+        assert math.isclose(initial_value(direct, formulas[0]), initial_value(unfolded, formulas[0]), rel_tol=1e-6)
+
+    def test_direct_unfolding_memory_labels(self):
+        model, _ = build_maze()
+        memory = stormpy.pomdp.PomdpMemoryBuilder().build(stormpy.pomdp.PomdpMemoryPattern.full, 2)
+        direct = stormpy.pomdp.unfold_memory(model, memory, add_memory_labels=True, direct=True)
+        labeling = direct.labeling
+        memory_states = [labeling.get_states("memstate_{}".format(node)) for node in range(2)]
+        assert memory_states[0].number_of_set_bits() + memory_states[1].number_of_set_bits() == direct.nr_states
+        assert direct.initial_states[0] in [state for state in memory_states[0]]
+
+    @numpy_avail
+    def test_induced_dtmc(self):
+        import numpy as np
+        model, formulas = build_maze()
+        memory = stormpy.pomdp.PomdpMemoryBuilder().build(stormpy.pomdp.PomdpMemoryPattern.full, 2)
+        product = stormpy.pomdp.memory_product(model, memory)
+        assert product.nr_memory_states == 2
+        assert product.nr_observations == model.nr_observations
+
+        # Choose uniformly among the available choices and memory nodes
+        policy = np.zeros((product.nr_observations, product.nr_memory_states, product.max_nr_choices, product.nr_memory_states))
+        for state in range(model.nr_states):
+            nr_choices = model.get_nr_available_actions(state)
+            policy[model.get_observation(state), :, :nr_choices, :] = 1.0 / (nr_choices * product.nr_memory_states)
+        dtmc, product_states = product.induced_dtmc(policy)
+        assert dtmc.nr_states == product_states.shape[0]
+        assert product_states.shape[1] == 2
+        assert dtmc.initial_states == [0]
+        assert list(product_states[0]) == [model.initial_states[0], 0]
+        assert dtmc.nr_states <= model.nr_states * product.nr_memory_states
+
+        value = initial_value(dtmc, stormpy.parse_properties("P=? [ !\"bad\" U \"goal\" ]")[0].raw_formula)
+        upper = initial_value(model, formulas[0])
+        lower = initial_value(model, formulas[1])
+        assert lower - 1e-6 <= value <= upper + 1e-6
+
+    @numpy_avail
+    def test_induced_dtmc_invalid_policy(self):
+        import numpy as np
+        model, _ = build_maze()
+        memory = stormpy.pomdp.PomdpMemoryBuilder().build(stormpy.pomdp.PomdpMemoryPattern.trivial, 1)
+        product = stormpy.pomdp.memory_product(model, memory)
+        with pytest.raises(RuntimeError):
+            product.induced_dtmc(np.zeros((1, 1, 1, 1)))
+        with pytest.raises(RuntimeError):
+            product.induced_dtmc(np.zeros((product.nr_observations, 1, product.max_nr_choices, 1)))
@@ -11,3 +11,38 @@ class TestJani:
         assert information.nr_automata == 5
         assert information.nr_edges == 31
         assert information.nr_variables == 18
+
+    def _instantiated_brp(self):
+        jani_model, properties = stormpy.parse_jani_model(get_example_path("dtmc", "brp.jani"))
+        description = stormpy.SymbolicModelDescription(jani_model)
+        constant_definitions = description.parse_constant_definitions("N=16, MAX=2")
+        return description.instantiate_constants(constant_definitions).as_jani_model()
+
+    def test_flatten_composition(self):
+        jani_model = self._instantiated_brp()
+        flattened, stats = stormpy.flatten_jani_composition(jani_model, nr_threads=2)
+        assert len(flattened.automata) == 1
+        assert stats.nr_automata == 5
+        assert stats.nr_edges == 31
+        assert stats.nr_pruned_edges == 0
+        assert stats.nr_synchronization_vectors == 8
+        assert stats.nr_combinations_before == 26
+        assert stats.nr_combinations_after == 26
+        assert stats.nr_flattened_edges == len(flattened.automata[0].edges)
+        model = stormpy.build_model(flattened)
+        assert model.nr_states == 677
+        assert model.nr_transitions == 867
+
+    def test_prune_edges(self):
+        jani_model = self._instantiated_brp()
+        # Without the edge of the checker, the sender can never start a new file
+        checker = jani_model.automata[jani_model.get_automaton_index("checker")]
+        checker.edges[0].template_edge.guard = jani_model.expression_manager.create_boolean(False)
+        pruned, stats = stormpy.prune_jani_edges(jani_model)
+        assert stats.composition_supported
+        assert stats.nr_edges == 31
+        assert stats.nr_pruned_edges == 2
+        assert stats.nr_disabled_synchronization_vectors == 1
+        assert stats.nr_unreachable_locations == 0
+        assert sum(len(automaton.edges) for automaton in pruned.automata) == 29
+        assert stormpy.build_model(pruned).nr_states == stormpy.build_model(jani_model).nr_states
@@ -1,5 +1,6 @@
 import stormpy
 from helpers.helper import get_example_path
+from configurations import numpy_avail
 
 
 class TestStateLabeling:
@@ -19,6 +20,18 @@ class TestStateLabeling:
         labeling.set_states("tmp", states)
         assert labeling.has_state_label("tmp", 3)
 
+    @numpy_avail
+    def test_set_labeling_from_arrays(self):
+        import numpy as np
+        labeling = stormpy.StateLabeling(5)
+        labeling.add_label("init")
+        labeling.set_states_from_arrays({"init": np.array([0]), "even": np.arange(5) % 2 == 0})
+        assert labeling.get_labels() == {"init", "even"}
+        assert labeling.get_states("init") == stormpy.BitVector(5, [0])
+        assert labeling.get_states("even") == stormpy.BitVector(5, [0, 2, 4])
+        labeling.set_states_from_arrays({"init": np.zeros(5, dtype=bool)})
+        assert labeling.get_states("init").number_of_set_bits() == 0
+
     def test_label(self):
         program = stormpy.parse_prism_program(get_example_path("dtmc", "die.pm"))
         formulas = stormpy.parse_properties_for_prism_program("P=? [ F \"one\" ]", program)
@@ -62,3 +75,11 @@ class TestChoiceLabeling:
         assert "aA" in clabels
         assert "NewFile" in clabeling.get_labels_of_choice(0)
         assert "aG" in clabeling.get_labels_of_choice(7)
+
+    @numpy_avail
+    def test_set_labeling_from_arrays(self):
+        import numpy as np
+        labeling = stormpy.ChoiceLabeling(4)
+        labeling.set_choices_from_arrays({"a": np.array([1, 3], dtype=np.uint32), "b": np.array([True, False, False, False])})
+        assert labeling.get_choices("a") == stormpy.BitVector(4, [1, 3])
+        assert labeling.get_labels_of_choice(0) == {"b"}
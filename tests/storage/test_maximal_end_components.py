@@ -1,5 +1,6 @@
 import stormpy
 from helpers.helper import get_example_path
+from configurations import numpy_avail
 
 
 class TestMaximalEndComponents:
@@ -51,3 +52,90 @@ class TestMaximalEndComponents:
                         for transition in action.transitions:
                             assert transition.value() == 1
                             assert 1 <= transition.column <= 13
+
+    def test_parallel_decomposition(self):
+        program = stormpy.parse_prism_program(get_example_path("mdp", "maze_2.nm"))
+        model = stormpy.build_model(program)
+        expected = {frozenset(state for state, _ in mec): {state: set(choices) for state, choices in mec} for mec in stormpy.get_maximal_end_components(model)}
+        for nr_threads in [1, 2, 4]:
+            decomposition = stormpy.get_maximal_end_components(model, nr_threads=nr_threads)
+            assert decomposition.size == 2
+            for mec in decomposition:
+                choices = {state: set(choices) for state, choices in mec}
+                assert expected[frozenset(choices.keys())] == choices
+
+    def test_parallel_decomposition_subsystem(self):
+        program = stormpy.parse_prism_program(get_example_path("mdp", "two_dice.nm"))
+        model = stormpy.build_model(program)
+        states = stormpy.BitVector(model.nr_states, True)
+        states.set(133, False)
+        choices = stormpy.BitVector(model.nr_choices, True)
+        decomposition = stormpy.ParallelMaximalEndComponentDecomposition_double(model.transition_matrix, states, choices, 2)
+        assert decomposition.size == 35
+        states_in_mecs = [state for mec in decomposition for state, _ in mec]
+        assert states_in_mecs == list(range(134, 169))
+
+    @numpy_avail
+    def test_parallel_decomposition_numpy(self):
+        import numpy as np
+        program = stormpy.parse_prism_program(get_example_path("mdp", "two_dice.nm"))
+        model = stormpy.build_model(program)
+        decomposition = stormpy.ParallelMaximalEndComponentDecomposition_double(model, nr_threads=2)
+        state_to_mec = decomposition.state_to_mec(model.nr_states)
+        choice_to_mec = decomposition.choice_to_mec(model.nr_choices)
+        assert state_to_mec.shape == (model.nr_states,)
+        assert choice_to_mec.shape == (model.nr_choices,)
+        assert np.all(state_to_mec[:133] == -1)
+        assert list(state_to_mec[133:169]) == list(range(36))
+        assert np.count_nonzero(choice_to_mec >= 0) == 72
+        matrix = model.transition_matrix
+        for state in range(133, 169):
+            start = matrix.get_row_group_start(state)
+            end = matrix.get_row_group_end(state)
+            assert all(choice_to_mec[start:end] == state_to_mec[state])
+
+    @numpy_avail
+    def test_decomposition_arrays(self):
+        import numpy as np
+        program = stormpy.parse_prism_program(get_example_path("mdp", "maze_2.nm"))
+        model = stormpy.build_model(program)
+        decomposition = stormpy.get_maximal_end_components(model)
+
+        offsets, states = decomposition.state_arrays()
+        choice_offsets, choices = decomposition.choice_arrays()
+        assert len(offsets) == len(choice_offsets) == decomposition.size + 1
+        for index, mec in enumerate(decomposition):
+            assert list(states[offsets[index]:offsets[index + 1]]) == [state for state, _ in mec]
+            assert list(choices[choice_offsets[index]:choice_offsets[index + 1]]) == [choice for _, state_choices in mec for choice in state_choices]
+
+        state_to_mec = decomposition.state_to_mec(model.nr_states)
+        assert state_to_mec.shape == (model.nr_states,)
+        assert np.count_nonzero(state_to_mec >= 0) == 14
+        for index in range(decomposition.size):
+            assert np.all(state_to_mec[states[offsets[index]:offsets[index + 1]]] == index)
+
+        choice_mask = decomposition.choice_mask(model.nr_choices)
+        assert choice_mask.dtype == bool
+        assert np.count_nonzero(choice_mask) == len(choices) == 1 + 12 * 4 + 3
+        assert choice_mask[53]
+
+    @numpy_avail
+    def test_sequential_and_parallel_arrays(self):
+        import numpy as np
+        program = stormpy.parse_prism_program(get_example_path("mdp", "maze_2.nm"))
+        model = stormpy.build_model(program)
+        sequential = stormpy.get_maximal_end_components(model)
+        parallel = stormpy.get_maximal_end_components(model, nr_threads=2)
+        for decomposition in [sequential, parallel]:
+            state_to_mec = decomposition.state_to_mec(model.nr_states)
+            choice_to_mec = decomposition.choice_to_mec(model.nr_choices)
+            assert np.count_nonzero(state_to_mec >= 0) == 14
+            assert np.array_equal(choice_to_mec >= 0, decomposition.choice_mask(model.nr_choices))
+            assert choice_to_mec[53] == state_to_mec[14]
+        # The MEC indices may differ, but both partition the states in the same way
+        sequential_states = sequential.state_to_mec(model.nr_states)
+        parallel_states = parallel.state_to_mec(model.nr_states)
+        pairs = set(zip(sequential_states, parallel_states))
+        assert len(pairs) == len(set(sequential_states)) == len(set(parallel_states))
+        # Asking for more states than the model has pads with -1
+        assert np.all(parallel.state_to_mec(model.nr_states + 2)[-2:] == -1)
@@ -1,6 +1,9 @@
+import math
+import os
 import stormpy
 from helpers.helper import get_example_path
 import pytest
+from configurations import numpy_avail
 
 
 class TestSparseModel:
@@ -55,6 +58,37 @@ class TestSparseModel:
             assert reward == 1.0 or reward == 0.0
         assert not model.reward_models["coin_flips"].has_transition_rewards
 
+    @numpy_avail
+    def test_reward_model_numpy_view(self):
+        import numpy as np
+        program = stormpy.parse_prism_program(get_example_path("dtmc", "die.pm"))
+        properties = stormpy.parse_properties_for_prism_program("R=? [F \"done\"]", program, None)
+        model = stormpy.build_model(program, properties)
+        rewards = model.get_reward_model("coin_flips")
+        view = rewards.state_action_rewards_array
+        assert view.dtype == np.float64
+        assert list(view) == rewards.state_action_rewards
+        result = stormpy.model_checking(model, properties[0])
+        assert result.at(model.initial_states[0]) == pytest.approx(11 / 3)
+        # Writing to the view changes the reward model without copying
+        view *= 2
+        assert model.get_reward_model("coin_flips").get_state_action_reward(0) == 2
+        result = stormpy.model_checking(model, properties[0])
+        assert result.at(model.initial_states[0]) == pytest.approx(22 / 3)
+        with pytest.raises(RuntimeError):
+            rewards.state_rewards_array
+
+    @numpy_avail
+    def test_reward_model_from_numpy(self):
+        import numpy as np
+        rewards = stormpy.SparseRewardModel(state_rewards=np.arange(3, dtype=np.float64), state_action_rewards=np.ones(4))
+        assert rewards.has_state_rewards
+        assert rewards.state_rewards == [0.0, 1.0, 2.0]
+        assert rewards.state_action_rewards == [1.0] * 4
+        assert not rewards.has_transition_rewards
+        rewards.state_rewards_array[1] = 5
+        assert rewards.get_state_reward(1) == 5
+
     def test_build_dtmc_from_jani_model(self):
         jani_model, properties = stormpy.parse_jani_model(get_example_path("dtmc", "die.jani"))
         model = stormpy.build_model(jani_model)
@@ -255,6 +289,45 @@ class TestSymbolicSylvanModel:
         assert not model.supports_parameters
         assert type(model) is stormpy.SymbolicSylvanCtmc
 
+    def test_export_load_dtmc(self, tmpdir):
+        program = stormpy.parse_prism_program(get_example_path("dtmc", "die.pm"))
+        properties = stormpy.parse_properties_for_prism_program("R=? [F \"done\"]; P=? [F \"two\"]", program, None)
+        model = stormpy.build_symbolic_model(program, properties)
+        export_file = os.path.join(str(tmpdir), "die.dd")
+        stormpy.export_symbolic_model(model, export_file)
+        loaded = stormpy.load_symbolic_model(export_file)
+        assert type(loaded) is stormpy.SymbolicSylvanDtmc
+        assert loaded.nr_states == 13
+        assert loaded.nr_transitions == 20
+        assert loaded.reachable_states.node_count == model.reachable_states.node_count
+        assert len(loaded.reward_models) == 1
+        assert loaded.reward_models["coin_flips"].has_state_action_rewards
+        for prop, expected in zip(properties, [11 / 3, 1 / 6]):
+            result = stormpy.check_model_dd(loaded, prop)
+            result.filter(stormpy.create_filter_initial_states_symbolic(loaded))
+            assert math.isclose(result.min, expected, rel_tol=1e-6)
+
+    def test_export_load_mdp(self, tmpdir):
+        program = stormpy.parse_prism_program(get_example_path("mdp", "two_dice.nm"))
+        formulas = stormpy.parse_properties_for_prism_program("Pmin=? [ F \"two\" ]", program)
+        model = stormpy.build_symbolic_model(program, formulas)
+        export_file = os.path.join(str(tmpdir), "two_dice.dd")
+        stormpy.export_symbolic_model(model, export_file)
+        loaded = stormpy.load_symbolic_model(export_file)
+        assert type(loaded) is stormpy.SymbolicSylvanMdp
+        assert loaded.nr_states == 169
+        assert loaded.nr_transitions == 435
+        result = stormpy.check_model_dd(loaded, formulas[0])
+        result.filter(stormpy.create_filter_initial_states_symbolic(loaded))
+        assert math.isclose(result.min, 1 / 36, rel_tol=1e-6)
+
+    def test_load_invalid_file(self, tmpdir):
+        invalid_file = os.path.join(str(tmpdir), "invalid.dd")
+        with open(invalid_file, "w") as f:
+            f.write("no dd")
+        with pytest.raises(RuntimeError):
+            stormpy.load_symbolic_model(invalid_file)
+
     def test_build_ma(self):
         program = stormpy.parse_prism_program(get_example_path("ma", "simple.ma"))
         formulas = stormpy.parse_properties_for_prism_program("P=? [ F<=2 s=2 ]", program)
@@ -1,6 +1,6 @@
 import stormpy
-from stormpy.examples.files import prism_dtmc_die
-import pytest
+from stormpy.examples.files import prism_dtmc_die, prism_mdp_coin_2_2
+from configurations import numpy_avail
 
 class _DfsQueue:
     def __init__(self):
@@ -52,11 +52,10 @@ def _load_program(filename):
 
 def _find_variable(program, name):
     for var in program.variables:
-        if var.name is name:
+        if var.name == name:
             return var
     return None
 
-@pytest.mark.skipif(True, reason="State generation is broken")
 def test_knuth_yao_die():
     program, expression_parser = _load_program(prism_dtmc_die)
     s_variable = _find_variable(program, "s")
@@ -74,3 +73,52 @@ def test_knuth_yao_die():
 
     _dfs_explore(program, callback)
     assert number_states == 13
+
+
+def _bfs_explore_frontier(program):
+    import numpy as np
+    generator = stormpy.StateGenerator(program)
+    frontier = np.array(generator.initial_states(), dtype=np.uint32)
+    nr_choices = 0
+    nr_transitions = 0
+    while len(frontier) > 0:
+        nr_states = generator.nr_states
+        expansion = generator.expand_frontier(frontier)
+        assert len(expansion["state_offsets"]) == len(frontier) + 1
+        assert len(expansion["choice_offsets"]) == expansion["state_offsets"][-1] + 1
+        assert len(expansion["origin_offsets"]) == len(expansion["choice_offsets"])
+        assert len(expansion["successors"]) == len(expansion["probabilities"])
+        nr_choices += expansion["state_offsets"][-1]
+        nr_transitions += len(expansion["successors"])
+        # New states get consecutive ids
+        frontier = np.arange(nr_states, generator.nr_states, dtype=np.uint32)
+    return generator, nr_choices, nr_transitions
+
+
+@numpy_avail
+def test_expand_frontier_dtmc():
+    import numpy as np
+    program, expression_parser = _load_program(prism_dtmc_die)
+    generator, nr_choices, nr_transitions = _bfs_explore_frontier(program)
+    assert generator.nr_states == 13
+    assert nr_choices == 13
+    assert nr_transitions == 20
+
+    expansion = generator.expand_frontier(np.array([0], dtype=np.uint32))
+    assert list(expansion["successors"]) == [1, 2]
+    assert list(expansion["probabilities"]) == [0.5, 0.5]
+    assert list(expansion["origin_offsets"]) == [0, 1]
+
+    satisfied = generator.satisfies_states(expression_parser.parse("s=7"), np.arange(13, dtype=np.uint32))
+    assert satisfied.dtype == bool
+    assert satisfied.sum() == 6
+
+
+@numpy_avail
+def test_expand_frontier_mdp():
+    program, _ = _load_program(prism_mdp_coin_2_2)
+    model = stormpy.build_model(program)
+    generator, nr_choices, _ = _bfs_explore_frontier(program)
+    assert generator.nr_states == model.nr_states
+    # Deadlocks are not fixed by the generator
+    assert nr_choices <= model.nr_choices
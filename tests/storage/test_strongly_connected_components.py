@@ -0,0 +1,51 @@
+import stormpy
+from helpers.helper import get_example_path
+from configurations import numpy_avail
+
+
+class TestStronglyConnectedComponents:
+    def test_create_decomposition(self):
+        program = stormpy.parse_prism_program(get_example_path("dtmc", "die.pm"))
+        model = stormpy.build_model(program)
+        assert model.nr_states == 13
+
+        decomposition = stormpy.get_strongly_connected_components(model)
+        assert decomposition.size == 11
+        assert sorted(scc.size for scc in decomposition) == [1] * 9 + [2] * 2
+        assert sorted(state for scc in decomposition for state in scc) == list(range(13))
+
+        bottom = stormpy.get_strongly_connected_components(model, only_bottom_sccs=True)
+        assert bottom.size == 6
+        for scc in bottom:
+            assert scc.size == 1
+            assert not scc.is_trivial
+
+        non_naive = stormpy.get_strongly_connected_components(model, drop_naive_sccs=True)
+        assert non_naive.size == 8
+
+    def test_create_decomposition_subsystem(self):
+        program = stormpy.parse_prism_program(get_example_path("dtmc", "die.pm"))
+        model = stormpy.build_model(program)
+        subsystem = stormpy.BitVector(model.nr_states, True)
+        subsystem.set(0, False)
+        decomposition = stormpy.StronglyConnectedComponentDecomposition_double(model.transition_matrix, subsystem)
+        assert decomposition.size == 10
+        assert 0 not in [state for scc in decomposition for state in scc]
+
+    @numpy_avail
+    def test_topological_arrays(self):
+        import numpy as np
+        program = stormpy.parse_prism_program(get_example_path("dtmc", "die.pm"))
+        model = stormpy.build_model(program)
+        decomposition = stormpy.get_strongly_connected_components(model, topological_sort=True)
+        offsets, states = decomposition.state_arrays()
+        assert len(offsets) == decomposition.size + 1
+        assert offsets[0] == 0 and offsets[-1] == model.nr_states
+        for index, scc in enumerate(decomposition):
+            assert list(states[offsets[index]:offsets[index + 1]]) == sorted(scc)
+
+        state_to_scc = decomposition.state_to_scc(model.nr_states)
+        assert np.all(state_to_scc >= 0)
+        for state in range(model.nr_states):
+            for entry in model.transition_matrix.get_row(state):
+                assert state_to_scc[entry.column] <= state_to_scc[state]
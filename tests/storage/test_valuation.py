@@ -0,0 +1,75 @@
+import stormpy
+from helpers.helper import get_example_path
+from configurations import numpy_avail
+
+
+def _build_die():
+    program = stormpy.parse_prism_program(get_example_path("dtmc", "die.pm"))
+    options = stormpy.BuilderOptions()
+    options.set_build_state_valuations()
+    return program, stormpy.build_sparse_model_with_options(program, options)
+
+
+class TestStateValuations:
+    @numpy_avail
+    def test_to_numpy(self):
+        program, model = _build_die()
+        valuations = model.state_valuations
+        s_var = program.modules[0].get_integer_variable("s").expression_variable
+        d_var = program.modules[0].get_integer_variable("d").expression_variable
+        assert [v.name for v in valuations.variables] == ["s", "d"]
+        columns = valuations.to_numpy()
+        assert list(columns.keys()) == ["s", "d"]
+        assert columns["s"].dtype.kind == "i"
+        assert len(columns["s"]) == model.nr_states
+        for state in range(model.nr_states):
+            assert columns["s"][state] == valuations.get_integer_value(state, s_var)
+            assert columns["d"][state] == valuations.get_integer_value(state, d_var)
+        columns = valuations.to_numpy([d_var])
+        assert list(columns.keys()) == ["d"]
+
+    @numpy_avail
+    def test_index(self):
+        import numpy as np
+        program, model = _build_die()
+        valuations = model.state_valuations
+        index = valuations.build_index()
+        assert len(index) == model.nr_states
+        for state in range(model.nr_states):
+            s = valuations.get_integer_value(state, index.variables[0])
+            d = valuations.get_integer_value(state, index.variables[1])
+            assert index.get_state([s, d]) == state
+        assert index.get_state([7, 0]) is None
+        columns = valuations.to_numpy()
+        states = index.get_states(np.stack([columns["s"], columns["d"]], axis=1))
+        assert list(states) == list(range(model.nr_states))
+        assert list(index.get_states(np.array([[7, 0], [0, 0]]))) == [-1, model.initial_states[0]]
+
+    @numpy_avail
+    def test_from_numpy(self):
+        import numpy as np
+        manager = stormpy.ExpressionManager()
+        x = manager.create_integer_variable("x")
+        b = manager.create_boolean_variable("b")
+        valuations = stormpy.StateValuation.from_numpy([x, b], {"x": np.arange(4), "b": np.array([True, False, True, False])})
+        assert valuations.get_nr_of_states() == 4
+        assert valuations.get_integer_value(3, x) == 3
+        assert valuations.get_boolean_value(2, b)
+        assert not valuations.get_boolean_value(1, b)
+
+        program, model = _build_die()
+        original = model.state_valuations
+        copy = stormpy.StateValuation.from_numpy(original.variables, original.to_numpy())
+        assert copy.get_nr_of_states() == model.nr_states
+        for state in range(model.nr_states):
+            assert copy.get_string(state) == original.get_string(state)
+
+    def test_index_subset(self):
+        program, model = _build_die()
+        valuations = model.state_valuations
+        s_var = program.modules[0].get_integer_variable("s").expression_variable
+        index = valuations.build_index([s_var])
+        # States with s=7 share the same key
+        assert len(index) == 8
+        state = index.get_state([7])
+        assert valuations.get_integer_value(state, s_var) == 7